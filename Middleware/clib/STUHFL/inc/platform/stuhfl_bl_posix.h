@@ -24,6 +24,7 @@
 #define __STUHFL_BL_ARM_H
 
 #include "stuhfl.h"
+#include "stuhfl_pl.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -38,7 +39,9 @@ STUHFL_T_RET_CODE STUHFL_F_Reset_Posix(STUHFL_T_DEVICE_CTX *device, STUHFL_T_RES
 STUHFL_T_RET_CODE STUHFL_F_Disconnect_Posix(STUHFL_T_DEVICE_CTX *device);
 
 STUHFL_T_RET_CODE STUHFL_F_SndRaw_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t dataLen);
+STUHFL_T_RET_CODE STUHFL_F_SndRawV_Posix(STUHFL_T_DEVICE_CTX *device, const STUHFL_T_IoVec *iov, uint8_t iovCnt);
 STUHFL_T_RET_CODE STUHFL_F_RcvRaw_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t *dataLen);
+STUHFL_T_RET_CODE STUHFL_F_RcvRawAvailable_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t *dataLen);
 
 STUHFL_T_RET_CODE STUHFL_F_SetDTR_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t dtrValue);
 STUHFL_T_RET_CODE STUHFL_F_GetDTR_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *dtrValue);
@@ -49,6 +52,9 @@ STUHFL_T_RET_CODE STUHFL_F_GetRTS_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *rt
 STUHFL_T_RET_CODE STUHFL_F_SetTimeouts_Posix(STUHFL_T_DEVICE_CTX *device, uint32_t rdTimeout, uint32_t wrTimeout);
 STUHFL_T_RET_CODE STUHFL_F_GetTimeouts_Posix(STUHFL_T_DEVICE_CTX *device, uint32_t *rdTimeout, uint32_t *wrTimeout);
 
+STUHFL_T_RET_CODE STUHFL_F_SetTxQueue_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t enable);
+STUHFL_T_RET_CODE STUHFL_F_GetTxQueue_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *enable);
+
 #endif
 
 #ifdef __cplusplus
@@ -24,6 +24,7 @@
 #define __STUHFL_PLATFORM_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -44,6 +45,7 @@ extern "C"
 #define STUHFL_DLL_API          __attribute__((visibility("hidden")))
 #endif
 #define STUHFL_DEPRECATED       __attribute__((deprecated))
+#define STUHFL_THREAD_LOCAL     __thread
 // --------------------------------------------------------------------------
 #elif defined(_MSC_VER)
 // --------------------------------------------------------------------------
@@ -58,12 +60,14 @@ extern "C"
 #define STUHFL_DLL_API          __declspec(dllimport)
 #endif
 #define STUHFL_DEPRECATED       __declspec(deprecated)
+#define STUHFL_THREAD_LOCAL     __declspec(thread)
 // --------------------------------------------------------------------------
 #else
 // --------------------------------------------------------------------------
 #define CALL_CONV
 #define STUHFL_DLL_API
 #define STUHFL_DEPRECATED
+#define STUHFL_THREAD_LOCAL
 // --------------------------------------------------------------------------
 #endif
 // --------------------------------------------------------------------------
@@ -81,11 +85,20 @@ extern "C"
 #include <windows.h>
 
 STUHFL_DLL_API void CALL_CONV usleep(__int64 usec);
+
+typedef SRWLOCK                     STUHFL_T_Mutex;
+#define STUHFL_D_MUTEX_INIT         SRWLOCK_INIT
+#define STUHFL_MUTEX_LOCK(m)        AcquireSRWLockExclusive(m)
+#define STUHFL_MUTEX_UNLOCK(m)      ReleaseSRWLockExclusive(m)
+typedef CONDITION_VARIABLE          STUHFL_T_Cond;
+#define STUHFL_D_COND_INIT          CONDITION_VARIABLE_INIT
+#define STUHFL_COND_BROADCAST(c)    WakeAllConditionVariable(c)
 // --------------------------------------------------------------------------
 #elif defined(POSIX)
 // --------------------------------------------------------------------------
 #include <pthread.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 #include <stdarg.h>
 #include <syslog.h>
@@ -97,14 +110,54 @@ STUHFL_DLL_API void CALL_CONV usleep(__int64 usec);
 #define FALSE                       0
 #define INVALID_HANDLE_VALUE        ((unsigned)(-1))
 #define HANDLE                      int
+
+typedef pthread_mutex_t             STUHFL_T_Mutex;
+#define STUHFL_D_MUTEX_INIT         PTHREAD_MUTEX_INITIALIZER
+#define STUHFL_MUTEX_LOCK(m)        pthread_mutex_lock(m)
+#define STUHFL_MUTEX_UNLOCK(m)      pthread_mutex_unlock(m)
+typedef pthread_cond_t              STUHFL_T_Cond;
+#define STUHFL_D_COND_INIT          PTHREAD_COND_INITIALIZER
+#define STUHFL_COND_BROADCAST(c)    pthread_cond_broadcast(c)
 // --------------------------------------------------------------------------
 #else
 // --------------------------------------------------------------------------
 #endif
 
+// --------------------------------------------------------------------------
+// 32bit atomics used to hand data over between the runner thread and application threads
+#if defined(__GNUC__) || defined(__clang__)
+#define STUHFL_ATOMIC_LOAD(p)               __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STUHFL_ATOMIC_STORE(p, v)           __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define STUHFL_ATOMIC_CAS(p, expected, v)   __sync_bool_compare_and_swap((p), (expected), (v))
+#elif defined(_MSC_VER)
+#define STUHFL_ATOMIC_LOAD(p)               ((uint32_t)InterlockedCompareExchange((volatile LONG *)(p), 0, 0))
+#define STUHFL_ATOMIC_STORE(p, v)           ((void)InterlockedExchange((volatile LONG *)(p), (LONG)(v)))
+#define STUHFL_ATOMIC_CAS(p, expected, v)   (InterlockedCompareExchange((volatile LONG *)(p), (LONG)(v), (LONG)(expected)) == (LONG)(expected))
+#endif
+
 //
 STUHFL_DLL_API uint32_t CALL_CONV getMilliCount(void);
 STUHFL_DLL_API uint32_t CALL_CONV getMilliSpan(uint32_t firstTime);
+STUHFL_DLL_API uint32_t CALL_CONV getMicroCount(void);
+STUHFL_DLL_API uint32_t CALL_CONV getMicroSpan(uint32_t firstTime);
+
+#if defined(WIN32) || defined(WIN64) || defined(POSIX)
+/**
+ * Initialize a condition variable for STUHFL_F_CondWait, on POSIX it waits against the monotonic clock
+ * @param *cond: condition variable to initialize
+*/
+void STUHFL_F_CondInit(STUHFL_T_Cond *cond);
+
+/**
+ * Wait on a condition variable, initialized with STUHFL_F_CondInit, mutex must be locked by the caller
+ * @param *cond: condition variable to wait on
+ * @param *mutex: locked mutex, released while waiting
+ * @param timeout: max time to wait in ms
+ *
+ * @return false when timed out
+*/
+bool STUHFL_F_CondWait(STUHFL_T_Cond *cond, STUHFL_T_Mutex *mutex, uint32_t timeout);
+#endif
 
 
 
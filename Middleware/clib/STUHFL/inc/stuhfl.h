@@ -65,6 +65,7 @@ typedef uint32_t                                STUHFL_T_RET_CODE;
 typedef uint32_t                                STUHFL_T_RESET;
 typedef uint32_t                                STUHFL_T_VERSION;
 typedef void*                                   STUHFL_T_DEVICE_CTX;
+typedef void*                                   STUHFL_T_READER_CTX;
 typedef void*                                   STUHFL_T_PARAM_VALUE;
 typedef void*                                   STUHFL_T_PARAM_INFO;
 typedef uint32_t                                STUHFL_T_PARAM;
@@ -93,6 +94,10 @@ typedef uint16_t                                STUHFL_T_LEN16;
 #define STUHFL_PARAM_KEY_WR_TIMEOUT_MS          0x00000004
 #define STUHFL_PARAM_KEY_DTR                    0x00000005
 #define STUHFL_PARAM_KEY_RTS                    0x00000006
+#define STUHFL_PARAM_KEY_TX_QUEUE               0x00000007          /* POSIX only */
+#define STUHFL_PARAM_KEY_RX_RESYNC_CNT          0x00000008          /* # of receive stream resynchronizations */
+#define STUHFL_PARAM_KEY_RX_DROPPED_BYTES       0x00000009          /* # of bytes dropped during resynchronization */
+#define STUHFL_PARAM_KEY_SHADOW_CACHE           0x0000000A          /* serve reader config reads from host side shadow, see STUHFL_F_GetShadowCacheStats */
 
 
 // KEYS ST25RU3993
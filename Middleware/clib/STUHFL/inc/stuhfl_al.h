@@ -24,6 +24,7 @@
 #define __STUHFL_AL_H
 
 #include "stuhfl.h"
+#include "stuhfl_sl.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -47,6 +48,51 @@ typedef STUHFL_T_RET_CODE(*STUHFL_T_ActionCycleOOP)(STUHFL_T_CallerCtx obj, STUH
 typedef STUHFL_T_RET_CODE(*STUHFL_T_ActionFinished)(STUHFL_T_ACTION_CYCLE_DATA data);
 typedef STUHFL_T_RET_CODE(*STUHFL_T_ActionFinishedOOP)(STUHFL_T_CallerCtx obj, STUHFL_T_ACTION_CYCLE_DATA data);
 
+// --------------------------------------------------------------------------
+#define STUHFL_RUNNER_SCHED_DEFAULT         0x00    // scheduling inherited from the starting thread
+#define STUHFL_RUNNER_SCHED_FIFO            0x01    // SCHED_FIFO real time scheduling
+#define STUHFL_RUNNER_SCHED_RR              0x02    // SCHED_RR real time scheduling
+
+#define STUHFL_RUNNER_OPT_AFFINITY          0x01
+#define STUHFL_RUNNER_OPT_SCHED             0x02
+#define STUHFL_RUNNER_OPT_STACK_SIZE        0x04
+
+#pragma pack(push, 1)
+typedef struct {
+    uint64_t                            cpuAffinity;    /**< I Param: Bit per CPU the runner may run on, 0 for no restriction. */
+    uint8_t                             schedPolicy;    /**< I Param: Scheduling policy, STUHFL_RUNNER_SCHED_xyz. */
+    int32_t                             priority;       /**< I Param: Priority for FIFO/RR scheduling. On Windows the value passed to SetThreadPriority, any policy but default applies it. */
+    uint32_t                            stackSize;      /**< I Param: Stack size in bytes, 0 for default. */
+} STUHFL_T_Runner_Thread_Option;
+#define STUHFL_O_RUNNER_THREAD_OPTION_INIT(...) ((STUHFL_T_Runner_Thread_Option) { .cpuAffinity = 0, .schedPolicy = STUHFL_RUNNER_SCHED_DEFAULT, .priority = 0, .stackSize = 0, ##__VA_ARGS__ })
+
+typedef struct {
+    uint8_t                             requested;      /**< O Param: Settings requested for the last started runner, STUHFL_RUNNER_OPT_xyz bits. */
+    uint8_t                             applied;        /**< O Param: Settings that took effect, STUHFL_RUNNER_OPT_xyz bits. */
+    int32_t                             affinityErr;    /**< O Param: OS error of the CPU affinity setting, 0 when applied or not requested. */
+    int32_t                             schedErr;       /**< O Param: OS error of the scheduling setting, e.g. EPERM without real time privileges. */
+    int32_t                             stackSizeErr;   /**< O Param: OS error of the stack size setting. */
+} STUHFL_T_Runner_Thread_Status;
+#define STUHFL_O_RUNNER_THREAD_STATUS_INIT(...) ((STUHFL_T_Runner_Thread_Status) { .requested = 0, .applied = 0, .affinityErr = 0, .schedErr = 0, .stackSizeErr = 0, ##__VA_ARGS__ })
+#pragma pack(pop)
+
+/**
+ * Set the thread options of the runner. The options are applied whenever a runner thread is created,
+ * a setting that fails does not prevent the runner from starting. Must be set before the runner is started.
+ * @param *option: thread options, NULL restores the defaults
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetRunnerThreadOption(const STUHFL_T_Runner_Thread_Option *option);
+
+/**
+ * Get which thread options took effect for the last started runner
+ * @param *status: replied status
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetRunnerThreadStatus(STUHFL_T_Runner_Thread_Status *status);
+
 /**
  * Perform application layer start command
  * @param action: which action to be started
@@ -56,7 +102,7 @@ typedef STUHFL_T_RET_CODE(*STUHFL_T_ActionFinishedOOP)(STUHFL_T_CallerCtx obj, S
  * @param finishedCallback: function pointer for callback function that is called when action is finished
  * @param *id: OUT param with ID of started action
  *
- * @return error code
+ * @return error code, ERR_PARAM when tag views, streaming callbacks or a tag batch are set for another action than STUHFL_ACTION_INVENTORY
 */
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Start(
     STUHFL_T_ACTION action,
@@ -76,7 +122,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Start(
  * @param finishedCallback: function pointer for callback function that is called when action is finished
  * @param *id: OUT param with ID of started action
  *
- * @return error code
+ * @return error code, ERR_PARAM when tag views, streaming callbacks or a tag batch are set for another action than STUHFL_ACTION_INVENTORY
 */
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Start_OOP(
     STUHFL_T_ACTION action,
@@ -88,12 +134,100 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Start_OOP(
     STUHFL_T_ACTION_ID *id);
 
 /**
- * Perform application layer stop command to stop running action
+ * Perform application layer stop command to stop running action.
+ * Each reader context runs its own action, the action is found by its ID and may be stopped from any thread.
+ * The runner thread sends the STOP, drops the inventory frames still in flight until the STOP is answered,
+ * calls the finished callback once and terminates. STUHFL_F_Stop returns when the runner has terminated,
+ * when called from the cycle callback it returns at once and the runner stops after the callback.
  * @param id: action to be stoped
- * @return error code
+ * @return error code, ERR_TIMEOUT when the runner did not terminate within twice the read timeout plus 1s
 */
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Stop(STUHFL_T_ACTION_ID id);
 
+/**
+ * Set callback that receives the tags found by the STUHFL_ACTION_INVENTORY runner as views into the
+ * receive buffer instead of copies in the tagList of the cycle data. While set, tagListSize stays 0,
+ * statistics and the cycle callback are still updated per received frame. Must be set before the runner is started.
+ * @param tagCallback: function called for every found tag, NULL restores the tagList
+ * @param *userCtx: pointer passed back to tagCallback
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetInventoryTagViewCallback(STUHFL_T_InventoryTagView tagCallback, void *userCtx);
+
+/**
+ * Set the streaming callbacks of the STUHFL_ACTION_INVENTORY runner. onTag is called as soon as a tag
+ * is decoded, onStatistics as soon as the statistics are decoded, both from the runner thread.
+ * In streaming mode the cycle callback is not called and no tagList is needed in the cycle data,
+ * statistics are still kept in the cycle data. Must be set before the runner is started.
+ * @param onTag: function called for every found tag, NULL ends streaming mode and restores the tagList
+ * @param onStatistics: function called for every received statistics
+ * @param *userCtx: pointer passed back to onTag and onStatistics
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetInventoryStreamCallbacks(STUHFL_T_InventoryTagView onTag, STUHFL_T_InventoryStatisticsView onStatistics, void *userCtx);
+
+/**
+ * Set a tag batch the STUHFL_ACTION_INVENTORY runner fills instead of the tagList of the cycle data.
+ * Tags are decoded straight into the columns of the batch, the batch holds the tags of one received frame
+ * when the cycle callback is called and is emptied afterwards. Must be set before the runner is started.
+ * Replaces callbacks set by STUHFL_F_SetInventoryTagViewCallback or STUHFL_F_SetInventoryStreamCallbacks.
+ * Can not be combined with STUHFL_F_SetInventoryQueue.
+ * @param *batch: batch to be filled, NULL restores the tagList
+ *
+ * @return error code, ERR_PARAM when an inventory queue is set
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetInventoryTagBatch(STUHFL_T_Inventory_Tag_Batch *batch);
+
+// --------------------------------------------------------------------------
+#define STUHFL_QUEUE_POLICY_BLOCK           0x00    // runner waits until the application pulled a cycle
+#define STUHFL_QUEUE_POLICY_DROP_OLDEST     0x01    // oldest queued cycle is discarded
+#define STUHFL_QUEUE_POLICY_DROP_NEWEST     0x02    // received cycle is discarded
+
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t                            capacity;       /**< O Param: Number of cycles the queue can hold. */
+    uint32_t                            occupancy;      /**< O Param: Number of cycles currently queued. */
+    uint32_t                            highWater;      /**< O Param: Highest occupancy reached since the queue was set. */
+    uint32_t                            pushed;         /**< O Param: Number of cycles queued by the runner. */
+    uint32_t                            dropped;        /**< O Param: Number of cycles discarded because the queue was full. */
+    uint32_t                            blocked;        /**< O Param: Number of times the runner had to wait for a free entry. */
+} STUHFL_T_Inventory_Queue_Stats;
+#define STUHFL_O_INVENTORY_QUEUE_STATS_INIT(...) ((STUHFL_T_Inventory_Queue_Stats) { .capacity = 0, .occupancy = 0, .highWater = 0, .pushed = 0, .dropped = 0, .blocked = 0, ##__VA_ARGS__ })
+#pragma pack(pop)
+
+/**
+ * Set a queue between the inventory runner and the application. Instead of calling the cycle callback,
+ * the runner copies statistics and tagList of every cycle into the queue and continues reading, the
+ * application pulls the cycles with STUHFL_F_InventoryQueuePop from its own thread. The queue is lock free,
+ * with one runner and one application thread pulling. Must be set before the runner is started.
+ * Can not be combined with STUHFL_F_SetInventoryTagBatch.
+ * @param capacity: number of cycles the queue can hold, must be a power of 2. 0 removes the queue
+ * @param tagCntMax: number of tags kept per cycle, exceeding tags are counted in tagListDropped
+ * @param policy: what the runner does when the queue is full, STUHFL_QUEUE_POLICY_xyz
+ *
+ * @return error code, ERR_PARAM when a tag batch is set
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetInventoryQueue(uint32_t capacity, uint32_t tagCntMax, uint8_t policy);
+
+/**
+ * Pull the oldest queued cycle. Does not wait, the reader context of the runner must be selected.
+ * @param *data: replied statistics and tags. Up to tagListSizeMax tags are copied into tagList,
+ *               the others are counted in tagListDropped
+ *
+ * @return error code, ERR_NOMSG when the queue is empty
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_InventoryQueuePop(STUHFL_T_Inventory_Data *data);
+
+/**
+ * Get occupancy and drop counters of the queue set by STUHFL_F_SetInventoryQueue
+ * @param *stats: replied counters
+ *
+ * @return error code, ERR_REQUEST when no queue is set
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetInventoryQueueStats(STUHFL_T_Inventory_Queue_Stats *stats);
+
 
 
 #ifdef __cplusplus
@@ -0,0 +1,543 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+//
+// Header only C++20 coroutine front-end. Commands are queued with STUHFL_F_ExecuteCmdAsync to the
+// device I/O thread of the reader, the awaiting coroutines are resumed from an EventLoop of the
+// application. Any number of coroutines may have commands in flight, they are executed in queue order.
+//
+// Usage:
+//     stuhfl::EventLoop loop;
+//     stuhfl::Reader reader(loop);
+//
+//     stuhfl::Task<> readTid(stuhfl::Reader &reader) {
+//         stuhfl::ReadResult r = co_await reader.read(GEN2_MEMORY_BANK_TID, 0, 8);
+//         ...
+//         reader.loop().stop();
+//     }
+//     readTid(reader).spawn(loop);
+//     loop.run();
+//
+#if !defined __STUHFL_CORO_HPP
+#define __STUHFL_CORO_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "stuhfl.h"
+#include "stuhfl_err.h"
+#include "stuhfl_al.h"
+#include "stuhfl_sl.h"
+#include "stuhfl_dl.h"
+
+namespace stuhfl
+{
+
+// --------------------------------------------------------------------------
+/**
+ * Single threaded executor. Coroutines may be posted from any thread, e.g. from the device I/O or runner
+ * thread when a command has completed, they are always resumed from the thread calling run().
+*/
+class EventLoop
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Resume a coroutine from run()
+     * @param h: coroutine to be resumed
+    */
+    void post(std::coroutine_handle<> h)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mReady.push_back(h);
+        }
+        mCond.notify_one();
+    }
+
+    /**
+     * Resume a coroutine from run() after a delay
+     * @param ms: delay in ms
+     * @param h: coroutine to be resumed
+    */
+    void postAfter(uint32_t ms, std::coroutine_handle<> h)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mTimers.push(Timer{ Clock::now() + std::chrono::milliseconds(ms), mTimerSeq++, h });
+        }
+        mCond.notify_one();
+    }
+
+    /**
+     * Resume posted coroutines until stop() is called
+    */
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mLock);
+        while (!mStop) {
+            Clock::time_point now = Clock::now();
+            while (!mTimers.empty() && (mTimers.top().due <= now)) {
+                mReady.push_back(mTimers.top().h);
+                mTimers.pop();
+            }
+            if (mReady.empty()) {
+                if (mTimers.empty()) {
+                    mCond.wait(lock);
+                } else {
+                    mCond.wait_until(lock, mTimers.top().due);
+                }
+                continue;
+            }
+            std::coroutine_handle<> h = mReady.front();
+            mReady.pop_front();
+            lock.unlock();
+            h.resume();
+            lock.lock();
+        }
+        mStop = false;
+    }
+
+    /**
+     * Let run() return after the current coroutine has suspended. May be called from any thread.
+    */
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mStop = true;
+        }
+        mCond.notify_all();
+    }
+
+    /**
+     * Awaitable suspending the calling coroutine
+     * @param ms: time to sleep in ms
+    */
+    auto sleep(uint32_t ms)
+    {
+        struct Awaiter {
+            EventLoop                       &loop;
+            uint32_t                        ms;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { loop.postAfter(ms, h); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{ *this, ms };
+    }
+
+private:
+    struct Timer {
+        Clock::time_point                   due;
+        uint64_t                            seq;        // keeps timers with same due time in order
+        std::coroutine_handle<>             h;
+
+        bool operator>(const Timer &other) const { return (due != other.due) ? (due > other.due) : (seq > other.seq); }
+    };
+
+    std::mutex                              mLock;
+    std::condition_variable                 mCond;
+    std::deque<std::coroutine_handle<>>     mReady;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> mTimers;
+    uint64_t                                mTimerSeq = 0;
+    bool                                    mStop = false;
+};
+
+// --------------------------------------------------------------------------
+template<typename T = void> class Task;
+
+namespace detail
+{
+struct PromiseBase {
+    std::coroutine_handle<>                 continuation;
+    bool                                    detached = false;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+        {
+            PromiseBase &promise = h.promise();
+            if (promise.continuation) {
+                return promise.continuation;
+            }
+            if (promise.detached) {
+                h.destroy();
+            }
+            return std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    // errors are reported as return codes, as in the C API
+    void unhandled_exception() noexcept { std::terminate(); }
+};
+
+template<typename T>
+struct Promise : PromiseBase {
+    T                                       value{};
+
+    Task<T> get_return_object() noexcept;
+    void return_value(T v) { value = std::move(v); }
+};
+
+template<>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() noexcept {}
+};
+} // namespace detail
+
+/**
+ * Lazily started coroutine. Runs when awaited by another coroutine or when spawned onto an EventLoop.
+*/
+template<typename T>
+class Task
+{
+public:
+    using promise_type = detail::Promise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> h) noexcept : mHandle(h) {}
+    Task(Task &&other) noexcept : mHandle(std::exchange(other.mHandle, nullptr)) {}
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    Task &operator=(Task &&) = delete;
+    ~Task()
+    {
+        if (mHandle) {
+            mHandle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+    {
+        mHandle.promise().continuation = caller;
+        return mHandle;
+    }
+    T await_resume()
+    {
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(mHandle.promise().value);
+        }
+    }
+
+    /**
+     * Start the task from the loop without awaiting it. The task frees itself when done.
+     * @param loop: loop resuming the task
+    */
+    void spawn(EventLoop &loop) &&
+    {
+        std::coroutine_handle<promise_type> h = std::exchange(mHandle, nullptr);
+        h.promise().detached = true;
+        loop.post(h);
+    }
+
+private:
+    std::coroutine_handle<promise_type>     mHandle;
+};
+
+namespace detail
+{
+template<typename T>
+inline Task<T> Promise<T>::get_return_object() noexcept
+{
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept
+{
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+} // namespace detail
+
+// --------------------------------------------------------------------------
+/**
+ * Awaitable executing one command on the device I/O thread, or in between the frames of a running
+ * inventory, see STUHFL_F_ExecuteCmdAsync. Completion is signalled by the done callback only, the
+ * entry is never waited on.
+ * The awaiting coroutine is resumed from the loop and replied the result of the command.
+ * Params and data must stay valid until then, locals of the awaiting coroutine do.
+*/
+class CmdAwaiter
+{
+public:
+    CmdAwaiter(EventLoop &loop, STUHFL_T_READER_CTX ctx, STUHFL_T_CMD cmd, STUHFL_T_CMD_SND_PARAMS sndParams, STUHFL_T_CMD_RCV_DATA rcvParams) noexcept
+        : mLoop(loop), mCtx(ctx), mAsync()
+    {
+        mAsync.cmd = cmd;
+        mAsync.sndParams = sndParams;
+        mAsync.rcvParams = rcvParams;
+        mAsync.done = &CmdAwaiter::done;
+        mAsync.userCtx = this;
+    }
+    CmdAwaiter(const CmdAwaiter &) = delete;
+    CmdAwaiter &operator=(const CmdAwaiter &) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> h) noexcept
+    {
+        mHandle = h;
+        if (mCtx != nullptr) {
+            STUHFL_F_SelectReaderCtx(mCtx);
+        }
+        STUHFL_T_RET_CODE ret = STUHFL_F_ExecuteCmdAsync(&mAsync);
+        if (ret != ERR_NONE) {
+            // not queued, continue at once with the error
+            mAsync.ret = ret;
+            return false;
+        }
+        return true;
+    }
+    STUHFL_T_RET_CODE await_resume() const noexcept { return mAsync.ret; }
+
+private:
+    static void done(STUHFL_T_Cmd_Async *async)
+    {
+        // last access of the library to the entry, the coroutine may be resumed and release it at once
+        CmdAwaiter *self = static_cast<CmdAwaiter *>(async->userCtx);
+        self->mLoop.post(self->mHandle);
+    }
+
+    EventLoop                               &mLoop;
+    STUHFL_T_READER_CTX                     mCtx;
+    STUHFL_T_Cmd_Async                      mAsync;
+    std::coroutine_handle<>                 mHandle;
+};
+
+// --------------------------------------------------------------------------
+struct ReadResult {
+    STUHFL_T_RET_CODE                       ret = ERR_NONE;
+    STUHFL_T_Read                           data{};     /**< data[0..data.bytes2Read-1] holds the read bytes */
+};
+
+struct WriteResult {
+    STUHFL_T_RET_CODE                       ret = ERR_NONE;
+    STUHFL_T_Write                          data{};     /**< data.tagReply holds the tag reply */
+};
+
+/**
+ * Reader whose commands are awaited. The reader must be connected, commands are executed on the
+ * reader context given or on the default context. Must outlive the tasks using it.
+*/
+class Reader
+{
+public:
+    using Password = std::array<uint8_t, PASSWORD_LEN>;
+
+    explicit Reader(EventLoop &loop, STUHFL_T_READER_CTX ctx = nullptr) noexcept : mLoop(loop), mCtx(ctx) {}
+
+    EventLoop &loop() noexcept { return mLoop; }
+    STUHFL_T_READER_CTX ctx() const noexcept { return mCtx; }
+
+    /**
+     * Execute any command not replying inventory data, same params as for STUHFL_F_ExecuteCmd
+     * @return awaitable replying the error code of the command
+    */
+    CmdAwaiter execute(STUHFL_T_CMD cmd, STUHFL_T_CMD_SND_PARAMS sndParams, STUHFL_T_CMD_RCV_DATA rcvParams) noexcept
+    {
+        return CmdAwaiter(mLoop, mCtx, cmd, sndParams, rcvParams);
+    }
+
+    /**
+     * Gen2 read from the selected tag
+     * @param memBank: bank to read from
+     * @param wordPtr: word address to start reading
+     * @param bytes2Read: number of bytes to read, up to MAX_READ_DATA_LEN
+     * @param pwd: access password
+    */
+    Task<ReadResult> read(uint8_t memBank, uint32_t wordPtr, uint8_t bytes2Read, Password pwd = Password{})
+    {
+        ReadResult r;
+        r.data.memBank = memBank;
+        r.data.wordPtr = wordPtr;
+        r.data.bytes2Read = bytes2Read;
+        memcpy(r.data.pwd, pwd.data(), PASSWORD_LEN);
+        r.ret = co_await execute((STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_READ, &r.data, &r.data);
+        co_return r;
+    }
+
+    /**
+     * Gen2 write of one word to the selected tag
+     * @param memBank: bank to write to
+     * @param wordPtr: word address to be written
+     * @param word: data to be written, MSB first
+     * @param pwd: access password
+    */
+    Task<WriteResult> write(uint8_t memBank, uint32_t wordPtr, uint16_t word, Password pwd = Password{})
+    {
+        WriteResult r;
+        r.data.memBank = memBank;
+        r.data.wordPtr = wordPtr;
+        r.data.data[0] = (uint8_t)(word >> 8);
+        r.data.data[1] = (uint8_t)word;
+        memcpy(r.data.pwd, pwd.data(), PASSWORD_LEN);
+        r.ret = co_await execute((STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_WRITE, &r.data, &r.data);
+        co_return r;
+    }
+
+private:
+    EventLoop                               &mLoop;
+    STUHFL_T_READER_CTX                     mCtx;
+};
+
+// --------------------------------------------------------------------------
+/**
+ * Inventory runner whose cycles are awaited as batches, see STUHFL_F_SetInventoryQueue.
+ *
+ *     stuhfl::InventoryStream inventory(reader, 64);
+ *     inventory.start(&invOption);
+ *     while (const STUHFL_T_Inventory_Data *batch = co_await inventory.next()) {
+ *         ...
+ *     }
+ *
+ * Commands awaited on the same reader are sent by the runner in between its frames.
+*/
+class InventoryStream
+{
+public:
+    /**
+     * @param reader: reader running the inventory
+     * @param tagCntMax: number of tags kept per batch
+     * @param pollInterval: time in ms between queue checks while waiting for a batch
+    */
+    InventoryStream(Reader &reader, uint32_t tagCntMax, uint32_t pollInterval = 10)
+        : mReader(reader), mRunnerTags(tagCntMax), mBatchTags(tagCntMax), mPollInterval(pollInterval)
+    {
+        mRunnerData = STUHFL_T_Inventory_Data();
+        mBatch = STUHFL_T_Inventory_Data();
+    }
+    InventoryStream(const InventoryStream &) = delete;
+    InventoryStream &operator=(const InventoryStream &) = delete;
+    ~InventoryStream() { stop(); }
+
+    /**
+     * Set the queue and start the runner
+     * @param option: inventory options as for STUHFL_F_Start
+     * @param capacity: number of batches the queue can hold, must be a power of 2
+     * @param policy: what the runner does when the queue is full, STUHFL_QUEUE_POLICY_xyz
+     *
+     * @return error code
+    */
+    STUHFL_T_RET_CODE start(STUHFL_T_ACTION_OPTION option, uint32_t capacity = 16, uint8_t policy = STUHFL_QUEUE_POLICY_BLOCK)
+    {
+        select();
+        STUHFL_T_RET_CODE ret = STUHFL_F_SetInventoryQueue(capacity, (uint32_t)mBatchTags.size(), policy);
+        if (ret != ERR_NONE) {
+            return ret;
+        }
+        mRunnerData.tagList = mRunnerTags.data();
+        mRunnerData.tagListSizeMax = (uint32_t)mRunnerTags.size();
+        mFinished = false;
+        ret = STUHFL_F_Start_OOP(STUHFL_ACTION_INVENTORY, option, this, nullptr, &mRunnerData, &InventoryStream::finished, &mId);
+        if (ret != ERR_NONE) {
+            mId = 0;
+            STUHFL_F_SetInventoryQueue(0, 0, policy);
+        }
+        return ret;
+    }
+
+    /**
+     * Stop the runner and remove the queue. Blocks the loop until the runner has terminated.
+     *
+     * @return error code
+    */
+    STUHFL_T_RET_CODE stop()
+    {
+        if (mId == 0) {
+            return ERR_NONE;
+        }
+        select();
+        STUHFL_T_RET_CODE ret = mFinished ? ERR_NONE : STUHFL_F_Stop(mId);
+        STUHFL_F_SetInventoryQueue(0, 0, STUHFL_QUEUE_POLICY_BLOCK);
+        mId = 0;
+        return ret;
+    }
+
+    /**
+     * Await the next batch. The batch is valid until next() is awaited again.
+     * @return awaitable replying the batch, nullptr once the runner has terminated and all batches were taken
+    */
+    Task<const STUHFL_T_Inventory_Data *> next()
+    {
+        for (;;) {
+            if (mId == 0) {
+                co_return nullptr;
+            }
+            // sample before popping, the runner pushes its last batch before it reports finished
+            bool finished = mFinished;
+            mBatch.tagList = mBatchTags.data();
+            mBatch.tagListSizeMax = (uint32_t)mBatchTags.size();
+            select();
+            STUHFL_T_RET_CODE ret = STUHFL_F_InventoryQueuePop(&mBatch);
+            if (ret == ERR_NONE) {
+                co_return &mBatch;
+            }
+            if ((ret != ERR_NOMSG) || finished) {
+                co_return nullptr;
+            }
+            co_await mReader.loop().sleep(mPollInterval);
+        }
+    }
+
+private:
+    static STUHFL_T_RET_CODE finished(STUHFL_T_CallerCtx obj, STUHFL_T_ACTION_CYCLE_DATA data)
+    {
+        (void)data;
+        static_cast<InventoryStream *>(obj)->mFinished = true;
+        return ERR_NONE;
+    }
+
+    void select()
+    {
+        if (mReader.ctx() != nullptr) {
+            STUHFL_F_SelectReaderCtx(mReader.ctx());
+        }
+    }
+
+    Reader                                  &mReader;
+    std::vector<STUHFL_T_Inventory_Tag>     mRunnerTags;    // working list of the runner
+    std::vector<STUHFL_T_Inventory_Tag>     mBatchTags;     // list of the batch replied by next()
+    STUHFL_T_Inventory_Data                 mRunnerData;
+    STUHFL_T_Inventory_Data                 mBatch;
+    uint32_t                                mPollInterval;
+    STUHFL_T_ACTION_ID                      mId = 0;
+    std::atomic<bool>                       mFinished{ false };
+};
+
+} // namespace stuhfl
+
+#endif // __STUHFL_CORO_HPP
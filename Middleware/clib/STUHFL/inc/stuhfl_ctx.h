@@ -0,0 +1,260 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+//
+#if !defined __STUHFL_CTX_H
+#define __STUHFL_CTX_H
+
+//
+#include "stuhfl.h"
+#include "stuhfl_al.h"
+#include "stuhfl_dl.h"
+#include "stuhfl_pl.h"
+#include "stuhfl_platform.h"
+#if defined(POSIX)
+#include <termios.h>
+#endif
+
+//
+#ifdef __cplusplus
+extern "C"
+{
+#endif //__cplusplus
+
+// Internal state of one reader. All layers keep their per connection state here instead of
+// file scope globals, so several readers can be driven in parallel, each from its own thread.
+
+#define RX_RING_SIZE                            (4*UART_TX_BUFFER_SIZE)     // must be power of 2
+#define TX_QUEUE_SIZE                           (4*UART_RX_BUFFER_SIZE)
+
+#define STUHFL_D_DEFAULT_BR                     3000000     // highest baudrate supported by FT231X on EVAL board
+#if defined(WIN32) || defined(WIN64)
+#define STUHFL_D_DEFAULT_RD_TIMEOUT             4000
+#else
+#define STUHFL_D_DEFAULT_RD_TIMEOUT             2000
+#endif
+#define STUHFL_D_DEFAULT_WR_TIMEOUT             1000
+
+#define SHADOW_SLOT_CNT                         9           // # of params kept in shadow cache
+#define SHADOW_VALUE_SIZE                       64          // >= largest shadowed param (Gen2Inventory_Cfg)
+
+// Eval API layer
+typedef struct {
+    STUHFL_T_DEVICE_CTX                 device;
+    uint8_t                             sndData[UART_RX_BUFFER_SIZE];   /* HOST SND buffer based on FW RCV buffer */
+    uint8_t                             rcvData[UART_TX_BUFFER_SIZE];   /* HOST RCV buffer based on FW SND buffer */
+    STUHFL_T_ACTION_ID                  invRunnerId;
+    STUHFL_T_ActionFinished             callerFinishedCallback;
+    struct STUHFL_S_Reader_Profile      *appliedProfile;                /* last state applied by ApplyProfile, allocated on first use */
+} STUHFL_T_API_Ctx;
+
+// Activity layer
+typedef struct {
+#if defined(WIN32) || defined(WIN64)
+    HANDLE                              inventoryThread;
+#elif defined(POSIX)
+    pthread_t                           inventoryThread;
+#endif
+    STUHFL_T_Runner_Thread_Option       threadOption;
+    STUHFL_T_Runner_Thread_Status       threadStatus;
+    STUHFL_T_ACTION                     action;
+    STUHFL_T_CallerCtx                  callerCtxPointer;
+    STUHFL_T_ActionCycle                actionCycleCallback;
+    STUHFL_T_ActionCycleOOP             actionCycleCallbackOOP;
+    STUHFL_T_ActionFinished             actionFinishedCallback;
+    STUHFL_T_ActionFinishedOOP          actionFinishedCallbackOOP;
+    STUHFL_T_ACTION_CYCLE_DATA          actionCycleData;
+    uint32_t                            requestedRoundCnt;
+    STUHFL_T_InventoryTagView           tagViewCallback;        // optional, tags are delivered as views instead of tagList
+    STUHFL_T_InventoryStatisticsView    statisticsViewCallback; // optional, streaming mode: replaces the cycle callback
+    STUHFL_T_Inventory_Tag_Batch        *tagBatch;              // optional, tags are delivered as columns instead of tagList
+    void                                *tagViewCtx;
+
+    // optional lock free single producer/single consumer queue between runner and application
+    STUHFL_T_Inventory_Data             *queueSlots;            // capacity entries, followed by their tagLists in the same block
+    uint32_t                            queueCapacity;          // power of 2
+    uint32_t                            queueTagCntMax;
+    uint8_t                             queuePolicy;
+    volatile uint32_t                   queueRd;                // free running, advanced by application and by runner on drop oldest
+    volatile uint32_t                   queueWr;                // free running, advanced by runner only
+    uint32_t                            queueHighWater;
+    uint32_t                            queuePushed;
+    uint32_t                            queueDropped;
+    uint32_t                            queueBlocked;
+    STUHFL_T_Cond                       queueCond;              // entry pulled or stop requested, wakes a runner blocked on a full queue
+
+    // stop handshake, the runner sends the STOP itself and signals when it has terminated
+    volatile uint32_t                   stopRequested;
+    bool                                runnerDone;
+    STUHFL_T_Mutex                      runnerLock;
+    STUHFL_T_Cond                       runnerDoneCond;         // also signalled when the device I/O thread hands back the port
+    uint32_t                            stopDrainedFrames;      // # of inventory frames dropped while waiting for the STOP reply
+
+    // port ownership between runner and device I/O thread, guarded by runnerLock
+    bool                                runnerClaimed;          // from STUHFL_F_Start until the runner has terminated
+    bool                                asyncBatchActive;       // device I/O thread executes a batch, STUHFL_F_Start waits for it
+} STUHFL_T_AL_Ctx;
+
+// runner thread is valid from STUHFL_F_Start until the runner has terminated
+#define STUHFL_RUNNER_ACTIVE(al)    (((al)->inventoryThread != INVALID_HANDLE_VALUE) && ((al)->inventoryThread != 0))
+
+// Device layer
+typedef struct {
+    STUHFL_T_DEVICE_CTX                 deviceCtx;
+    STUHFL_T_ParamTypeConnectionPort    comPort;
+    STUHFL_T_ParamTypeConnectionBR      br;
+    bool                                ignoreInventoryData;
+    STUHFL_T_InventoryGrow              invGrow;                        // optional, grows tagList when full
+    void                                *invGrowCtx;
+
+    // optional host side shadow of the reader configuration
+    bool                                shadowEnabled;
+    uint16_t                            shadowValid;                    // bit per slot
+    uint32_t                            shadowHits[SHADOW_SLOT_CNT];
+    uint32_t                            shadowMisses[SHADOW_SLOT_CNT];
+    uint8_t                             shadow[SHADOW_SLOT_CNT][SHADOW_VALUE_SIZE];
+
+    // optional device I/O thread executing the commands queued by STUHFL_F_ExecuteCmdAsync
+#if defined(WIN32) || defined(WIN64)
+    HANDLE                              asyncThread;
+#elif defined(POSIX)
+    pthread_t                           asyncThread;
+#endif
+    bool                                asyncRunning;
+    volatile bool                       asyncExit;
+    STUHFL_T_Mutex                      asyncLock;
+    STUHFL_T_Cond                       asyncCond;              // queue filled or command completed
+    STUHFL_T_Cmd_Async                  *asyncHead;
+    STUHFL_T_Cmd_Async                  *asyncTail;
+    // queued commands sent by the runner in between its frames, accessed by the runner only
+    STUHFL_T_Cmd_Async                  *asyncServed[STUHFL_D_PIPELINE_WINDOW_MAX];
+    uint16_t                            asyncServedID[STUHFL_D_PIPELINE_WINDOW_MAX];
+    uint32_t                            asyncServedTime[STUHFL_D_PIPELINE_WINDOW_MAX];
+    uint8_t                             asyncServedCnt;
+} STUHFL_T_DL_Ctx;
+
+// Protocol layer
+typedef struct {
+    uint16_t                            sndID;
+    uint16_t                            rcvID;
+    uint16_t                            mode;
+    uint8_t                             *snd;
+    uint16_t                            sndMaxLen;
+    uint8_t                             *rcv;
+    uint16_t                            rcvMaxLen;
+
+    // host side receive ring, frames are parsed out of whatever the platform delivered
+    uint8_t                             rxRing[RX_RING_SIZE];
+    uint32_t                            rxRingRd;               // free running read index
+    uint32_t                            rxRingWr;               // free running write index
+    uint32_t                            rxResyncCnt;            // # of times the stream had to be resynchronized
+    uint32_t                            rxDroppedBytes;         // # of bytes skipped while searching for a valid header
+
+    // platform operation handlers
+    STUHFL_T_Reset                      platformReset;
+    STUHFL_T_Disconnect                 platformDisconnect;
+    STUHFL_T_SndRaw                     platformSndRaw;
+    STUHFL_T_SndRawV                    platformSndRawV;            // optional, scatter-gather send
+    STUHFL_T_RcvRaw                     platformRcvRaw;
+    STUHFL_T_RcvRawAvailable            platformRcvRawAvailable;    // optional, enables receive ring
+    STUHFL_T_SetDTR                     platformSetDTR;
+    STUHFL_T_GetDTR                     platformGetDTR;
+    STUHFL_T_SetRTS                     platformSetRTS;
+    STUHFL_T_GetRTS                     platformGetRTS;
+    STUHFL_T_SetTimeouts                platformSetTimeouts;
+    STUHFL_T_GetTimeouts                platformGetTimeouts;
+    STUHFL_T_SetTxQueue                 platformSetTxQueue;
+    STUHFL_T_GetTxQueue                 platformGetTxQueue;
+} STUHFL_T_PL_Ctx;
+
+// Board layer
+typedef struct {
+    STUHFL_T_ParamTypeConnectionRdTimeout   rdComTimeout;
+    STUHFL_T_ParamTypeConnectionWrTimeout   wrComTimeout;
+#if defined(POSIX)
+    struct termios                      oldtio;
+
+    // optional host side transmit queue, frames are handed over to the UART as the port accepts them
+    uint8_t                             txQueue[TX_QUEUE_SIZE];
+    uint32_t                            txQueueLen;
+    bool                                txQueueEnabled;
+
+    // socket transports have no modem lines, the last DTR/RTS value set is kept for GetParam
+    uint8_t                             sockDtr;
+    uint8_t                             sockRts;
+#endif
+} STUHFL_T_BL_Ctx;
+
+typedef struct STUHFL_S_Reader_Ctx {
+    STUHFL_T_API_Ctx                    api;
+    STUHFL_T_AL_Ctx                     al;
+    STUHFL_T_DL_Ctx                     dl;
+    STUHFL_T_PL_Ctx                     pl;
+    STUHFL_T_BL_Ctx                     bl;
+    struct STUHFL_S_Reader_Ctx          *next;          // list of all contexts, to find the owner of a runner
+    uint32_t                            refCnt;         // lookups by STUHFL_F_RunnerReaderCtx not released yet, guarded by the list lock
+} STUHFL_T_Reader_Ctx;
+
+/**
+ * Get the reader context selected for the calling thread
+ *
+ * @return selected reader context, the default context when none was selected
+*/
+STUHFL_T_Reader_Ctx *STUHFL_F_CurReaderCtx(void);
+
+/**
+ * Find the reader context whose inventory runner has the given ID.
+ * The context can not be destroyed until it is handed back with STUHFL_F_ReleaseReaderCtx
+ * @param id: ID of the runner as replied by STUHFL_F_Start
+ *
+ * @return reader context running the runner, NULL when no runner with this ID is active
+*/
+STUHFL_T_Reader_Ctx *STUHFL_F_RunnerReaderCtx(STUHFL_T_ACTION_ID id);
+
+/**
+ * Hand back a reader context found by STUHFL_F_RunnerReaderCtx
+ * @param *ctx: reader context
+*/
+void STUHFL_F_ReleaseReaderCtx(STUHFL_T_Reader_Ctx *ctx);
+
+/**
+ * Used by the inventory runner in between its frames: sends queued asynchronous commands, up to
+ * STUHFL_D_PIPELINE_WINDOW_MAX in flight. Their replies are completed while receiving the inventory frames.
+ * @param drain: send no more commands, receive the outstanding replies until the receive timeout of the oldest one
+ *
+ * @return error code
+*/
+STUHFL_T_RET_CODE STUHFL_F_ServeCmdAsync(bool drain);
+
+/**
+ * Wait until the inventory runner of a reader context has terminated, the runner thread is detached and can not be joined
+ * @param *ctx: reader context of the runner
+ * @param timeout: max time to wait in ms
+ *
+ * @return ERR_NONE when the runner has terminated, ERR_TIMEOUT otherwise
+*/
+STUHFL_T_RET_CODE STUHFL_F_WaitRunnerDone(STUHFL_T_Reader_Ctx *ctx, uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif // __STUHFL_CTX_H
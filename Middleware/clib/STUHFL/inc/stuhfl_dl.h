@@ -24,6 +24,7 @@
 #define __STUHFL_DL_H
 
 #include "stuhfl.h"
+#include "stuhfl_sl.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -60,6 +61,37 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Disconnect(void);
 */
 STUHFL_DLL_API STUHFL_T_DEVICE_CTX CALL_CONV STUHFL_F_GetCtx(void);
 
+// --------------------------------------------------------------------------
+/**
+ * Create a new reader context. Each context holds its own connection, buffers and runner state
+ * so that several readers can be driven in parallel. Select the context before connecting.
+ * @param *ctx: replied reader context
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_CreateReaderCtx(STUHFL_T_READER_CTX *ctx);
+/**
+ * Destroy a reader context created with STUHFL_F_CreateReaderCtx. The reader must be disconnected and no runner may be active.
+ * @param ctx: reader context to be destroyed
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_DestroyReaderCtx(STUHFL_T_READER_CTX ctx);
+/**
+ * Select the reader context used by all following STUHFL calls of the calling thread.
+ * Threads that never select a context share the default context.
+ * @param ctx: reader context to be used, NULL selects the default context
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SelectReaderCtx(STUHFL_T_READER_CTX ctx);
+/**
+ * Get reader context selected for the calling thread
+ *
+ * @return reader context
+*/
+STUHFL_DLL_API STUHFL_T_READER_CTX CALL_CONV STUHFL_F_GetReaderCtx(void);
+
 // --------------------------------------------------------------------------
 #define STUHFL_RESET_TYPE_SOFT              0x00 // clear all internal states and pending operations
 #define STUHFL_RESET_TYPE_HARD              0x01 // reboot device and clear all states
@@ -141,6 +173,161 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ReceiveCmdData(STUHFL_T_CMD
  * @return error code
 */
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ExecuteCmd(STUHFL_T_CMD cmd, STUHFL_T_CMD_SND_PARAMS sndParams, STUHFL_T_CMD_RCV_DATA rcvParams);
+/**
+ * Check whether a command is defined by the firmware protocol, used to validate received frame headers
+ * @param cmd: command group and code
+ *
+ * @return true when the command is known
+*/
+bool STUHFL_F_IsKnownCmd(STUHFL_T_CMD cmd);
+/**
+ * Receive one inventory data frame without copying the tag data. For every tag in the frame
+ * tagCallback is called with views pointing directly into the receive buffer. The views are
+ * only valid until the callback returns.
+ * @param tagCallback: function called for every received tag
+ * @param statisticsCallback: optional, function called for every received statistics
+ * @param *userCtx: pointer passed back to tagCallback and statisticsCallback
+ * @param *statistics: inventory statistics, updated when contained in the frame
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ReceiveInventoryViews(STUHFL_T_InventoryTagView tagCallback, STUHFL_T_InventoryStatisticsView statisticsCallback, void *userCtx, STUHFL_T_Inventory_Statistics *statistics);
+/**
+ * Set the sink used to grow the tagList of the inventory data when more tags are received than
+ * tagListSizeMax. Without sink the exceeding tags are not stored and counted in tagListDropped.
+ * Must be set before an inventory is started.
+ * @param grow: function returning a larger tagList, NULL removes the sink
+ * @param *userCtx: pointer passed back to grow
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetInventorySink(STUHFL_T_InventoryGrow grow, void *userCtx);
+/**
+ * Allocate the columns of a tag batch in one block, each column aligned to STUHFL_D_TAG_BATCH_ALIGN
+ * @param *batch: batch to be set up, tagCnt and epcDataSize are reset
+ * @param tagCntMax: number of tags the batch can hold
+ * @param epcDataSizeMax: number of EPC bytes the batch can hold, 0 for tagCntMax * MAX_EPC_LENGTH
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_AllocTagBatch(STUHFL_T_Inventory_Tag_Batch *batch, uint32_t tagCntMax, uint32_t epcDataSizeMax);
+/**
+ * Free the columns of a tag batch allocated by STUHFL_F_AllocTagBatch
+ * @param *batch: batch to be freed
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_FreeTagBatch(STUHFL_T_Inventory_Tag_Batch *batch);
+/**
+ * Append one tag to a tag batch. Matches STUHFL_T_InventoryTagView so it can be passed with the batch
+ * as userCtx to the inventory views, the tag is then written into the columns straight from the receive buffer.
+ * A tag that does not fit is counted in dropped.
+ * @param *batch: STUHFL_T_Inventory_Tag_Batch to append to
+ * @param *tag: tag to be appended
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_TagBatchAppend(void *batch, const STUHFL_T_Inventory_Tag_View *tag);
+
+// --------------------------------------------------------------------------
+#define STUHFL_D_PIPELINE_WINDOW_MAX    8   // max number of commands in flight
+
+#pragma pack(push, 1)
+typedef struct {
+    STUHFL_T_CMD                        cmd;        /**< I Param: command to be executed */
+    STUHFL_T_CMD_SND_PARAMS             sndParams;  /**< I Param: command parameters. Same format as for STUHFL_F_ExecuteCmd */
+    STUHFL_T_CMD_RCV_DATA               rcvParams;  /**< O Param: received params of the command */
+    STUHFL_T_RET_CODE                   ret;        /**< O Param: result of this command */
+} STUHFL_T_Cmd_Pipeline_Entry;
+#define STUHFL_O_CMD_PIPELINE_ENTRY_INIT(...) ((STUHFL_T_Cmd_Pipeline_Entry) { .cmd = 0, .sndParams = NULL, .rcvParams = NULL, .ret = 0, ##__VA_ARGS__ })
+#pragma pack(pop)
+
+/**
+ * Execute a list of commands pipelined. Up to window commands are sent before their
+ * replies are received. Replies are matched to the commands by the frame preamble ID.
+ * When no matching reply arrives within the read timeout the oldest command fails with ERR_TIMEOUT, after
+ * STUHFL_D_PIPELINE_WINDOW_MAX frames matching no command in flight with ERR_PROTO, on ERR_IO all remaining ones.
+ * Inventory, runner, param, version and info commands as well as generic GB29768 commands can not be pipelined.
+ * @param *cmds: list of commands to be executed. The result of each command is replied in cmds[i].ret
+ * @param cmdCnt: number of commands in list
+ * @param window: max number of commands in flight (1..STUHFL_D_PIPELINE_WINDOW_MAX)
+ *
+ * @return error code, combination of all command results
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ExecuteCmdPipelined(STUHFL_T_Cmd_Pipeline_Entry *cmds, uint16_t cmdCnt, uint8_t window);
+
+// --------------------------------------------------------------------------
+typedef struct STUHFL_S_Cmd_Async STUHFL_T_Cmd_Async;
+
+/**
+ * Called from the device I/O thread, or from the runner thread while an inventory runner is active,
+ * when an asynchronous command has completed, ret is valid.
+ * The callback is the last access of the library to the entry, it may release or reuse it. Entries
+ * with callback must not be waited on with STUHFL_F_WaitCmdAsync nor polled for completed.
+*/
+typedef void (*STUHFL_T_CmdAsyncDone)(STUHFL_T_Cmd_Async *async);
+
+#pragma pack(push, 1)
+struct STUHFL_S_Cmd_Async {
+    STUHFL_T_CMD                        cmd;        /**< I Param: command to be executed */
+    STUHFL_T_CMD_SND_PARAMS             sndParams;  /**< I Param: command parameters. Same format as for STUHFL_F_ExecuteCmd */
+    STUHFL_T_CMD_RCV_DATA               rcvParams;  /**< O Param: received params of the command */
+    STUHFL_T_CmdAsyncDone               done;       /**< I Param: optional, called when the command has completed. Excludes waiting on the entry */
+    void                                *userCtx;   /**< I Param: free for use by the caller, e.g. in done */
+    volatile STUHFL_T_RET_CODE          ret;        /**< O Param: result of this command, valid once completed */
+    volatile uint32_t                   completed;  /**< O Param: set when the command has completed */
+    void                                *readerCtx; /**< internal: reader the command was queued on */
+    STUHFL_T_Cmd_Async                  *next;      /**< internal: queue link */
+};
+#define STUHFL_O_CMD_ASYNC_INIT(...) ((STUHFL_T_Cmd_Async) { .cmd = 0, .sndParams = NULL, .rcvParams = NULL, .done = NULL, .userCtx = NULL, .ret = 0, .completed = 0, .readerCtx = NULL, .next = NULL, ##__VA_ARGS__ })
+#pragma pack(pop)
+
+/**
+ * Queue a command to the device I/O thread of the selected reader and return at once. The I/O thread is
+ * started with the first queued command and ends on disconnect. Commands queued from any number of threads are
+ * executed in queue order, up to STUHFL_D_PIPELINE_WINDOW_MAX of them pipelined. While an inventory runner
+ * is active the runner owns the port: it sends the queued commands in between its inventory frames and takes
+ * their replies from the frame stream by frame ID. Commands still queued when a stop of the runner was requested
+ * are executed after it has terminated.
+ * Commands that can not be pipelined can not be queued either. The entry, its params and data must stay valid until completed.
+ * Starting a runner waits until the I/O thread has finished the batch it is executing. Other synchronous commands
+ * must not be issued on the same reader while asynchronous ones are pending.
+ * @param *async: command to be queued
+ *
+ * @return error code of queueing, the result of the command is replied in async->ret
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ExecuteCmdAsync(STUHFL_T_Cmd_Async *async);
+/**
+ * Wait for an asynchronous command to complete. Commands not yet executed on disconnect complete with ERR_REQUEST.
+ * @param *async: command queued by STUHFL_F_ExecuteCmdAsync without done callback
+ * @param timeout: max time to wait in ms, 0 to poll
+ *
+ * @return result of the command, ERR_TIMEOUT when it did not complete in time, ERR_PARAM for entries with done callback
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_WaitCmdAsync(STUHFL_T_Cmd_Async *async, uint32_t timeout);
+
+// --------------------------------------------------------------------------
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t                            hits;       /**< O Param: # of reads served from the shadow cache */
+    uint32_t                            misses;     /**< O Param: # of reads that had to be fetched from the reader */
+} STUHFL_T_Shadow_Stats;
+#define STUHFL_O_SHADOW_STATS_INIT(...) ((STUHFL_T_Shadow_Stats) { .hits = 0, .misses = 0, ##__VA_ARGS__ })
+#pragma pack(pop)
+
+/**
+ * Get hit/miss counters of the shadow cache for one parameter.
+ * With STUHFL_PARAM_KEY_SHADOW_CACHE enabled the values of freq hop, LBT, TxRx, PA,
+ * Gen2/GB29768 protocol and inventory configuration and Gen2 timings are remembered on every successful
+ * set or get and further gets are answered without a round trip to the reader. The shadow is dropped on
+ * connect, disconnect, reset, reboot and whenever the cache is switched on or off. Changes the firmware applies on its own
+ * (e.g. adaptive sensitivity during inventory) are not seen, switch the cache off and on again to drop the shadow.
+ * @param param: Parameter of which the counters shall be replied
+ * @param *stats: replied counters
+ *
+ * @return error code, ERR_PARAM if param is not kept in the shadow cache
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetShadowCacheStats(STUHFL_T_PARAM param, STUHFL_T_Shadow_Stats *stats);
 
 // --------------------------------------------------------------------------
 /**
@@ -54,6 +54,76 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV Connect(char *szComPort);
     * @return error code
     */
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV Disconnect(void);
+#define STUHFL_D_BOOT_TIMEOUT_MS    2000U
+/**
+    * Connect to ST25RU3993 based EVAL board and wait until the board firmware is up.
+    * Replaces a fixed delay after Connect, see WaitForBoard.
+    * @param szComPort: The port name were the ST25RU3993 board is connected.
+    + The string must be null terminated.
+    * @param bootTimeout: Max. time in ms to wait for the board (e.g. STUHFL_D_BOOT_TIMEOUT_MS)
+    * @param bootTime: Replied time in ms until the board answered, may be NULL
+    *
+    * @return error code, ERR_TIMEOUT if the board did not answer within bootTimeout
+    */
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV ConnectWaitReady(char *szComPort, uint32_t bootTimeout, uint32_t *bootTime);
+/**
+    * Wait until the board firmware answers after a reset (e.g. the one done on Connect).
+    * The board is polled with version requests using a short read timeout, the function returns
+    * as soon as the first reply arrived.
+    * @param bootTimeout: Max. time in ms to wait for the board
+    * @param bootTime: Replied time in ms until the board answered, may be NULL
+    *
+    * @return error code, ERR_TIMEOUT if the board did not answer within bootTimeout
+    */
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV WaitForBoard(uint32_t bootTimeout, uint32_t *bootTime);
+#pragma pack(push, 1)
+#define STUHFL_D_BAUD_PROBE_EXCHANGES   20U
+typedef struct {
+    char                                *cacheFile;     /**< I Param: File caching the probed baudrate per port, NULL disables the cache */
+    uint8_t                             exchanges;      /**< I Param: Number of version exchanges measured per candidate baudrate */
+    bool                                forceProbe;     /**< I Param: Probe even if a cached baudrate exists */
+    uint32_t                            br;             /**< O Param: Selected baudrate */
+    uint32_t                            avgRttUs;       /**< O Param: Average round trip time of the successful version exchanges at selected baudrate in us */
+    uint8_t                             errors;         /**< O Param: Failed exchanges at selected baudrate */
+    uint8_t                             candidates;     /**< O Param: Number of baudrates tried */
+    bool                                cached;         /**< O Param: Baudrate taken from cache, no probing done */
+} STUHFL_T_BaudProbe;
+#define STUHFL_O_BAUD_PROBE_INIT(...) ((STUHFL_T_BaudProbe) { .cacheFile = NULL, .exchanges = STUHFL_D_BAUD_PROBE_EXCHANGES, .forceProbe = false, .br = 0, .avgRttUs = 0, .errors = 0, .candidates = 0, .cached = false, ##__VA_ARGS__ })
+#pragma pack(pop)
+/**
+    * Connect to ST25RU3993 based EVAL board with the fastest stable baudrate.
+    * Candidate baudrates are tried from highest to lowest, at each one a number of version
+    * exchanges is run and the first baudrate without failed exchange is kept.
+    * With a cache file the selected baudrate is stored per port and used on later connects
+    * without probing. If the cached baudrate does not work anymore, probing is repeated.
+    * @param szComPort: The port name were the ST25RU3993 board is connected.
+    + The string must be null terminated.
+    * @param probe: See STUHFL_T_BaudProbe struct for further info
+    *
+    * @return error code, ERR_IO if no candidate baudrate is stable
+    */
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV ConnectAutoBaud(char *szComPort, STUHFL_T_BaudProbe *probe);
+/**
+    * Connect to an additional ST25RU3993 based EVAL board. A new reader context is created
+    * and selected for the calling thread, all following calls of this thread address this board.
+    * Other threads have to select the context with STUHFL_F_SelectReaderCtx before using it.
+    * On failure the context is destroyed and ctx is NULL, unless the context is still busy.
+    * In that case ctx stays valid and has to be released with DisconnectReader.
+    * @param ctx: replied reader context of the connected board
+    * @param szComPort: The port name were the ST25RU3993 board is connected.
+    + The string must be null terminated.
+    *
+    * @return error code
+    */
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV ConnectReader(STUHFL_T_READER_CTX *ctx, char *szComPort);
+/**
+    * Disconnect from a board connected with ConnectReader and release its reader context.
+    * The calling thread keeps the context it had selected before, or falls back to the default context when it had selected ctx.
+    * @param ctx: reader context of the board
+    *
+    * @return error code
+    */
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV DisconnectReader(STUHFL_T_READER_CTX ctx);
 
 /**
     * Read the board software and hardware information\n
@@ -330,6 +400,53 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV GetGen2InventoryCfg(STUHFL_T_ST25RU39
 */
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV GetGb29768InventoryCfg(STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg *invGb29768Cfg);
 
+// --------------------------------------------------------------------------
+// Profile
+// --------------------------------------------------------------------------
+#define STUHFL_D_PROFILE_TXRX_CFG               0x0001
+#define STUHFL_D_PROFILE_GEN2INVENTORY_CFG      0x0002
+#define STUHFL_D_PROFILE_GEN2PROTOCOL_CFG       0x0004
+#define STUHFL_D_PROFILE_FREQ_LBT               0x0008
+#define STUHFL_D_PROFILE_CHANNEL_LIST           0x0010
+#define STUHFL_D_PROFILE_FREQ_HOP               0x0020
+#define STUHFL_D_PROFILE_ANTENNA_POWER          0x0040
+#define STUHFL_D_PROFILE_ALL                    0x007F
+
+#pragma pack(push, 1)
+typedef struct STUHFL_S_Reader_Profile {
+    uint16_t                                use;                /**< I Param: STUHFL_D_PROFILE_xyz bits of the members that belong to this profile */
+    STUHFL_T_ST25RU3993_TxRx_Cfg            txRxCfg;            /**< I Param: TxRx configuration */
+    STUHFL_T_ST25RU3993_Gen2Inventory_Cfg   gen2InventoryCfg;   /**< I Param: Gen2 inventory configuration */
+    STUHFL_T_ST25RU3993_Gen2Protocol_Cfg    gen2ProtocolCfg;    /**< I Param: Gen2 protocol configuration */
+    STUHFL_T_ST25RU3993_Freq_LBT            freqLBT;            /**< I Param: Listen before talk configuration */
+    STUHFL_T_ST25RU3993_ChannelList         channelList;        /**< I Param: Channel list */
+    STUHFL_T_ST25RU3993_Freq_Hop            freqHop;            /**< I Param: Frequency hopping configuration */
+    STUHFL_T_ST25RU3993_Antenna_Power       antennaPower;       /**< I Param: Antenna power */
+} STUHFL_T_Reader_Profile;
+#define STUHFL_O_READER_PROFILE_INIT(...) ((STUHFL_T_Reader_Profile) { .use = STUHFL_D_PROFILE_ALL, .txRxCfg = STUHFL_O_ST25RU3993_TXRX_CFG_INIT(), .gen2InventoryCfg = STUHFL_O_ST25RU3993_GEN2INVENTORY_CFG_INIT(), \
+                                            .gen2ProtocolCfg = STUHFL_O_ST25RU3993_GEN2PROTOCOL_CFG_INIT(), .freqLBT = STUHFL_O_ST25RU3993_FREQ_LBT_INIT(), .channelList = STUHFL_O_ST25RU3993_CHANNELLIST_INIT(), \
+                                            .freqHop = STUHFL_O_ST25RU3993_FREQ_HOP_INIT(), .antennaPower = STUHFL_O_ST25RU3993_ANTENNA_POWER_INIT(), ##__VA_ARGS__ })
+#pragma pack(pop)
+
+/**
+ * Apply a reader profile. The profile is compared against the state applied last on this reader
+ * and only the members that changed are sent, packed into as few SET_PARAM frames as the
+ * board receive buffer allows. The applied state is forgotten on connect, disconnect, reboot
+ * and by the single Set functions of the profile members. Params set directly via STUHFL_F_SetParam
+ * are not tracked, call ForgetProfile() in that case.
+ * @param profile: profile to be applied. Only members selected in profile->use are applied
+ * @param frames: if not NULL, replies the number of frames sent. 0 if nothing changed
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV ApplyProfile(STUHFL_T_Reader_Profile *profile, uint8_t *frames);
+/**
+ * Forget the applied profile state, the next ApplyProfile sends all members of its profile
+ *
+ * @return None
+*/
+STUHFL_DLL_API void CALL_CONV ForgetProfile(void);
+
 
 
 
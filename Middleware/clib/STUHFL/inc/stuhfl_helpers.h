@@ -54,6 +54,24 @@ uint16_t getTlvExt(uint8_t *data, uint8_t *tag, uint16_t *len, void *value);
 uint8_t getTlvTag(uint8_t *data);
 uint16_t getTlvLen(uint8_t *data);
 
+// tlv iteration over a received payload, the payload is only read
+typedef struct {
+    uint8_t                             tag;
+    uint16_t                            len;
+    const uint8_t                       *value;     // points into the iterated payload
+} STUHFL_T_Tlv;
+
+typedef struct {
+    const uint8_t                       *data;
+    uint16_t                            len;
+    uint16_t                            pos;
+    bool                                overrun;    // a TLV exceeded the payload, iteration stopped
+} STUHFL_T_TlvIter;
+
+void tlvIterInit(STUHFL_T_TlvIter *it, const uint8_t *data, uint16_t len);
+bool tlvIterNext(STUHFL_T_TlvIter *it, STUHFL_T_Tlv *tlv);
+uint16_t tlvCopy(const STUHFL_T_Tlv *tlv, void *value, uint16_t size);
+
 // --------------------------------------------------------------------------
 char* byteArray2HexString(char* retBuf, uint16_t retBufSize, uint8_t* data, uint16_t dataLen);
 
@@ -50,8 +50,8 @@ extern "C"
 typedef struct {
     bool                                generateLogTimestamp;
     uint32_t                            logLevels;
-    char*                               logBuf[LOG_LEVEL_COUNT];        /* log buffer used to store log information for each log level */
-    uint16_t                            logBufSize[LOG_LEVEL_COUNT];    /* size of logBuf for each log level*/
+    char*                               logBuf[LOG_LEVEL_COUNT];        /* not used anymore, lines are handed to the callback in a buffer of the logging thread */
+    uint16_t                            logBufSize[LOG_LEVEL_COUNT];    /* max line length for each log level */
 } STUHFL_T_Log_Option;
 #define STUHFL_O_LOG_OPTION_INIT(logStorage, logStorageSize, ...) ((STUHFL_T_Log_Option) {  .generateLogTimestamp = true, \
                                                                                             .logLevels = LOG_LEVEL_ALL,     \
@@ -71,7 +71,7 @@ typedef struct {
     uint32_t                            logIdx;
     uint32_t                            logTickCountMs[2];              /* [0] = TickCount time of STUHFL_F_LogClear() call and [1] = TickCount time of STUHFL_F_LogFlush() */
     uint32_t                            logLevel;
-    char*                               logBuf;
+    char*                               logBuf;                         /* log line, valid until the callback returns */
     uint16_t                            logBufSize;
 } STUHFL_T_Log_Data;
 #define STUHFL_O_LOG_DATA_INIT(...) ((STUHFL_T_Log_Data) { .logIdx = 0, .logTickCountMs = {0,0}, .logLevel = 0, .logBuf = NULL, .logBufSize = 0, ##__VA_ARGS__ })
@@ -44,11 +44,72 @@ STUHFL_T_RET_CODE STUHFL_F_SetParam_Dispatcher(STUHFL_T_DEVICE_CTX device, STUHF
 STUHFL_T_RET_CODE STUHFL_F_GetParam_Dispatcher(STUHFL_T_DEVICE_CTX device, STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE value);
 
 uint8_t *STUHFL_F_Get_SndPayloadPtr(void);
+uint16_t STUHFL_F_Get_SndID(void);
+
+uint16_t STUHFL_F_Get_RcvID(void);
 
 uint16_t STUHFL_F_Get_RcvCmd(void);
 STUHFL_T_RET_CODE STUHFL_F_Get_RcvStatus(void);
 uint8_t *STUHFL_F_Get_RcvPayloadPtr(void);
 
+// segment of a frame sent with a single scatter-gather write
+typedef struct {
+    uint8_t                             *data;
+    uint16_t                            len;
+} STUHFL_T_IoVec;
+#define STUHFL_D_MAX_IOVEC                      4
+
+// platform operation handlers, registered on connect
+typedef STUHFL_T_RET_CODE(*STUHFL_T_Reset)(STUHFL_T_DEVICE_CTX *device, STUHFL_T_RESET resetType);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_Disconnect)(STUHFL_T_DEVICE_CTX *device);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_SndRaw)(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t dataLen);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_SndRawV)(STUHFL_T_DEVICE_CTX *device, const STUHFL_T_IoVec *iov, uint8_t iovCnt);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_RcvRaw)(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t *dataLen);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_RcvRawAvailable)(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t *dataLen);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_SetDTR)(STUHFL_T_DEVICE_CTX *device, uint8_t dtrValue);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_GetDTR)(STUHFL_T_DEVICE_CTX *device, uint8_t *dtrValue);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_SetRTS)(STUHFL_T_DEVICE_CTX *device, uint8_t rtsValue);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_GetRTS)(STUHFL_T_DEVICE_CTX *device, uint8_t *rtsValue);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_SetTimeouts)(STUHFL_T_DEVICE_CTX *device, uint32_t rdTimeout, uint32_t wrTimeout);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_GetTimeouts)(STUHFL_T_DEVICE_CTX *device, uint32_t *rdTimeout, uint32_t *wrTimeout);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_SetTxQueue)(STUHFL_T_DEVICE_CTX *device, uint8_t enable);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_GetTxQueue)(STUHFL_T_DEVICE_CTX *device, uint8_t *enable);
+typedef STUHFL_T_RET_CODE(*STUHFL_T_Connect)(STUHFL_T_DEVICE_CTX *device, char *port, uint32_t br);
+
+// transport backend, selected on connect by the prefix of the port name (e.g. "tcp://")
+typedef struct {
+    const char                          *prefix;                // port name prefix, stripped before connect is called
+    STUHFL_T_Connect                    connect;
+    STUHFL_T_Reset                      reset;
+    STUHFL_T_Disconnect                 disconnect;
+    STUHFL_T_SndRaw                     sndRaw;
+    STUHFL_T_SndRawV                    sndRawV;                // optional, frames are sent without copying into one buffer
+    STUHFL_T_RcvRaw                     rcvRaw;
+    STUHFL_T_RcvRawAvailable            rcvRawAvailable;        // optional, enables receive ring
+    STUHFL_T_SetDTR                     setDTR;                 // optional
+    STUHFL_T_GetDTR                     getDTR;                 // optional
+    STUHFL_T_SetRTS                     setRTS;                 // optional
+    STUHFL_T_GetRTS                     getRTS;                 // optional
+    STUHFL_T_SetTimeouts                setTimeouts;
+    STUHFL_T_GetTimeouts                getTimeouts;
+    STUHFL_T_SetTxQueue                 setTxQueue;             // optional
+    STUHFL_T_GetTxQueue                 getTxQueue;             // optional
+} STUHFL_T_Transport;
+
+#define STUHFL_D_MAX_TRANSPORTS                 8
+
+/**
+ * Register a transport backend. Port names starting with transport->prefix are connected with
+ * this backend, registered backends take precedence over the built-in ones ("tcp://" and "unix://"
+ * on POSIX), ports without known prefix are opened as serial port.
+ * Registering a prefix again replaces the previous backend, a NULL connect handler removes it.
+ * The registry is process wide and is not locked, register before connecting.
+ * @param transport: backend handlers, copied. The prefix string must stay valid.
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_RegisterTransport(const STUHFL_T_Transport *transport);
+
 
 
 //
@@ -128,11 +128,106 @@ typedef struct {
 
 typedef struct {
     STUHFL_T_Inventory_Statistics       statistics;         /**< O Param: Inventory statistics. */
-    STUHFL_T_Inventory_Tag              *tagList;           /**< O Param: Detected tags list. */
-    uint16_t                            tagListSize;        /**< O Param: Detected tags number. */
-    uint16_t                            tagListSizeMax;     /**< I Param: tagList size. Max number of tags to be stored during inventory. If more tags found, exceeding ones will overwrite last list entry. */
+    STUHFL_T_Inventory_Tag              *tagList;           /**< I/O Param: Detected tags list. Replaced by a larger list when grown by the inventory sink. */
+    uint32_t                            tagListSize;        /**< O Param: Detected tags number. */
+    uint32_t                            tagListSizeMax;     /**< I/O Param: tagList size. Max number of tags to be stored during inventory. If more tags found, the list is grown by the inventory sink, without sink the exceeding ones are counted in tagListDropped. */
+    uint32_t                            tagListSizeHighWater;   /**< O Param: Highest tagListSize reached since initialization. */
+    uint32_t                            tagListDropped;     /**< O Param: Number of tags not stored because tagList was full and could not be grown. */
 } STUHFL_T_Inventory_Data;
-#define STUHFL_O_INVENTORY_DATA_INIT(...) ((STUHFL_T_Inventory_Data) { .statistics = STUHFL_O_INVENTORY_STATISTICS_INIT(), .tagList = NULL, .tagListSize = 0, .tagListSizeMax = 0, ##__VA_ARGS__ })
+#define STUHFL_O_INVENTORY_DATA_INIT(...) ((STUHFL_T_Inventory_Data) { .statistics = STUHFL_O_INVENTORY_STATISTICS_INIT(), .tagList = NULL, .tagListSize = 0, .tagListSizeMax = 0, .tagListSizeHighWater = 0, .tagListDropped = 0, ##__VA_ARGS__ })
+
+/**
+ * Called when a received tag does not fit anymore into the tagList of the inventory data.
+ * The callee returns a list of newMax entries starting with the curMax entries of list,
+ * e.g. by realloc() of a heap list or by copying into a larger block of an arena.
+ * @param userCtx: pointer passed to STUHFL_F_SetInventorySink
+ * @param list: current tagList, may be NULL when tagListSizeMax is 0
+ * @param curMax: number of entries in list
+ * @param newMax: I/O: proposed number of entries, may be changed by the callee but must stay above curMax
+ *
+ * @return grown list, NULL when the list cannot grow. list stays in use in this case.
+*/
+typedef STUHFL_T_Inventory_Tag *(*STUHFL_T_InventoryGrow)(void *userCtx, STUHFL_T_Inventory_Tag *list, uint32_t curMax, uint32_t *newMax);
+
+//
+typedef struct {
+    const uint8_t                       *data;                          /**< O Param: Pointer into the receive buffer. Read only, valid during the callback only. */
+    uint16_t                            len;                            /**< O Param: length of data. */
+} STUHFL_T_Data_View;
+#define STUHFL_O_DATA_VIEW_INIT(...) ((STUHFL_T_Data_View) { .data = NULL, .len = 0, ##__VA_ARGS__ })
+
+//
+#define STUHFL_D_EPC_KEY_LEN                16U     // EPC bytes held exactly by an EPC key
+
+typedef struct {
+    uint64_t                            hi;                             /**< O Param: EPC bytes 0..7, first byte most significant. */
+    uint64_t                            lo;                             /**< O Param: EPC bytes 8..15, zero padded. For EPCs longer than STUHFL_D_EPC_KEY_LEN hash of bytes 8..len-1. */
+    uint8_t                             len;                            /**< O Param: EPC length. */
+} STUHFL_T_Epc_Key;
+#define STUHFL_O_EPC_KEY_INIT(...) ((STUHFL_T_Epc_Key) { .hi = 0, .lo = 0, .len = 0, ##__VA_ARGS__ })
+
+typedef struct {
+    uint32_t                            timestamp;                      /**< O Param: Tag detection time stamp. */
+    uint8_t                             antenna;                        /**< O Param: Antenna at which Tag was detected. */
+    uint8_t                             agc;                            /**< O Param: Tag AGC. */
+    uint8_t                             rssiLogI;                       /**< O Param: I part of Tag RSSI log. */
+    uint8_t                             rssiLogQ;                       /**< O Param: Q part of Tag RSSI log. */
+    int8_t                              rssiLinI;                       /**< O Param: Tag RSSI I level. */
+    int8_t                              rssiLinQ;                       /**< O Param: Tag RSSI Q level. */
+    uint8_t                             pc[MAX_PC_LENGTH];              /**< O Param: Tag PC. */
+    STUHFL_T_Data_View                  xpc;                            /**< O Param: Tag XPC. */
+    STUHFL_T_Data_View                  epc;                            /**< O Param: Tag EPC. */
+    STUHFL_T_Data_View                  tid;                            /**< O Param: Tag TID. */
+    STUHFL_T_Epc_Key                    epcKey;                         /**< O Param: Tag EPC as compact key. */
+} STUHFL_T_Inventory_Tag_View;
+#define STUHFL_O_INVENTORY_TAG_VIEW_INIT(...) ((STUHFL_T_Inventory_Tag_View) { .timestamp = 0, \
+                                                                .antenna = ANTENNA_1, .agc = 0, .rssiLogI = 0, .rssiLogQ = 0, .rssiLinI = 0, .rssiLinQ = 0, \
+                                                                .pc = {0}, \
+                                                                .xpc = STUHFL_O_DATA_VIEW_INIT(), \
+                                                                .epc = STUHFL_O_DATA_VIEW_INIT(), \
+                                                                .tid = STUHFL_O_DATA_VIEW_INIT(), \
+                                                                .epcKey = STUHFL_O_EPC_KEY_INIT(), \
+                                                                ##__VA_ARGS__ })
+
+/**
+ * Called for every tag of a received inventory frame. The views point directly into the receive buffer,
+ * data must be copied by the callee if needed after the callback returned.
+ * Returning an error stops the decoding of the remaining frame.
+*/
+typedef STUHFL_T_RET_CODE(*STUHFL_T_InventoryTagView)(void *userCtx, const STUHFL_T_Inventory_Tag_View *tag);
+
+/**
+ * Called for every inventory statistics contained in a received inventory frame, as soon as it is decoded.
+ * Returning an error stops the decoding of the remaining frame.
+*/
+typedef STUHFL_T_RET_CODE(*STUHFL_T_InventoryStatisticsView)(void *userCtx, const STUHFL_T_Inventory_Statistics *statistics);
+
+//
+#define STUHFL_D_TAG_BATCH_ALIGN            64      // alignment of columns allocated by STUHFL_F_AllocTagBatch
+
+typedef struct {
+    uint32_t                            *timestamp;                     /**< O Param: Column of tag detection time stamps. */
+    uint8_t                             *antenna;                       /**< O Param: Column of antennas at which tags were detected. */
+    uint8_t                             *agc;                           /**< O Param: Column of tag AGCs. */
+    uint8_t                             *rssiLogI;                      /**< O Param: Column of I parts of tag RSSI log. */
+    uint8_t                             *rssiLogQ;                      /**< O Param: Column of Q parts of tag RSSI log. */
+    int8_t                              *rssiLinI;                      /**< O Param: Column of tag RSSI I levels. */
+    int8_t                              *rssiLinQ;                      /**< O Param: Column of tag RSSI Q levels. */
+    uint8_t                             *epcLen;                        /**< O Param: Column of EPC lengths. */
+    uint32_t                            *epcOffset;                     /**< O Param: tagCntMax + 1 entries. EPC of tag i is found at epcData[epcOffset[i]] */
+    uint8_t                             *epcData;                       /**< O Param: EPCs of all tags packed without gaps. */
+    uint32_t                            tagCnt;                         /**< O Param: Number of tags in the batch. */
+    uint32_t                            tagCntMax;                      /**< I Param: Number of entries of each column. */
+    uint32_t                            epcDataSize;                    /**< O Param: Used bytes of epcData. */
+    uint32_t                            epcDataSizeMax;                 /**< I Param: Size of epcData. */
+    uint32_t                            dropped;                        /**< O Param: Number of tags not stored because the batch was full. */
+    void                                *block;                         /**< Memory of the columns when allocated by STUHFL_F_AllocTagBatch, NULL for caller provided columns. */
+} STUHFL_T_Inventory_Tag_Batch;
+#define STUHFL_O_INVENTORY_TAG_BATCH_INIT(...) ((STUHFL_T_Inventory_Tag_Batch) { .timestamp = NULL, .antenna = NULL, .agc = NULL, \
+                                                                .rssiLogI = NULL, .rssiLogQ = NULL, .rssiLinI = NULL, .rssiLinQ = NULL, \
+                                                                .epcLen = NULL, .epcOffset = NULL, .epcData = NULL, \
+                                                                .tagCnt = 0, .tagCntMax = 0, .epcDataSize = 0, .epcDataSizeMax = 0, .dropped = 0, .block = NULL, \
+                                                                ##__VA_ARGS__ })
 
 // --------------------------------------------------------------------------
 // Tags events
@@ -167,6 +262,8 @@ typedef struct {
     STUHFL_T_Inventory_Slot_Info_Sync   slotSync;                                           /**< O Param: */
     STUHFL_T_Inventory_Slot_Info        slotInfoList[INVENTORYREPORT_SLOT_INFO_LIST_SIZE];  /**< O Param: */
     uint16_t                            slotInfoListSize;                                   /**< O Param: */
+    uint16_t                            slotInfoListSizeHighWater;                          /**< O Param: Highest slotInfoListSize reached since initialization. */
+    uint32_t                            slotInfoDropped;                                    /**< O Param: Number of slot infos not stored because slotInfoList was full. */
 } STUHFL_T_Inventory_Slot_Info_Data;
 
 typedef struct {
@@ -218,6 +315,42 @@ typedef struct {
 
 #pragma pack(pop)
 
+// --------------------------------------------------------------------------
+/**
+ * Build the compact key of an EPC. EPCs up to STUHFL_D_EPC_KEY_LEN bytes (96 and 128 bit) are held exactly,
+ * for longer EPCs the bytes beyond the first 8 are hashed and two keys may match for different EPCs.
+ * @param *key: key to be built
+ * @param *epc: EPC data
+ * @param len: EPC length
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_EpcKeyFromBytes(STUHFL_T_Epc_Key *key, const uint8_t *epc, uint8_t len);
+/**
+ * Hash of an EPC key, e.g. to index a hash table of seen tags
+ * @param *key: EPC key
+ *
+ * @return hash value
+*/
+STUHFL_DLL_API uint64_t CALL_CONV STUHFL_F_EpcKeyHash(const STUHFL_T_Epc_Key *key);
+/**
+ * Compare two EPC keys. Exact keys of same length are ordered like their EPC bytes.
+ * @param *a: first EPC key
+ * @param *b: second EPC key
+ *
+ * @return <0, 0, >0 when a is less than, equal to, greater than b
+*/
+STUHFL_DLL_API int CALL_CONV STUHFL_F_EpcKeyCompare(const STUHFL_T_Epc_Key *a, const STUHFL_T_Epc_Key *b);
+/**
+ * Convert an EPC key to a zero terminated hex string
+ * @param *key: EPC key, must be up to STUHFL_D_EPC_KEY_LEN bytes
+ * @param *hex: buffer receiving the string
+ * @param hexSize: size of hex, at least 2 * key->len + 1
+ *
+ * @return error code
+*/
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_EpcKeyToHex(const STUHFL_T_Epc_Key *key, char *hex, uint16_t hexSize);
+
 #ifdef __cplusplus
 }
 #endif //__cplusplus
@@ -47,17 +47,23 @@
 #include <sys/wait.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <errno.h>
+#include <poll.h>
 
 #include "stuhfl_dl.h"
 #include "stuhfl_bl_posix.h"
+#include "stuhfl_ctx.h"
 #include "stuhfl_err.h"
 #include "stuhfl_log.h"
+#include "stuhfl_platform.h"
 
-static STUHFL_T_ParamTypeConnectionRdTimeout rdComTimeout = 2000;
-static STUHFL_T_ParamTypeConnectionWrTimeout wrComTimeout = 1000;
+#define MS_TO_TENTHS_OF_SEC(ms)     (((ms) + 99) / 100)
 
-struct termios oldtio = { 0 };
+static STUHFL_T_RET_CODE writeWithTimeout(int fd, const uint8_t *data, uint32_t dataLen, uint32_t *written, uint32_t timeout);
+static STUHFL_T_RET_CODE writevWithTimeout(int fd, const STUHFL_T_IoVec *iov, uint8_t iovCnt, uint32_t timeout);
+static STUHFL_T_RET_CODE flushTxQueue(int fd, uint32_t timeout);
+static STUHFL_T_RET_CODE rcvRaw(int fd, uint8_t *data, uint16_t *dataLen, bool waitAll);
 
 #define TRACE_BL_START()        { STUHFL_F_LogClear(LOG_LEVEL_TRACE_BL); }
 #define TRACE_BL(...)           { STUHFL_F_LogAppend(LOG_LEVEL_TRACE_BL, __VA_ARGS__); STUHFL_F_LogFlush(LOG_LEVEL_TRACE_BL); }
@@ -65,20 +71,22 @@ struct termios oldtio = { 0 };
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_Connect_Posix(STUHFL_T_DEVICE_CTX *device, char* port, uint32_t br)
 {
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
     HANDLE h;
     struct termios newtio = { 0 };
     STUHFL_T_RET_CODE ret = ERR_GENERIC;
 
-    h = open(port, O_RDWR | O_NOCTTY);
+    // non blocking, all waits are done with poll() and are limited by the configured timeouts
+    h = open(port, O_RDWR | O_NOCTTY | O_NONBLOCK);
 
     // Return error if invalid handle
-    if (h == INVALID_HANDLE_VALUE) {
+    if (h < 0) {
         return (ret = ERR_IO);
     }
 
     // save current settings ..
-    tcgetattr((int)h, &oldtio);
-    newtio = oldtio;
+    tcgetattr((int)h, &bl->oldtio);
+    newtio = bl->oldtio;
 
     // IO Speed
     speed_t ioSpeed = (speed_t)B115200;
@@ -117,6 +125,7 @@ STUHFL_T_RET_CODE STUHFL_F_Connect_Posix(STUHFL_T_DEVICE_CTX *device, char* port
 
     // apply settings to terminal
     tcflush(h, TCIOFLUSH);
+    bl->txQueueLen = 0;
     if (0 != tcsetattr((int)h, TCSANOW, &newtio)) {
         return (ret = ERR_IO);
     }
@@ -129,9 +138,11 @@ STUHFL_T_RET_CODE STUHFL_F_Connect_Posix(STUHFL_T_DEVICE_CTX *device, char* port
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_Reset_Posix(STUHFL_T_DEVICE_CTX *device, STUHFL_T_RESET resetType)
 {
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
     if (resetType == STUHFL_RESET_TYPE_CLEAR_COMM) {
         // Abort all outstandig r/w operations and clear buffers
         tcflush((int)*device, TCIOFLUSH);
+        bl->txQueueLen = 0;
         return ERR_NONE;
     }
     return ERR_PARAM;
@@ -140,11 +151,16 @@ STUHFL_T_RET_CODE STUHFL_F_Reset_Posix(STUHFL_T_DEVICE_CTX *device, STUHFL_T_RES
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_Disconnect_Posix(STUHFL_T_DEVICE_CTX *device)
 {
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
     //
     if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
         return ERR_PARAM;
     }
-    tcsetattr((int)device, TCSANOW, &oldtio);
+    // hand over pending frames before closing
+    flushTxQueue((int)*device, bl->wrComTimeout);
+    bl->txQueueLen = 0;
+
+    tcsetattr((int)*device, TCSANOW, &bl->oldtio);
     close((int)*device);
     *device = NULL;
     return ERR_NONE;
@@ -153,31 +169,63 @@ STUHFL_T_RET_CODE STUHFL_F_Disconnect_Posix(STUHFL_T_DEVICE_CTX *device)
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_SndRaw_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t dataLen)
 {
+    STUHFL_T_IoVec iov = { .data = data, .len = dataLen };
+    return STUHFL_F_SndRawV_Posix(device, &iov, 1);
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_SndRawV_Posix(STUHFL_T_DEVICE_CTX *device, const STUHFL_T_IoVec *iov, uint8_t iovCnt)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
     //
     if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
         return ERR_PARAM;
     }
+    if (iovCnt > STUHFL_D_MAX_IOVEC) {
+        return ERR_PARAM;
+    }
 
-    //
-    STUHFL_T_RET_CODE ret = STUHFL_F_Reset_Posix(device, STUHFL_RESET_TYPE_CLEAR_COMM);
-    if (ret != ERR_NONE) {
-        return ret;
+    // NOTE: RX data is not flushed here, pending replies and runner data stay available.
+    // Resynchronization is done explicitly with STUHFL_RESET_TYPE_CLEAR_COMM
+    int fd = (int)*device;
+    STUHFL_T_RET_CODE ret = ERR_NONE;
+
+    if (!bl->txQueueEnabled) {
+        return writevWithTimeout(fd, iov, iovCnt, bl->wrComTimeout);
     }
 
-    //
-    ssize_t     dwWritten = 0;
-    bool        success = false;
+    uint32_t dataLen = 0;
+    for (uint8_t i = 0; i < iovCnt; i++) {
+        dataLen += iov[i].len;
+    }
 
-    // write operation completed successfully.
-    dwWritten = write((int)*device, data, dataLen);
-    if (dataLen == dwWritten) {
-        success = true;
+    // frame does not fit even into the empty queue, send it directly after the queued ones
+    if (dataLen > TX_QUEUE_SIZE) {
+        ret = flushTxQueue(fd, bl->wrComTimeout);
+        if (ret != ERR_NONE) {
+            return (ret == ERR_TIMEOUT) ? ERR_BUSY : ret;
+        }
+        return writevWithTimeout(fd, iov, iovCnt, bl->wrComTimeout);
     }
 
-    if (!success) {
-        ret = ERR_IO;
+    // queue frame, wait only when queue has no more room for it
+    if ((bl->txQueueLen + dataLen) > TX_QUEUE_SIZE) {
+        ret = flushTxQueue(fd, bl->wrComTimeout);
+        if ((ret == ERR_TIMEOUT) && ((bl->txQueueLen + dataLen) > TX_QUEUE_SIZE)) {
+            return ERR_BUSY;
+        }
+        if ((ret != ERR_NONE) && (ret != ERR_TIMEOUT)) {
+            return ret;
+        }
     }
-    return ret;
+    for (uint8_t i = 0; i < iovCnt; i++) {
+        memcpy(&bl->txQueue[bl->txQueueLen], iov[i].data, iov[i].len);
+        bl->txQueueLen += iov[i].len;
+    }
+
+    // transmit as much as the port accepts right now
+    ret = flushTxQueue(fd, 0);
+    return (ret == ERR_TIMEOUT) ? ERR_NONE : ret;
 }
 
 // --------------------------------------------------------------------------
@@ -187,39 +235,17 @@ STUHFL_T_RET_CODE STUHFL_F_RcvRaw_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *da
     if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
         return ERR_PARAM;
     }
+    return rcvRaw((int)*device, data, dataLen, true);
+}
 
-    bool            success = false;
-    ssize_t         dwBytesRead = 0;
-    uint32_t        nNumberOfBytesToRead = *dataLen;
-
-    // clear upfront
-    *dataLen = 0;
-
-    //
-    int nBytesAvailable = 0;
-    STUHFL_T_ParamTypeConnectionRdTimeout timeout = rdComTimeout * 10;
-    // check if data is available
-    while (((--timeout) > 0) && (nBytesAvailable < nNumberOfBytesToRead)) {
-        ioctl((int)*device, FIONREAD, &nBytesAvailable);
-        usleep(100);
-    }
-    // last try before return ..
-    if (timeout == 0) {
-        ioctl((int)*device, FIONREAD, &nBytesAvailable);
-        if (nBytesAvailable < nNumberOfBytesToRead) {
-            return ERR_IO;
-        }
-    }
-    // finally read available data
-    dwBytesRead = read((int)*device, data, nNumberOfBytesToRead);
-
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_RcvRawAvailable_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t *dataLen)
+{
     //
-    *dataLen = (uint16_t)dwBytesRead;
-    if (nNumberOfBytesToRead == dwBytesRead) {
-        success = true;
+    if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
+        return ERR_PARAM;
     }
-
-    return success ? ERR_NONE : (STUHFL_T_RET_CODE)errno;
+    return rcvRaw((int)*device, data, dataLen, false);
 }
 
 // --------------------------------------------------------------------------
@@ -307,45 +333,251 @@ STUHFL_T_RET_CODE STUHFL_F_GetRTS_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *rt
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_SetTimeouts_Posix(STUHFL_T_DEVICE_CTX *device, uint32_t rdTimeout, uint32_t wrTimeout)
 {
-    ////
-    //if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
-    //    return ERR_PARAM;
-    //}
-
-    //// convert ms to tenth of seconds
-    //rdTimeout = MS_TO_TENTHS_OF_SEC(rdTimeout);
-    //wrTimeout = MS_TO_TENTHS_OF_SEC(wrTimeout);
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    //
+    if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
+        return ERR_PARAM;
+    }
 
-    //struct termios  tio;
-    //tcgetattr((int)*device, &tio);
+    // The receive path waits with poll() until rdTimeout elapsed, the termios
+    // inter-character timer only applies to blocking reads of the port and is
+    // clamped to its maximum of 25.5 sec
+    uint32_t vtime = MS_TO_TENTHS_OF_SEC(rdTimeout);
+    if (vtime > 0xFF) {
+        vtime = 0xFF;
+    }
 
-    //// TimeOut
-    //tio.c_cc[VMIN] = 0;
-    //tio.c_cc[VTIME] = (cc_t)rdTimeout;
+    struct termios  tio;
+    if (0 != tcgetattr((int)*device, &tio)) {
+        return ERR_IO;
+    }
 
+    // TimeOut
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = (cc_t)vtime;
 
-    //tcflush((int)*device, TCIFLUSH);
-    //if (0 != tcsetattr((int)*device, TCSANOW, &tio)) {
-    //    return ERR_IO;
-    //}
+    if (0 != tcsetattr((int)*device, TCSANOW, &tio)) {
+        return ERR_IO;
+    }
 
-    rdComTimeout = rdTimeout;
-    wrComTimeout = wrTimeout;
+    bl->rdComTimeout = rdTimeout;
+    bl->wrComTimeout = wrTimeout;
     return ERR_NONE;
 }
 
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_GetTimeouts_Posix(STUHFL_T_DEVICE_CTX *device, uint32_t *rdTimeout, uint32_t *wrTimeout)
 {
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    (void)device;
     //// convert reply to ms
-    //*rdTimeout = TENTHS_OF_SEC_TO_MS(rdComTimeout);
-    //*wrTimeout = TENTHS_OF_SEC_TO_MS(wrComTimeout);
+    //*rdTimeout = TENTHS_OF_SEC_TO_MS(bl->rdComTimeout);
+    //*wrTimeout = TENTHS_OF_SEC_TO_MS(bl->wrComTimeout);
 
-    *rdTimeout = rdComTimeout;
-    *wrTimeout = wrComTimeout;
+    *rdTimeout = bl->rdComTimeout;
+    *wrTimeout = bl->wrComTimeout;
     return ERR_NONE;
 }
 
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_SetTxQueue_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t enable)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    //
+    if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
+        return ERR_PARAM;
+    }
+
+    // when disabling, pending frames must be transmitted first
+    if (!enable && (bl->txQueueLen > 0)) {
+        STUHFL_T_RET_CODE ret = flushTxQueue((int)*device, bl->wrComTimeout);
+        if (ret != ERR_NONE) {
+            return ret;
+        }
+    }
+    bl->txQueueEnabled = enable ? true : false;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_GetTxQueue_Posix(STUHFL_T_DEVICE_CTX *device, uint8_t *enable)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    (void)device;
+    *enable = bl->txQueueEnabled ? 1 : 0;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE rcvRaw(int fd, uint8_t *data, uint16_t *dataLen, bool waitAll)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    STUHFL_T_RET_CODE   ret = ERR_NONE;
+    uint16_t            nNumberOfBytesToRead = *dataLen;
+    uint16_t            nBytesRead = 0;
+    uint32_t            startTime = getMilliCount();
+    struct pollfd       pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
+
+    // clear upfront
+    *dataLen = 0;
+
+    // read until all requested bytes (or with !waitAll any bytes) are received or the read timeout elapsed
+    while (nBytesRead < nNumberOfBytesToRead) {
+        // read whatever is available, but never more than requested
+        ssize_t dwBytesRead = read(fd, &data[nBytesRead], (size_t)(nNumberOfBytesToRead - nBytesRead));
+        if (dwBytesRead > 0) {
+            nBytesRead = (uint16_t)(nBytesRead + (uint16_t)dwBytesRead);
+            if (!waitAll) {
+                break;
+            }
+            continue;
+        }
+        if ((dwBytesRead < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+            ret = ERR_IO;
+            break;
+        }
+
+        // nothing available, wait for data
+        uint32_t elapsed = getMilliSpan(startTime);
+        int remaining = (elapsed < bl->rdComTimeout) ? (int)(bl->rdComTimeout - elapsed) : 0;
+
+        // keep draining the transmit queue while waiting for data
+        pfd.events = (short)(POLLIN | ((bl->txQueueLen > 0) ? POLLOUT : 0));
+        pfd.revents = 0;
+
+        int n = poll(&pfd, 1, remaining);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ret = ERR_IO;
+            break;
+        }
+        if (n == 0) {
+            // deadline reached
+            ret = ERR_TIMEOUT;
+            break;
+        }
+        if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            ret = ERR_IO;
+            break;
+        }
+        if (pfd.revents & POLLOUT) {
+            ret = flushTxQueue(fd, 0);
+            if ((ret != ERR_NONE) && (ret != ERR_TIMEOUT)) {
+                break;
+            }
+            ret = ERR_NONE;
+        }
+    }
+
+    *dataLen = nBytesRead;
+    return ret;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE writeWithTimeout(int fd, const uint8_t *data, uint32_t dataLen, uint32_t *written, uint32_t timeout)
+{
+    uint32_t startTime = getMilliCount();
+    struct pollfd pfd = { .fd = fd, .events = POLLOUT, .revents = 0 };
+
+    *written = 0;
+    while (*written < dataLen) {
+        // try first, the port usually accepts the data right away
+        ssize_t n = write(fd, &data[*written], (size_t)(dataLen - *written));
+        if (n > 0) {
+            *written += (uint32_t)n;
+            continue;
+        }
+        if ((n < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+            return ERR_IO;
+        }
+
+        // wait until the port can take more data
+        uint32_t elapsed = getMilliSpan(startTime);
+        if (elapsed >= timeout) {
+            return ERR_TIMEOUT;
+        }
+        pfd.revents = 0;
+        int r = poll(&pfd, 1, (int)(timeout - elapsed));
+        if ((r < 0) && (errno != EINTR)) {
+            return ERR_IO;
+        }
+        if ((r > 0) && (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))) {
+            return ERR_IO;
+        }
+    }
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE writevWithTimeout(int fd, const STUHFL_T_IoVec *iov, uint8_t iovCnt, uint32_t timeout)
+{
+    uint32_t startTime = getMilliCount();
+    struct pollfd pfd = { .fd = fd, .events = POLLOUT, .revents = 0 };
+    struct iovec vec[STUHFL_D_MAX_IOVEC];
+    int cnt = 0;
+    int idx = 0;
+
+    for (uint8_t i = 0; i < iovCnt; i++) {
+        if (iov[i].len > 0) {
+            vec[cnt].iov_base = iov[i].data;
+            vec[cnt].iov_len = iov[i].len;
+            cnt++;
+        }
+    }
+
+    while (idx < cnt) {
+        // try first, the port usually accepts the whole frame right away
+        ssize_t n = writev(fd, &vec[idx], cnt - idx);
+        if (n > 0) {
+            // skip what was written, partially written segment is continued
+            while ((idx < cnt) && ((size_t)n >= vec[idx].iov_len)) {
+                n -= (ssize_t)vec[idx].iov_len;
+                idx++;
+            }
+            if (n > 0) {
+                vec[idx].iov_base = (uint8_t *)vec[idx].iov_base + n;
+                vec[idx].iov_len -= (size_t)n;
+            }
+            continue;
+        }
+        if ((n < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+            return ERR_IO;
+        }
+
+        // wait until the port can take more data
+        uint32_t elapsed = getMilliSpan(startTime);
+        if (elapsed >= timeout) {
+            return ERR_TIMEOUT;
+        }
+        pfd.revents = 0;
+        int r = poll(&pfd, 1, (int)(timeout - elapsed));
+        if ((r < 0) && (errno != EINTR)) {
+            return ERR_IO;
+        }
+        if ((r > 0) && (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))) {
+            return ERR_IO;
+        }
+    }
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE flushTxQueue(int fd, uint32_t timeout)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    uint32_t written = 0;
+    STUHFL_T_RET_CODE ret = writeWithTimeout(fd, bl->txQueue, bl->txQueueLen, &written, timeout);
+
+    // keep remaining data at the queue start
+    bl->txQueueLen -= written;
+    if ((bl->txQueueLen > 0) && (written > 0)) {
+        memmove(bl->txQueue, &bl->txQueue[written], bl->txQueueLen);
+    }
+    return ret;
+}
+
 #endif
 
 /**
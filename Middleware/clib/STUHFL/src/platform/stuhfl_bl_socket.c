@@ -0,0 +1,415 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+/** @file
+ *
+ *  @author ST Microelectronics
+ *
+ *  @brief 
+ *
+ */
+
+/** @addtogroup Application
+  * @{
+  */
+/** @addtogroup PC_Communication
+  * @{
+  */
+
+#if defined(POSIX)
+
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "stuhfl_dl.h"
+#include "stuhfl_bl_socket.h"
+#include "stuhfl_ctx.h"
+#include "stuhfl_err.h"
+#include "stuhfl_log.h"
+#include "stuhfl_platform.h"
+
+#define MAX_HOST_NAME_LEN       255
+#define SOCKET_FD(device)       ((int)(intptr_t)*(device))
+
+static STUHFL_T_RET_CODE connectSocket(STUHFL_T_DEVICE_CTX *device, int family, int protocol, const struct sockaddr *addr, socklen_t addrLen);
+static STUHFL_T_RET_CODE waitSocket(int fd, short events, uint32_t startTime, uint32_t timeout);
+static STUHFL_T_RET_CODE rcvSocket(int fd, uint8_t *data, uint16_t *dataLen, bool waitAll);
+
+#define TRACE_BL_START()        { STUHFL_F_LogClear(LOG_LEVEL_TRACE_BL); }
+#define TRACE_BL(...)           { STUHFL_F_LogAppend(LOG_LEVEL_TRACE_BL, __VA_ARGS__); STUHFL_F_LogFlush(LOG_LEVEL_TRACE_BL); }
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_Connect_Tcp(STUHFL_T_DEVICE_CTX *device, char* port, uint32_t br)
+{
+    char host[MAX_HOST_NAME_LEN + 1];
+    struct addrinfo hints = { 0 };
+    struct addrinfo *res = NULL;
+    STUHFL_T_RET_CODE ret = ERR_IO;
+
+    // baudrate is configured at the serial server, not on the TCP connection
+    (void)br;
+
+    // split "<host>:<service>", IPv6 hosts are given in brackets: "[::1]:2000"
+    const char *service = strrchr(port, ':');
+    if ((service == NULL) || (service == port) || (service[1] == 0)) {
+        return ERR_PARAM;
+    }
+    const char *hostStart = port;
+    size_t hostLen = (size_t)(service - port);
+    if ((hostLen >= 2) && (port[0] == '[') && (port[hostLen - 1] == ']')) {
+        hostStart++;
+        hostLen -= 2;
+    }
+    if (hostLen > MAX_HOST_NAME_LEN) {
+        return ERR_PARAM;
+    }
+    memcpy(host, hostStart, hostLen);
+    host[hostLen] = 0;
+    service++;
+
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, service, &hints, &res) != 0) {
+        return ERR_IO;
+    }
+
+    // take the first address that accepts the connection
+    for (struct addrinfo *ai = res; ai != NULL; ai = ai->ai_next) {
+        ret = connectSocket(device, ai->ai_family, ai->ai_protocol, ai->ai_addr, ai->ai_addrlen);
+        if (ret == ERR_NONE) {
+            // frames are small and latency bound, do not let them wait for coalescing
+            int on = 1;
+            setsockopt(SOCKET_FD(device), IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            break;
+        }
+    }
+    freeaddrinfo(res);
+
+    TRACE_BL_START();
+    TRACE_BL("STUHFL_F_Connect_Tcp(port = %s) = %d", port, ret);
+    return ret;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_Connect_Unix(STUHFL_T_DEVICE_CTX *device, char* port, uint32_t br)
+{
+    struct sockaddr_un addr = { 0 };
+
+    (void)br;
+
+    if (strlen(port) >= sizeof(addr.sun_path)) {
+        return ERR_PARAM;
+    }
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, port);
+
+    STUHFL_T_RET_CODE ret = connectSocket(device, AF_UNIX, 0, (const struct sockaddr *)&addr, (socklen_t)sizeof(addr));
+
+    TRACE_BL_START();
+    TRACE_BL("STUHFL_F_Connect_Unix(port = %s) = %d", port, ret);
+    return ret;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_Reset_Socket(STUHFL_T_DEVICE_CTX *device, STUHFL_T_RESET resetType)
+{
+    if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
+        return ERR_PARAM;
+    }
+    if (resetType == STUHFL_RESET_TYPE_CLEAR_COMM) {
+        // discard everything already received, there is no way to abort data in flight
+        uint8_t drain[256];
+        while (recv(SOCKET_FD(device), drain, sizeof(drain), MSG_DONTWAIT) > 0) {
+        }
+        return ERR_NONE;
+    }
+    return ERR_PARAM;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_Disconnect_Socket(STUHFL_T_DEVICE_CTX *device)
+{
+    //
+    if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
+        return ERR_PARAM;
+    }
+    close(SOCKET_FD(device));
+    *device = NULL;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_SndRaw_Socket(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t dataLen)
+{
+    STUHFL_T_IoVec iov = { .data = data, .len = dataLen };
+    return STUHFL_F_SndRawV_Socket(device, &iov, 1);
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_SndRawV_Socket(STUHFL_T_DEVICE_CTX *device, const STUHFL_T_IoVec *iov, uint8_t iovCnt)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    struct iovec vec[STUHFL_D_MAX_IOVEC];
+    struct msghdr msg = { 0 };
+    int cnt = 0;
+    //
+    if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
+        return ERR_PARAM;
+    }
+    if (iovCnt > STUHFL_D_MAX_IOVEC) {
+        return ERR_PARAM;
+    }
+    for (uint8_t i = 0; i < iovCnt; i++) {
+        if (iov[i].len > 0) {
+            vec[cnt].iov_base = iov[i].data;
+            vec[cnt].iov_len = iov[i].len;
+            cnt++;
+        }
+    }
+
+    int fd = SOCKET_FD(device);
+    uint32_t startTime = getMilliCount();
+    int idx = 0;
+
+    while (idx < cnt) {
+        // MSG_NOSIGNAL: a closed peer must show up as error, not as SIGPIPE
+        msg.msg_iov = &vec[idx];
+        msg.msg_iovlen = (size_t)(cnt - idx);
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n > 0) {
+            while ((idx < cnt) && ((size_t)n >= vec[idx].iov_len)) {
+                n -= (ssize_t)vec[idx].iov_len;
+                idx++;
+            }
+            if (n > 0) {
+                vec[idx].iov_base = (uint8_t *)vec[idx].iov_base + n;
+                vec[idx].iov_len -= (size_t)n;
+            }
+            continue;
+        }
+        if ((n < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+            return ERR_IO;
+        }
+        STUHFL_T_RET_CODE ret = waitSocket(fd, POLLOUT, startTime, bl->wrComTimeout);
+        if (ret != ERR_NONE) {
+            return ret;
+        }
+    }
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_RcvRaw_Socket(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t *dataLen)
+{
+    //
+    if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
+        return ERR_PARAM;
+    }
+    return rcvSocket(SOCKET_FD(device), data, dataLen, true);
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_RcvRawAvailable_Socket(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t *dataLen)
+{
+    //
+    if ((*device == (void*)INVALID_HANDLE_VALUE) || (*device == NULL)) {
+        return ERR_PARAM;
+    }
+    return rcvSocket(SOCKET_FD(device), data, dataLen, false);
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_SetDTR_Socket(STUHFL_T_DEVICE_CTX *device, uint8_t dtrValue)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    (void)device;
+    bl->sockDtr = dtrValue;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_GetDTR_Socket(STUHFL_T_DEVICE_CTX *device, uint8_t *dtrValue)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    (void)device;
+    *dtrValue = bl->sockDtr;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_SetRTS_Socket(STUHFL_T_DEVICE_CTX *device, uint8_t rtsValue)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    (void)device;
+    bl->sockRts = rtsValue;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_GetRTS_Socket(STUHFL_T_DEVICE_CTX *device, uint8_t *rtsValue)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    (void)device;
+    *rtsValue = bl->sockRts;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_SetTimeouts_Socket(STUHFL_T_DEVICE_CTX *device, uint32_t rdTimeout, uint32_t wrTimeout)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    (void)device;
+    // all waits are done with poll(), no socket options involved
+    bl->rdComTimeout = rdTimeout;
+    bl->wrComTimeout = wrTimeout;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_GetTimeouts_Socket(STUHFL_T_DEVICE_CTX *device, uint32_t *rdTimeout, uint32_t *wrTimeout)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    (void)device;
+    *rdTimeout = bl->rdComTimeout;
+    *wrTimeout = bl->wrComTimeout;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE connectSocket(STUHFL_T_DEVICE_CTX *device, int family, int protocol, const struct sockaddr *addr, socklen_t addrLen)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    int fd = socket(family, SOCK_STREAM | SOCK_CLOEXEC, protocol);
+    if (fd < 0) {
+        return ERR_IO;
+    }
+
+    // non blocking, the connect itself is limited by the read timeout
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    if (connect(fd, addr, addrLen) != 0) {
+        if ((errno != EINPROGRESS) && (errno != EAGAIN)) {
+            close(fd);
+            return ERR_IO;
+        }
+        STUHFL_T_RET_CODE ret = waitSocket(fd, POLLOUT, getMilliCount(), bl->rdComTimeout);
+        int err = 0;
+        socklen_t errLen = sizeof(err);
+        if ((ret == ERR_NONE) && ((getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &errLen) != 0) || (err != 0))) {
+            ret = ERR_IO;
+        }
+        if (ret != ERR_NONE) {
+            close(fd);
+            return ret;
+        }
+    }
+
+    bl->sockDtr = 0;
+    bl->sockRts = 0;
+    *device = (STUHFL_T_DEVICE_CTX)(intptr_t)fd;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE rcvSocket(int fd, uint8_t *data, uint16_t *dataLen, bool waitAll)
+{
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    STUHFL_T_RET_CODE ret = ERR_NONE;
+    uint16_t toRead = *dataLen;
+    uint16_t nRead = 0;
+    uint32_t startTime = getMilliCount();
+
+    *dataLen = 0;
+    while (nRead < toRead) {
+        ssize_t n = recv(fd, &data[nRead], (size_t)(toRead - nRead), 0);
+        if (n > 0) {
+            nRead = (uint16_t)(nRead + (uint16_t)n);
+            if (!waitAll) {
+                break;
+            }
+            continue;
+        }
+        if (n == 0) {
+            // peer closed the connection
+            ret = ERR_IO;
+            break;
+        }
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+            ret = ERR_IO;
+            break;
+        }
+        ret = waitSocket(fd, POLLIN, startTime, bl->rdComTimeout);
+        if (ret != ERR_NONE) {
+            break;
+        }
+    }
+    *dataLen = nRead;
+    return ret;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE waitSocket(int fd, short events, uint32_t startTime, uint32_t timeout)
+{
+    struct pollfd pfd = { .fd = fd, .events = events, .revents = 0 };
+
+    for (;;) {
+        uint32_t elapsed = getMilliSpan(startTime);
+        if (elapsed >= timeout) {
+            return ERR_TIMEOUT;
+        }
+        pfd.revents = 0;
+        int n = poll(&pfd, 1, (int)(timeout - elapsed));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ERR_IO;
+        }
+        if (n == 0) {
+            return ERR_TIMEOUT;
+        }
+        // POLLHUP with pending data is still readable, let recv() report the close
+        if (pfd.revents & (POLLERR | POLLNVAL)) {
+            return ERR_IO;
+        }
+        return ERR_NONE;
+    }
+}
+
+#endif
+
+/**
+  * @}
+  */
+/**
+  * @}
+  */
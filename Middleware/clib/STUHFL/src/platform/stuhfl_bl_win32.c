@@ -40,14 +40,14 @@
 
 #include "stuhfl_dl.h"
 #include "stuhfl_bl_win32.h"
+#include "stuhfl_ctx.h"
 #include "stuhfl_err.h"
 
-static STUHFL_T_ParamTypeConnectionRdTimeout rdComTimeout = 4000;
-static STUHFL_T_ParamTypeConnectionWrTimeout wrComTimeout = 1000;
 
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_Connect_Win32(STUHFL_T_DEVICE_CTX *device, char* port, uint32_t br)
 {
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
     HANDLE h;
     DCB dcb;
 
@@ -111,12 +111,12 @@ STUHFL_T_RET_CODE STUHFL_F_Connect_Win32(STUHFL_T_DEVICE_CTX *device, char* port
         return ERR_IO;
     }
     // define ReadTimeOuts
-    ct.ReadTotalTimeoutConstant = rdComTimeout;
+    ct.ReadTotalTimeoutConstant = bl->rdComTimeout;
     ct.ReadTotalTimeoutMultiplier = 0;
     ct.ReadIntervalTimeout = 0;
     // define WriteTimeOuts
     ct.WriteTotalTimeoutMultiplier = 0;
-    ct.WriteTotalTimeoutConstant = wrComTimeout;
+    ct.WriteTotalTimeoutConstant = bl->wrComTimeout;
     //set Timeouts
     if (!SetCommTimeouts(h, &ct)) {
         return ERR_IO;
@@ -188,6 +188,7 @@ STUHFL_T_RET_CODE STUHFL_F_SndRaw_Win32(STUHFL_T_DEVICE_CTX *device, uint8_t *da
     bool        success = false;
 
 #if 0
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
     // Asynchron Write operation. NOTE: Use FILE_FLAG_OVERLAPPED with create handle when using this
     OVERLAPPED  osWrite = { 0 };
     // Create this write operation's OVERLAPPED structure's hEvent.
@@ -201,7 +202,7 @@ STUHFL_T_RET_CODE STUHFL_F_SndRaw_Win32(STUHFL_T_DEVICE_CTX *device, uint8_t *da
                 // WriteFile failed, but isn't delayed. Report error and abort.
             } else {
                 // write is pending.
-                switch (WaitForSingleObject(osWrite.hEvent, wrComTimeout)) {
+                switch (WaitForSingleObject(osWrite.hEvent, bl->wrComTimeout)) {
                 // OVERLAPPED structure's event has been signaled.
                 case WAIT_OBJECT_0:
                     if (GetOverlappedResult(*device, &osWrite, &dwWritten, FALSE)) {
@@ -251,6 +252,7 @@ STUHFL_T_RET_CODE STUHFL_F_RcvRaw_Win32(STUHFL_T_DEVICE_CTX *device, uint8_t *da
     }
 
 #if 0
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
     // Asynchron Read operation. NOTE: Use FILE_FLAG_OVERLAPPED with create handle when using this
     OVERLAPPED      osReader = { 0 };
     // Create the overlapped event. Must be closed before exiting
@@ -268,7 +270,7 @@ STUHFL_T_RET_CODE STUHFL_F_RcvRaw_Win32(STUHFL_T_DEVICE_CTX *device, uint8_t *da
                 // Error in communications; report it.
             } else {
                 // wait for completion of read
-                switch (WaitForSingleObject(osReader.hEvent, rdComTimeout)) {
+                switch (WaitForSingleObject(osReader.hEvent, bl->rdComTimeout)) {
                 // Read completed.
                 case WAIT_OBJECT_0:
                     if (!GetOverlappedResult(*device, &osReader, &dwBytesRead, FALSE)) {
@@ -372,6 +374,7 @@ STUHFL_T_RET_CODE STUHFL_F_GetRTS_Win32(STUHFL_T_DEVICE_CTX *device, uint8_t *rt
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_SetTimeouts_Win32(STUHFL_T_DEVICE_CTX *device, uint32_t rdTimeout, uint32_t wrTimeout)
 {
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
     //
     if ((*device == INVALID_HANDLE_VALUE) || (*device == NULL)) {
         return ERR_PARAM;
@@ -392,8 +395,8 @@ STUHFL_T_RET_CODE STUHFL_F_SetTimeouts_Win32(STUHFL_T_DEVICE_CTX *device, uint32
         return ERR_IO;
     }
 
-    rdComTimeout = rdTimeout;
-    wrComTimeout = wrTimeout;
+    bl->rdComTimeout = rdTimeout;
+    bl->wrComTimeout = wrTimeout;
 
     return ERR_NONE;
 }
@@ -401,8 +404,9 @@ STUHFL_T_RET_CODE STUHFL_F_SetTimeouts_Win32(STUHFL_T_DEVICE_CTX *device, uint32
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_GetTimeouts_Win32(STUHFL_T_DEVICE_CTX *device, uint32_t *rdTimeout, uint32_t *wrTimeout)
 {
-    *rdTimeout = rdComTimeout;
-    *wrTimeout = wrComTimeout;
+    STUHFL_T_BL_Ctx *bl = &STUHFL_F_CurReaderCtx()->bl;
+    *rdTimeout = bl->rdComTimeout;
+    *wrTimeout = bl->wrComTimeout;
     return ERR_NONE;
 }
 
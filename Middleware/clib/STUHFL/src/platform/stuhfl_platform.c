@@ -57,14 +57,65 @@ STUHFL_DLL_API uint32_t CALL_CONV getMilliCount()
     return GetTickCount();
 }
 
+STUHFL_DLL_API uint32_t CALL_CONV getMicroCount()
+{
+    LARGE_INTEGER count;
+    LARGE_INTEGER freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    // split, so that the scaling does not overflow
+    return (uint32_t)(((count.QuadPart / freq.QuadPart) * 1000000) + (((count.QuadPart % freq.QuadPart) * 1000000) / freq.QuadPart));
+}
+
+void STUHFL_F_CondInit(STUHFL_T_Cond *cond)
+{
+    InitializeConditionVariable(cond);
+}
+
+bool STUHFL_F_CondWait(STUHFL_T_Cond *cond, STUHFL_T_Mutex *mutex, uint32_t timeout)
+{
+    return SleepConditionVariableSRW(cond, mutex, timeout, 0) ? true : false;
+}
+
 // - POSIX ------------------------------------------------------------------
 #elif defined(POSIX)
 
 STUHFL_DLL_API uint32_t CALL_CONV getMilliCount()
 {
-    struct timeval time;
-    gettimeofday(&time, NULL);
-    return (uint32_t)((time.tv_sec * 1000) + (time.tv_usec / 1000));
+    // monotonic clock, so that timeouts are not affected by wall clock adjustments
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint32_t)((time.tv_sec * 1000) + (time.tv_nsec / 1000000));
+}
+
+STUHFL_DLL_API uint32_t CALL_CONV getMicroCount()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint32_t)((time.tv_sec * 1000000) + (time.tv_nsec / 1000));
+}
+
+void STUHFL_F_CondInit(STUHFL_T_Cond *cond)
+{
+    // same clock as getMilliCount, so that wall clock adjustments do not stretch or cut the wait
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+bool STUHFL_F_CondWait(STUHFL_T_Cond *cond, STUHFL_T_Mutex *mutex, uint32_t timeout)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return pthread_cond_timedwait(cond, mutex, &deadline) == 0;
 }
 
 // - OTHER PLATFORMS --------------------------------------------------------
@@ -75,14 +126,13 @@ STUHFL_DLL_API uint32_t CALL_CONV getMilliCount()
 
 STUHFL_DLL_API uint32_t CALL_CONV getMilliSpan(uint32_t firstTime)
 {
-    uint32_t m = getMilliCount();
-    uint32_t span = 0;
-    if (m > firstTime) {
-        span = m - firstTime;
-    } else {
-        span = (0xFFFFFFFF - firstTime) + m;
-    }
-    return span;
+    // unsigned arithmetic handles the counter wrap around
+    return (uint32_t)(getMilliCount() - firstTime);
+}
+
+STUHFL_DLL_API uint32_t CALL_CONV getMicroSpan(uint32_t firstTime)
+{
+    return (uint32_t)(getMicroCount() - firstTime);
 }
 
 /**
@@ -35,6 +35,14 @@
 
 // dllmain.cpp
 
+#if defined(POSIX) && defined(__linux__)
+#define _GNU_SOURCE                     // pthread_attr_setaffinity_np
+#endif
+#include <stdlib.h>
+#if defined(POSIX)
+#include <errno.h>
+#include <sched.h>
+#endif
 #include "stuhfl.h"
 #include "stuhfl_err.h"
 #include "stuhfl_al.h"
@@ -42,50 +50,70 @@
 #include "stuhfl_sl_gen2.h"
 #include "stuhfl_sl_gb29768.h"
 #include "stuhfl_dl.h"
+#include "stuhfl_ctx.h"
 
+void* CALL_CONV_STD threadInventoryFunc(void *ptr);
 #if defined(WIN32) || defined(WIN64)
-static HANDLE inventoryThread = INVALID_HANDLE_VALUE;
+static void applyThreadOption(STUHFL_T_AL_Ctx *al, HANDLE thread);
 #elif defined(POSIX)
-static pthread_t inventoryThread = INVALID_HANDLE_VALUE;
-#else
+static int createRunnerThread(STUHFL_T_Reader_Ctx *ctx);
 #endif
 
-void* CALL_CONV_STD threadInventoryFunc(void *ptr);
-
-static STUHFL_T_CallerCtx gCallerCtxPointer = NULL;
-static STUHFL_T_ActionCycle gActionCycleCallback = NULL;
-static STUHFL_T_ActionCycleOOP gActionCycleCallbackOOP = NULL;
-static STUHFL_T_ActionFinished gActionFinishedCallback = NULL;
-static STUHFL_T_ActionFinishedOOP gActionFinishedCallbackOOP = NULL;
+#define RUNNER_STOP_TIMEOUT     1000    // max time the runner waits for the STOP reply, in ms
+#define QUEUE_BLOCK_WAIT        100     // max time a blocked runner sleeps between checks of a full queue, in ms
+#define PORT_CLAIM_WAIT         100     // max time STUHFL_F_Start sleeps between checks of a running asynchronous batch, in ms
 
-static STUHFL_T_ACTION_CYCLE_DATA *gActionCycleData = NULL;
-
-static uint32_t requestedRoundCnt = 0;
+// runner state (thread, callbacks, cycle data) is kept per reader in STUHFL_T_AL_Ctx, see stuhfl_ctx.h
 
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Start(STUHFL_T_ACTION action, STUHFL_T_ACTION_OPTION actionOptions, STUHFL_T_ActionCycle cycleCallback, STUHFL_T_ACTION_CYCLE_DATA cycleData, STUHFL_T_ActionFinished finishedCallback, STUHFL_T_ACTION_ID *id)
 {
-    gActionCycleCallback = cycleCallback;
-    gActionFinishedCallback = finishedCallback;
+    STUHFL_T_AL_Ctx *al = &STUHFL_F_CurReaderCtx()->al;
+    al->actionCycleCallback = cycleCallback;
+    al->actionFinishedCallback = finishedCallback;
     return STUHFL_F_Start_OOP(action, actionOptions, NULL, NULL, cycleData, NULL, id);
 }
 
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Start_OOP(STUHFL_T_ACTION action, STUHFL_T_ACTION_OPTION actionOptions, STUHFL_T_CallerCtx callerCtx, STUHFL_T_ActionCycleOOP cycleCallbackOOP, STUHFL_T_ACTION_CYCLE_DATA cycleData, STUHFL_T_ActionFinishedOOP finishedCallbackOOP, STUHFL_T_ACTION_ID *id)
 {
+    STUHFL_T_Reader_Ctx *ctx = STUHFL_F_CurReaderCtx();
+    STUHFL_T_AL_Ctx *al = &ctx->al;
     STUHFL_T_RET_CODE ret = ERR_GENERIC;
 
-    if ((inventoryThread != INVALID_HANDLE_VALUE) && (inventoryThread != (STUHFL_T_POINTER2UINT)NULL)) {
+    if (STUHFL_RUNNER_ACTIVE(al)) {
+        return ERR_REQUEST;
+    }
+    if ((action != STUHFL_ACTION_INVENTORY)
+#ifdef USE_INVENTORY_EXT
+            && (action != STUHFL_ACTION_INVENTORY_W_SLOT_STATISTICS)
+#endif
+       ) {
         return ERR_REQUEST;
     }
+    // views are decoded for STUHFL_ACTION_INVENTORY only, other actions deliver their cycles by the cycle callback
+    if ((action != STUHFL_ACTION_INVENTORY) && (al->tagViewCallback != NULL)) {
+        return ERR_PARAM;
+    }
+
+    // the device I/O thread may be executing a batch of asynchronous commands, the runner takes over the port after it
+    STUHFL_MUTEX_LOCK(&al->runnerLock);
+    while (al->asyncBatchActive) {
+        STUHFL_F_CondWait(&al->runnerDoneCond, &al->runnerLock, PORT_CLAIM_WAIT);
+    }
+    al->runnerClaimed = true;
+    STUHFL_MUTEX_UNLOCK(&al->runnerLock);
 
-    gCallerCtxPointer = callerCtx;
-    gActionCycleCallbackOOP = cycleCallbackOOP;
-    gActionCycleData = cycleData;
-    gActionFinishedCallbackOOP = finishedCallbackOOP;
-    *id = (STUHFL_T_ACTION_ID)inventoryThread;
+    al->callerCtxPointer = callerCtx;
+    al->actionCycleCallbackOOP = cycleCallbackOOP;
+    al->actionCycleData = cycleData;
+    al->actionFinishedCallbackOOP = finishedCallbackOOP;
+    al->action = action;
+    al->stopRequested = 0;
+    al->runnerDone = false;
+    *id = (STUHFL_T_ACTION_ID)al->inventoryThread;
 
     switch (action) {
     case STUHFL_ACTION_INVENTORY: {
-        requestedRoundCnt = (uint32_t)((STUHFL_T_Inventory_Option *)actionOptions)->roundCnt;
+        al->requestedRoundCnt = (uint32_t)((STUHFL_T_Inventory_Option *)actionOptions)->roundCnt;
         // reset tagListSize & statistics
         ((STUHFL_T_Inventory_Data *)cycleData)->tagListSize = 0;
         memset(&((STUHFL_T_Inventory_Data *)cycleData)->statistics, 0, sizeof(STUHFL_T_Inventory_Statistics));
@@ -96,7 +124,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Start_OOP(STUHFL_T_ACTION ac
     }
 #ifdef USE_INVENTORY_EXT
     case STUHFL_ACTION_INVENTORY_W_SLOT_STATISTICS: {
-        requestedRoundCnt = (uint32_t)((STUHFL_T_Inventory_Option *)actionOptions)->roundCnt;
+        al->requestedRoundCnt = (uint32_t)((STUHFL_T_Inventory_Option *)actionOptions)->roundCnt;
         // reset tagListSize & statistics
         ((STUHFL_T_Inventory_Data_Ext *)cycleData)->invData.tagListSize = 0;
         memset(&((STUHFL_T_Inventory_Data_Ext *)cycleData)->invData.statistics, 0, sizeof(STUHFL_T_Inventory_Statistics));
@@ -109,59 +137,445 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Start_OOP(STUHFL_T_ACTION ac
     }
 #endif  // USE_INVENTORY_EXT
     default:
-        return ERR_REQUEST;
+        break;
     }
 
+    al->threadStatus = STUHFL_O_RUNNER_THREAD_STATUS_INIT();
 #if defined(WIN32) || defined(WIN64)
-    inventoryThread = CreateThread(
-                          NULL,   //default security
-                          0,      //default stack size
-                          (LPTHREAD_START_ROUTINE)threadInventoryFunc,
-                          (void*)action,   //argument to threadFunc
-                          0,      //creation flags
-                          0
-                      );
+    al->inventoryThread = CreateThread(
+                              NULL,   //default security
+                              al->threadOption.stackSize,   //0: default stack size
+                              (LPTHREAD_START_ROUTINE)threadInventoryFunc,
+                              (void*)ctx,   //argument to threadFunc
+                              CREATE_SUSPENDED | (al->threadOption.stackSize ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0),   //creation flags, resumed once the options are applied
+                              0
+                          );
+    if (STUHFL_RUNNER_ACTIVE(al)) {
+        applyThreadOption(al, al->inventoryThread);
+        ResumeThread(al->inventoryThread);
+    }
 #elif defined(POSIX)
-    if (pthread_create(&inventoryThread, NULL, threadInventoryFunc, (void*)action)) {
-        inventoryThread = INVALID_HANDLE_VALUE;
+    if (createRunnerThread(ctx)) {
+        al->inventoryThread = INVALID_HANDLE_VALUE;
     }
 #else
 #endif
-    if ((inventoryThread == INVALID_HANDLE_VALUE) || (inventoryThread == (STUHFL_T_POINTER2UINT)NULL)) {
+    if (!STUHFL_RUNNER_ACTIVE(al)) {
+        STUHFL_MUTEX_LOCK(&al->runnerLock);
+        al->runnerClaimed = false;
+        STUHFL_COND_BROADCAST(&al->runnerDoneCond);
+        STUHFL_MUTEX_UNLOCK(&al->runnerLock);
         return ERR_REQUEST;
     }
 
-    *id = (STUHFL_T_ACTION_ID)inventoryThread;
+    *id = (STUHFL_T_ACTION_ID)al->inventoryThread;
     return ret;
 }
 
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetRunnerThreadOption(const STUHFL_T_Runner_Thread_Option *option)
+{
+    STUHFL_T_AL_Ctx *al = &STUHFL_F_CurReaderCtx()->al;
+    if (STUHFL_RUNNER_ACTIVE(al)) {
+        return ERR_BUSY;
+    }
+    if ((option != NULL) && (option->schedPolicy > STUHFL_RUNNER_SCHED_RR)) {
+        return ERR_PARAM;
+    }
+    al->threadOption = (option != NULL) ? *option : STUHFL_O_RUNNER_THREAD_OPTION_INIT();
+    return ERR_NONE;
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetRunnerThreadStatus(STUHFL_T_Runner_Thread_Status *status)
+{
+    if (status == NULL) {
+        return ERR_PARAM;
+    }
+    *status = STUHFL_F_CurReaderCtx()->al.threadStatus;
+    return ERR_NONE;
+}
+
+#if defined(WIN32) || defined(WIN64)
+// applied to the suspended thread, so that its first round already runs with them
+static void applyThreadOption(STUHFL_T_AL_Ctx *al, HANDLE thread)
+{
+    STUHFL_T_Runner_Thread_Option *option = &al->threadOption;
+    STUHFL_T_Runner_Thread_Status *status = &al->threadStatus;
+
+    // stack size was already given to the thread creation
+    if (option->stackSize) {
+        status->requested |= STUHFL_RUNNER_OPT_STACK_SIZE;
+        status->applied |= STUHFL_RUNNER_OPT_STACK_SIZE;
+    }
+
+    if (option->cpuAffinity) {
+        status->requested |= STUHFL_RUNNER_OPT_AFFINITY;
+        status->affinityErr = SetThreadAffinityMask(thread, (DWORD_PTR)option->cpuAffinity) ? 0 : (int32_t)GetLastError();
+        if (status->affinityErr == 0) {
+            status->applied |= STUHFL_RUNNER_OPT_AFFINITY;
+        }
+    }
+
+    if (option->schedPolicy != STUHFL_RUNNER_SCHED_DEFAULT) {
+        status->requested |= STUHFL_RUNNER_OPT_SCHED;
+        status->schedErr = SetThreadPriority(thread, option->priority) ? 0 : (int32_t)GetLastError();
+        if (status->schedErr == 0) {
+            status->applied |= STUHFL_RUNNER_OPT_SCHED;
+        }
+    }
+}
+#elif defined(POSIX)
+// options are given as thread attributes, so that the first round already runs with them
+static int createRunnerThread(STUHFL_T_Reader_Ctx *ctx)
+{
+    STUHFL_T_AL_Ctx *al = &ctx->al;
+    STUHFL_T_Runner_Thread_Option *option = &al->threadOption;
+    STUHFL_T_Runner_Thread_Status *status = &al->threadStatus;
+    pthread_attr_t attr;
+    bool explicitSched = false;
+    int err;
+
+    pthread_attr_init(&attr);
+    // nobody joins the runner, STUHFL_F_Stop and the eval API wait for runnerDone instead
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (option->stackSize) {
+        status->requested |= STUHFL_RUNNER_OPT_STACK_SIZE;
+        status->stackSizeErr = pthread_attr_setstacksize(&attr, option->stackSize);
+    }
+
+    if (option->cpuAffinity) {
+        status->requested |= STUHFL_RUNNER_OPT_AFFINITY;
+#if defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu = 0; (cpu < 64) && (cpu < CPU_SETSIZE); cpu++) {
+            if (option->cpuAffinity & (1ULL << cpu)) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        status->affinityErr = pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+#else
+        status->affinityErr = ENOSYS;
+#endif
+    }
+
+    if (option->schedPolicy != STUHFL_RUNNER_SCHED_DEFAULT) {
+        struct sched_param param = { .sched_priority = option->priority };
+        status->requested |= STUHFL_RUNNER_OPT_SCHED;
+        status->schedErr = pthread_attr_setschedpolicy(&attr, (option->schedPolicy == STUHFL_RUNNER_SCHED_FIFO) ? SCHED_FIFO : SCHED_RR);
+        if (status->schedErr == 0) {
+            status->schedErr = pthread_attr_setschedparam(&attr, &param);
+        }
+        if (status->schedErr == 0) {
+            status->schedErr = pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        }
+        explicitSched = (status->schedErr == 0);
+    }
+
+    err = pthread_create(&al->inventoryThread, &attr, threadInventoryFunc, (void*)ctx);
+    if ((err == EPERM) && explicitSched) {
+        // real time scheduling needs privileges, the runner is started with the inherited scheduling instead
+        status->schedErr = EPERM;
+        pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+        err = pthread_create(&al->inventoryThread, &attr, threadInventoryFunc, (void*)ctx);
+    }
+    pthread_attr_destroy(&attr);
+
+    if (err == 0) {
+        if (option->stackSize && (status->stackSizeErr == 0)) {
+            status->applied |= STUHFL_RUNNER_OPT_STACK_SIZE;
+        }
+        if (option->cpuAffinity && (status->affinityErr == 0)) {
+            status->applied |= STUHFL_RUNNER_OPT_AFFINITY;
+        }
+        if ((option->schedPolicy != STUHFL_RUNNER_SCHED_DEFAULT) && (status->schedErr == 0)) {
+            status->applied |= STUHFL_RUNNER_OPT_SCHED;
+        }
+    }
+    return err;
+}
+#endif
+
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Stop(STUHFL_T_ACTION_ID id)
 {
-    STUHFL_T_RET_CODE ret = ERR_PARAM;
-    if ((HANDLE)id == inventoryThread) {
-        // Force thread to exit
-        inventoryThread = INVALID_HANDLE_VALUE;
+    STUHFL_T_Reader_Ctx *ctx = STUHFL_F_RunnerReaderCtx(id);
+    if (ctx == NULL) {
+        return ERR_PARAM;
+    }
+    STUHFL_T_AL_Ctx *al = &ctx->al;
+
+    // the runner owns the port: it sends the STOP, drains the pending frames and calls the finished callback
+    STUHFL_ATOMIC_STORE(&al->stopRequested, 1U);
+    STUHFL_MUTEX_LOCK(&al->runnerLock);
+    STUHFL_COND_BROADCAST(&al->queueCond);
+    STUHFL_MUTEX_UNLOCK(&al->runnerLock);
+
+    // called from the cycle callback, the runner stops as soon as the callback returns
+    STUHFL_T_RET_CODE ret = ERR_NONE;
+#if defined(WIN32) || defined(WIN64)
+    bool fromRunner = (GetThreadId(al->inventoryThread) == GetCurrentThreadId());
+#elif defined(POSIX)
+    bool fromRunner = pthread_equal(pthread_self(), al->inventoryThread);
+#endif
+    if (!fromRunner) {
+        // runner may be blocked in a read until the receive timeout before it sees the request
+        ret = STUHFL_F_WaitRunnerDone(ctx, (2 * ctx->bl.rdComTimeout) + RUNNER_STOP_TIMEOUT);
+    }
+    STUHFL_F_ReleaseReaderCtx(ctx);
+    return ret;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE STUHFL_F_WaitRunnerDone(STUHFL_T_Reader_Ctx *ctx, uint32_t timeout)
+{
+    STUHFL_T_AL_Ctx *al = &ctx->al;
+    uint32_t startTime = getMilliCount();
+    STUHFL_T_RET_CODE ret = ERR_NONE;
+    STUHFL_MUTEX_LOCK(&al->runnerLock);
+    while (!al->runnerDone) {
+        uint32_t elapsed = getMilliSpan(startTime);
+        if ((elapsed >= timeout) || !STUHFL_F_CondWait(&al->runnerDoneCond, &al->runnerLock, timeout - elapsed)) {
+            ret = al->runnerDone ? ERR_NONE : ERR_TIMEOUT;
+            break;
+        }
+    }
+    STUHFL_MUTEX_UNLOCK(&al->runnerLock);
+    return ret;
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetInventoryTagViewCallback(STUHFL_T_InventoryTagView tagCallback, void *userCtx)
+{
+    return STUHFL_F_SetInventoryStreamCallbacks(tagCallback, NULL, userCtx);
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetInventoryStreamCallbacks(STUHFL_T_InventoryTagView onTag, STUHFL_T_InventoryStatisticsView onStatistics, void *userCtx)
+{
+    STUHFL_T_AL_Ctx *al = &STUHFL_F_CurReaderCtx()->al;
+    if (STUHFL_RUNNER_ACTIVE(al)) {
+        return ERR_BUSY;
+    }
+    al->tagViewCallback = onTag;
+    al->statisticsViewCallback = (onTag != NULL) ? onStatistics : NULL;
+    al->tagViewCtx = userCtx;
+    al->tagBatch = NULL;
+    return ERR_NONE;
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetInventoryTagBatch(STUHFL_T_Inventory_Tag_Batch *batch)
+{
+    // the batch is emptied after the cycle callback, a queue would only get the statistics
+    if ((batch != NULL) && (STUHFL_F_CurReaderCtx()->al.queueSlots != NULL)) {
+        return ERR_PARAM;
+    }
+    STUHFL_T_RET_CODE ret = STUHFL_F_SetInventoryStreamCallbacks((batch != NULL) ? STUHFL_F_TagBatchAppend : NULL, NULL, batch);
+    if (ret == ERR_NONE) {
+        STUHFL_F_CurReaderCtx()->al.tagBatch = batch;
+    }
+    return ret;
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetInventoryQueue(uint32_t capacity, uint32_t tagCntMax, uint8_t policy)
+{
+    STUHFL_T_AL_Ctx *al = &STUHFL_F_CurReaderCtx()->al;
+    STUHFL_T_Inventory_Data *slots = NULL;
+
+    if (STUHFL_RUNNER_ACTIVE(al)) {
+        return ERR_BUSY;
+    }
+    if ((capacity & (capacity - 1U)) || (policy > STUHFL_QUEUE_POLICY_DROP_NEWEST)) {
+        return ERR_PARAM;
+    }
+    if (capacity && (al->tagBatch != NULL)) {
+        return ERR_PARAM;
+    }
+
+    if (capacity) {
+        slots = (STUHFL_T_Inventory_Data *)calloc(1, (size_t)capacity * (sizeof(STUHFL_T_Inventory_Data) + ((size_t)tagCntMax * sizeof(STUHFL_T_Inventory_Tag))));
+        if (slots == NULL) {
+            return ERR_NOMEM;
+        }
+        STUHFL_T_Inventory_Tag *tags = (STUHFL_T_Inventory_Tag *)&slots[capacity];
+        for (uint32_t i = 0; i < capacity; i++) {
+            slots[i].tagList = &tags[(size_t)i * tagCntMax];
+            slots[i].tagListSizeMax = tagCntMax;
+        }
+    }
+
+    free(al->queueSlots);
+    al->queueSlots = slots;
+    al->queueCapacity = capacity;
+    al->queueTagCntMax = tagCntMax;
+    al->queuePolicy = policy;
+    al->queueRd = 0;
+    al->queueWr = 0;
+    al->queueHighWater = 0;
+    al->queuePushed = 0;
+    al->queueDropped = 0;
+    al->queueBlocked = 0;
+    return ERR_NONE;
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_InventoryQueuePop(STUHFL_T_Inventory_Data *data)
+{
+    STUHFL_T_AL_Ctx *al = &STUHFL_F_CurReaderCtx()->al;
+
+    if (data == NULL) {
+        return ERR_PARAM;
+    }
+    if (al->queueSlots == NULL) {
+        return ERR_REQUEST;
+    }
+
+    for (;;) {
+        uint32_t rd = STUHFL_ATOMIC_LOAD(&al->queueRd);
+        if (rd == STUHFL_ATOMIC_LOAD(&al->queueWr)) {
+            return ERR_NOMSG;
+        }
+
+        const STUHFL_T_Inventory_Data *slot = &al->queueSlots[rd & (al->queueCapacity - 1U)];
+        uint32_t tagCnt = min(slot->tagListSize, al->queueTagCntMax);
+        uint32_t copyCnt = min(tagCnt, data->tagListSizeMax);
+        data->statistics = slot->statistics;
+        if (copyCnt) {
+            memcpy(data->tagList, slot->tagList, copyCnt * sizeof(STUHFL_T_Inventory_Tag));
+        }
+
+        // entry is only ours when the runner did not drop it while being copied
+        if (STUHFL_ATOMIC_CAS(&al->queueRd, rd, rd + 1U)) {
+            // a full queue may have blocked the runner, wake it. Checked and signalled under the lock the runner waits with
+            if ((STUHFL_ATOMIC_LOAD(&al->queueWr) - rd) >= al->queueCapacity) {
+                STUHFL_MUTEX_LOCK(&al->runnerLock);
+                STUHFL_COND_BROADCAST(&al->queueCond);
+                STUHFL_MUTEX_UNLOCK(&al->runnerLock);
+            }
+            data->tagListSize = copyCnt;
+            data->tagListDropped += slot->tagListDropped + (tagCnt - copyCnt);
+            if (copyCnt > data->tagListSizeHighWater) {
+                data->tagListSizeHighWater = copyCnt;
+            }
+            return ERR_NONE;
+        }
+    }
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetInventoryQueueStats(STUHFL_T_Inventory_Queue_Stats *stats)
+{
+    STUHFL_T_AL_Ctx *al = &STUHFL_F_CurReaderCtx()->al;
+
+    if (stats == NULL) {
+        return ERR_PARAM;
+    }
+    if (al->queueSlots == NULL) {
+        return ERR_REQUEST;
+    }
+    uint32_t wr = STUHFL_ATOMIC_LOAD(&al->queueWr);
+    stats->capacity = al->queueCapacity;
+    stats->occupancy = wr - STUHFL_ATOMIC_LOAD(&al->queueRd);
+    stats->highWater = STUHFL_ATOMIC_LOAD(&al->queueHighWater);
+    stats->pushed = STUHFL_ATOMIC_LOAD(&al->queuePushed);
+    stats->dropped = STUHFL_ATOMIC_LOAD(&al->queueDropped);
+    stats->blocked = STUHFL_ATOMIC_LOAD(&al->queueBlocked);
+    return ERR_NONE;
+}
 
-        // send stop signal to terminate
-        int maxRetry = 256;
-        while ((ret != ERR_NONE) && (maxRetry--)) {
-            // repeat STOP until all outstanding runner packets are received and the STOP is correctly answered
-            ret = STUHFL_F_ExecuteCmd((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_STOP, NULL, NULL);
+static bool queuePush(STUHFL_T_AL_Ctx *al, const STUHFL_T_Inventory_Data *invData)
+{
+    uint32_t wr = al->queueWr;
+    uint32_t rd = STUHFL_ATOMIC_LOAD(&al->queueRd);
+    bool waited = false;
+
+    while ((wr - rd) >= al->queueCapacity) {
+        switch (al->queuePolicy) {
+        case STUHFL_QUEUE_POLICY_DROP_NEWEST:
+            STUHFL_ATOMIC_STORE(&al->queueDropped, al->queueDropped + 1U);
+            return false;
+        case STUHFL_QUEUE_POLICY_DROP_OLDEST:
+            // application may have pulled the entry meanwhile, then there is room anyway
+            if (STUHFL_ATOMIC_CAS(&al->queueRd, rd, rd + 1U)) {
+                STUHFL_ATOMIC_STORE(&al->queueDropped, al->queueDropped + 1U);
+            }
+            break;
+        default:
+            if (STUHFL_ATOMIC_LOAD(&al->stopRequested)) {
+                // runner is stopping, do not wait for the application anymore
+                STUHFL_ATOMIC_STORE(&al->queueDropped, al->queueDropped + 1U);
+                return false;
+            }
+            if (!waited) {
+                STUHFL_ATOMIC_STORE(&al->queueBlocked, al->queueBlocked + 1U);
+                waited = true;
+            }
+            // woken by InventoryQueuePop or STUHFL_F_Stop, the timeout is a fallback only
+            STUHFL_MUTEX_LOCK(&al->runnerLock);
+            if (((wr - STUHFL_ATOMIC_LOAD(&al->queueRd)) >= al->queueCapacity) && !STUHFL_ATOMIC_LOAD(&al->stopRequested)) {
+                STUHFL_F_CondWait(&al->queueCond, &al->runnerLock, QUEUE_BLOCK_WAIT);
+            }
+            STUHFL_MUTEX_UNLOCK(&al->runnerLock);
+            break;
         }
+        rd = STUHFL_ATOMIC_LOAD(&al->queueRd);
+    }
+
+    STUHFL_T_Inventory_Data *slot = &al->queueSlots[wr & (al->queueCapacity - 1U)];
+    uint32_t tagCnt = min(invData->tagListSize, al->queueTagCntMax);
+    slot->statistics = invData->statistics;
+    if (tagCnt) {
+        memcpy(slot->tagList, invData->tagList, tagCnt * sizeof(STUHFL_T_Inventory_Tag));
+    }
+    slot->tagListSize = tagCnt;
+    slot->tagListDropped = invData->tagListSize - tagCnt;
+    STUHFL_ATOMIC_STORE(&al->queueWr, wr + 1U);
+
+    STUHFL_ATOMIC_STORE(&al->queuePushed, al->queuePushed + 1U);
+    if ((wr + 1U - rd) > al->queueHighWater) {
+        STUHFL_ATOMIC_STORE(&al->queueHighWater, wr + 1U - rd);
+    }
+    return true;
+}
 
-        // notify about thread termination
-        if (gActionFinishedCallback) {
-            gActionFinishedCallback(gActionCycleData);
+static STUHFL_T_RET_CODE runnerStop(STUHFL_T_AL_Ctx *al)
+{
+    const STUHFL_T_CMD stopCmd = (STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_STOP;
+    uint32_t startTime = getMilliCount();
+    STUHFL_T_RET_CODE ret;
+
+    al->stopDrainedFrames = 0;
+    ret = STUHFL_F_SendCmd(stopCmd, NULL);
+    while (ret == ERR_NONE) {
+        // frames of the ongoing round are still in flight, drop them until the STOP is answered
+        ret = STUHFL_F_ReceiveCmdData(stopCmd, NULL);
+        if (ret == ERR_NONE) {
+            break;
+        }
+        if (getMilliSpan(startTime) >= RUNNER_STOP_TIMEOUT) {
+            ret = ERR_TIMEOUT;
+            break;
+        }
+        if (STUHFL_F_Get_RcvCmd() == ((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA)) {
+            al->stopDrainedFrames++;
+            ret = ERR_NONE;
+        } else if (ret == ERR_TIMEOUT) {
+            // nothing received, STOP got lost
+            ret = STUHFL_F_SendCmd(stopCmd, NULL);
         } else {
-            gActionFinishedCallbackOOP(gCallerCtxPointer, gActionCycleData);
+            ret = ERR_NONE;
         }
     }
+
+    if (ret != ERR_NONE) {
+        // leave no partial frame behind for the next command
+        STUHFL_F_Reset(STUHFL_RESET_TYPE_CLEAR_COMM);
+    }
     return ret;
 }
 
 void* CALL_CONV_STD threadInventoryFunc(void *ptr)
 {
-    STUHFL_T_POINTER2UINT action = (STUHFL_T_POINTER2UINT)ptr;
+    // runner operates on the reader that started it
+    STUHFL_T_Reader_Ctx *ctx = (STUHFL_T_Reader_Ctx *)ptr;
+    STUHFL_F_SelectReaderCtx(ctx);
+
+    STUHFL_T_AL_Ctx *al = &ctx->al;
+    STUHFL_T_POINTER2UINT action = al->action;
     STUHFL_T_Inventory_Data *invData = NULL;
 #ifdef USE_INVENTORY_EXT
     STUHFL_T_Inventory_Slot_Info_Data *invSlotData = NULL;
@@ -173,13 +587,13 @@ void* CALL_CONV_STD threadInventoryFunc(void *ptr)
 
         switch (action) {
         case STUHFL_ACTION_INVENTORY: {
-            invData = (STUHFL_T_Inventory_Data *)gActionCycleData;
+            invData = (STUHFL_T_Inventory_Data *)al->actionCycleData;
             break;
         }
 #ifdef USE_INVENTORY_EXT
         case STUHFL_ACTION_INVENTORY_W_SLOT_STATISTICS: {
-            invData = &((STUHFL_T_Inventory_Data_Ext *)gActionCycleData)->invData;
-            invSlotData = &((STUHFL_T_Inventory_Data_Ext *)gActionCycleData)->invSlotInfoData;
+            invData = &((STUHFL_T_Inventory_Data_Ext *)al->actionCycleData)->invData;
+            invSlotData = &((STUHFL_T_Inventory_Data_Ext *)al->actionCycleData)->invSlotInfoData;
             break;
         }
 #endif
@@ -196,42 +610,74 @@ void* CALL_CONV_STD threadInventoryFunc(void *ptr)
             break;
         }
 
+        // queued asynchronous commands go out in between the inventory frames
+        if (!STUHFL_ATOMIC_LOAD(&al->stopRequested)) {
+            STUHFL_F_ServeCmdAsync(false);
+        }
+
         // check for inventory data..
-        ret = STUHFL_F_ReceiveCmdData((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA, gActionCycleData);
-        if (ret == ERR_NONE) {
-            // notify via callback, when something received
-            if (gActionCycleCallback) {
-                gActionCycleCallback(gActionCycleData);
+        if ((action == STUHFL_ACTION_INVENTORY) && al->tagViewCallback) {
+            ret = STUHFL_F_ReceiveInventoryViews(al->tagViewCallback, al->statisticsViewCallback, al->tagViewCtx, &invData->statistics);
+        } else {
+            ret = STUHFL_F_ReceiveCmdData((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA, al->actionCycleData);
+        }
+        // in streaming mode everything was already delivered while decoding
+        if ((ret == ERR_NONE) && (al->statisticsViewCallback == NULL)) {
+            // notify via queue or callback, when something received
+            if (al->queueSlots) {
+                queuePush(al, invData);
+            } else if (al->actionCycleCallback) {
+                al->actionCycleCallback(al->actionCycleData);
             } else {
-                gActionCycleCallbackOOP(gCallerCtxPointer, gActionCycleData);
+                al->actionCycleCallbackOOP(al->callerCtxPointer, al->actionCycleData);
             }
         }
 
         // clear counters to be prepared for next cycle
         if (invData) { invData->tagListSize = 0; }
+        if (al->tagBatch) {
+            al->tagBatch->tagCnt = 0;
+            al->tagBatch->epcDataSize = 0;
+        }
 #ifdef USE_INVENTORY_EXT
         if (invSlotData) { invSlotData->slotInfoListSize = 0; }
 #endif
 
         // terminate thread when finished
-        if (requestedRoundCnt) {
-            if (invData->statistics.roundCnt >= requestedRoundCnt) {
-                if (gActionFinishedCallback) {
-                    gActionFinishedCallback(gActionCycleData);
-                } else {
-                    gActionFinishedCallbackOOP(gCallerCtxPointer, gActionCycleData);
-                }
+        if (al->requestedRoundCnt) {
+            if (invData->statistics.roundCnt >= al->requestedRoundCnt) {
                 looping = false;
             }
         }
 
-        if ((inventoryThread == INVALID_HANDLE_VALUE) || (inventoryThread == (STUHFL_T_POINTER2UINT)NULL)) {
+        if (looping && STUHFL_ATOMIC_LOAD(&al->stopRequested)) {
+            runnerStop(al);
             looping = false;
         }
     } while (looping);
 
-    inventoryThread = (STUHFL_T_POINTER2UINT)NULL;
-    return (void *)(inventoryThread);
+    // no reply may be left behind for the next command
+    STUHFL_F_ServeCmdAsync(true);
+
+    // notify about thread termination, exactly once
+    if (invData) {
+        if (al->actionFinishedCallback) {
+            al->actionFinishedCallback(al->actionCycleData);
+        } else {
+            al->actionFinishedCallbackOOP(al->callerCtxPointer, al->actionCycleData);
+        }
+    }
+
+    STUHFL_MUTEX_LOCK(&al->runnerLock);
+#if defined(WIN32) || defined(WIN64)
+    CloseHandle(al->inventoryThread);
+#endif
+    al->inventoryThread = 0;
+    al->runnerClaimed = false;
+    al->runnerDone = true;
+    STUHFL_COND_BROADCAST(&al->runnerDoneCond);
+    STUHFL_MUTEX_UNLOCK(&al->runnerLock);
+    return NULL;
 }
 
 /**
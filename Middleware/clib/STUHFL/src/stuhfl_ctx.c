@@ -0,0 +1,200 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+/** @file
+ *
+ *  @author ST Microelectronics
+ *
+ *  @brief
+ *
+ */
+
+/** @addtogroup Application
+  * @{
+  */
+/** @addtogroup PC_Communication
+  * @{
+  */
+
+#include <stdlib.h>
+#include "stuhfl.h"
+#include "stuhfl_dl.h"
+#include "stuhfl_ctx.h"
+#include "stuhfl_err.h"
+#include "stuhfl_log.h"
+
+#define TRACE_DL_LOG_START()    { STUHFL_F_LogClear(LOG_LEVEL_TRACE_DL); }
+#define TRACE_DL_LOG(...)       { STUHFL_F_LogAppend(LOG_LEVEL_TRACE_DL, __VA_ARGS__); STUHFL_F_LogFlush(LOG_LEVEL_TRACE_DL); }
+
+// context used by the global API as long as a thread did not select one
+static STUHFL_T_Reader_Ctx gDefaultCtx = {
+    .al.inventoryThread = INVALID_HANDLE_VALUE,
+    .al.runnerLock = STUHFL_D_MUTEX_INIT,
+    .dl.br = STUHFL_D_DEFAULT_BR,
+    .dl.ignoreInventoryData = true,
+    .dl.asyncLock = STUHFL_D_MUTEX_INIT,
+    .bl.rdComTimeout = STUHFL_D_DEFAULT_RD_TIMEOUT,
+    .bl.wrComTimeout = STUHFL_D_DEFAULT_WR_TIMEOUT,
+};
+static STUHFL_THREAD_LOCAL STUHFL_T_Reader_Ctx *gSelectedCtx = NULL;
+
+// guards the list of created contexts, the default context is always its head
+static STUHFL_T_Mutex gCtxListLock = STUHFL_D_MUTEX_INIT;
+
+static void initCtxConds(STUHFL_T_Reader_Ctx *readerCtx)
+{
+    STUHFL_F_CondInit(&readerCtx->al.runnerDoneCond);
+    STUHFL_F_CondInit(&readerCtx->al.queueCond);
+    STUHFL_F_CondInit(&readerCtx->dl.asyncCond);
+}
+
+// a static initializer can not select the clock of a condition variable,
+// on Windows the zero initialized CONDITION_VARIABLEs of the default context are ready to use
+#if defined(POSIX)
+__attribute__((constructor)) static void initDefaultCtx(void)
+{
+    initCtxConds(&gDefaultCtx);
+}
+#endif
+
+// --------------------------------------------------------------------------
+STUHFL_T_Reader_Ctx *STUHFL_F_CurReaderCtx(void)
+{
+    return (gSelectedCtx != NULL) ? gSelectedCtx : &gDefaultCtx;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_T_Reader_Ctx *STUHFL_F_RunnerReaderCtx(STUHFL_T_ACTION_ID id)
+{
+    STUHFL_T_Reader_Ctx *readerCtx;
+
+    if ((id == (STUHFL_T_ACTION_ID)INVALID_HANDLE_VALUE) || (id == 0)) {
+        return NULL;
+    }
+    STUHFL_MUTEX_LOCK(&gCtxListLock);
+    for (readerCtx = &gDefaultCtx; readerCtx != NULL; readerCtx = readerCtx->next) {
+        if ((STUHFL_T_ACTION_ID)readerCtx->al.inventoryThread == id) {
+            break;
+        }
+    }
+    if (readerCtx != NULL) {
+        readerCtx->refCnt++;
+    }
+    STUHFL_MUTEX_UNLOCK(&gCtxListLock);
+    return readerCtx;
+}
+
+// --------------------------------------------------------------------------
+void STUHFL_F_ReleaseReaderCtx(STUHFL_T_Reader_Ctx *ctx)
+{
+    STUHFL_MUTEX_LOCK(&gCtxListLock);
+    ctx->refCnt--;
+    STUHFL_MUTEX_UNLOCK(&gCtxListLock);
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_CreateReaderCtx(STUHFL_T_READER_CTX *ctx)
+{
+    STUHFL_T_Reader_Ctx *readerCtx = NULL;
+
+    if (ctx == NULL) {
+        return ERR_PARAM;
+    }
+
+    readerCtx = (STUHFL_T_Reader_Ctx *)calloc(1, sizeof(STUHFL_T_Reader_Ctx));
+    if (readerCtx == NULL) {
+        return ERR_NOMEM;
+    }
+    readerCtx->al.inventoryThread = INVALID_HANDLE_VALUE;
+    readerCtx->al.runnerLock = (STUHFL_T_Mutex)STUHFL_D_MUTEX_INIT;
+    readerCtx->dl.br = STUHFL_D_DEFAULT_BR;
+    readerCtx->dl.ignoreInventoryData = true;
+    readerCtx->dl.asyncLock = (STUHFL_T_Mutex)STUHFL_D_MUTEX_INIT;
+    initCtxConds(readerCtx);
+    readerCtx->bl.rdComTimeout = STUHFL_D_DEFAULT_RD_TIMEOUT;
+    readerCtx->bl.wrComTimeout = STUHFL_D_DEFAULT_WR_TIMEOUT;
+
+    STUHFL_MUTEX_LOCK(&gCtxListLock);
+    readerCtx->next = gDefaultCtx.next;
+    gDefaultCtx.next = readerCtx;
+    STUHFL_MUTEX_UNLOCK(&gCtxListLock);
+
+    *ctx = (STUHFL_T_READER_CTX)readerCtx;
+    TRACE_DL_LOG_START();
+    TRACE_DL_LOG("STUHFL_F_CreateReaderCtx(ctx = 0x%x) = %d", *ctx, ERR_NONE);
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_DestroyReaderCtx(STUHFL_T_READER_CTX ctx)
+{
+    STUHFL_T_Reader_Ctx *readerCtx = (STUHFL_T_Reader_Ctx *)ctx;
+
+    if ((readerCtx == NULL) || (readerCtx == &gDefaultCtx)) {
+        return ERR_PARAM;
+    }
+    // still connected, runner or device I/O thread active or context still looked up by STUHFL_F_Stop
+    STUHFL_T_DEVICE_CTX *device = (STUHFL_T_DEVICE_CTX *)readerCtx->dl.deviceCtx;
+    STUHFL_MUTEX_LOCK(&gCtxListLock);
+    if (((device != NULL) && (*device != NULL) && (*device != (STUHFL_T_DEVICE_CTX)INVALID_HANDLE_VALUE))
+            || STUHFL_RUNNER_ACTIVE(&readerCtx->al)
+            || readerCtx->dl.asyncRunning
+            || (readerCtx->refCnt != 0)) {
+        STUHFL_MUTEX_UNLOCK(&gCtxListLock);
+        return ERR_BUSY;
+    }
+    for (STUHFL_T_Reader_Ctx *prev = &gDefaultCtx; prev != NULL; prev = prev->next) {
+        if (prev->next == readerCtx) {
+            prev->next = readerCtx->next;
+            break;
+        }
+    }
+    STUHFL_MUTEX_UNLOCK(&gCtxListLock);
+
+    if (gSelectedCtx == readerCtx) {
+        gSelectedCtx = NULL;
+    }
+    TRACE_DL_LOG_START();
+    TRACE_DL_LOG("STUHFL_F_DestroyReaderCtx(ctx = 0x%x) = %d", ctx, ERR_NONE);
+    free(readerCtx->api.appliedProfile);
+    free(readerCtx->al.queueSlots);
+    free(readerCtx);
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SelectReaderCtx(STUHFL_T_READER_CTX ctx)
+{
+    gSelectedCtx = (STUHFL_T_Reader_Ctx *)ctx;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_READER_CTX CALL_CONV STUHFL_F_GetReaderCtx(void)
+{
+    return (STUHFL_T_READER_CTX)STUHFL_F_CurReaderCtx();
+}
+
+/**
+  * @}
+  */
+/**
+  * @}
+  */
@@ -35,6 +35,8 @@
 
 // dllmain.cpp
 
+#include <stddef.h>
+#include <stdlib.h>
 #include "stuhfl.h"
 #include "stuhfl_al.h"
 #include "stuhfl_sl.h"
@@ -43,6 +45,7 @@
 #include "stuhfl_dl.h"
 #include "stuhfl_dl_ST25RU3993.h"
 #include "stuhfl_pl.h"
+#include "stuhfl_ctx.h"
 #include "stuhfl_helpers.h"
 #include "stuhfl_err.h"
 #include "stuhfl_log.h"
@@ -62,42 +65,30 @@
 #define STUHFL_D_ST25RU3993_HID_VID     0x1234
 #define STUHFL_D_ST25RU3993_HID_PID     0x1234
 
-//
-static STUHFL_T_DEVICE_CTX deviceCtx = NULL;
-static STUHFL_T_ParamTypeConnectionPort comPort = NULL;
-//static STUHFL_T_ParamTypeConnectionBR br = 115200;
-//static STUHFL_T_ParamTypeConnectionBR br = 230400;
-//static STUHFL_T_ParamTypeConnectionBR br = 460800;
-//static STUHFL_T_ParamTypeConnectionBR br = 500000;
-//static STUHFL_T_ParamTypeConnectionBR br = 576000;
-//static STUHFL_T_ParamTypeConnectionBR br = 921600;
-//static STUHFL_T_ParamTypeConnectionBR br = 1000000;
-//static STUHFL_T_ParamTypeConnectionBR br = 1152000;
-//static STUHFL_T_ParamTypeConnectionBR br = 1500000;
-//static STUHFL_T_ParamTypeConnectionBR br = 2000000;
-//static STUHFL_T_ParamTypeConnectionBR br = 2500000;
-static STUHFL_T_ParamTypeConnectionBR br = 3000000;     // highest baudrate supported by FT231X on EVAL board
-//static STUHFL_T_ParamTypeConnectionBR br = 3500000;
-//static STUHFL_T_ParamTypeConnectionBR br = 4000000;
-
-static bool gIgnoreInventoryData = true;
+// connection state (deviceCtx, comPort, br, ..) is kept per reader in STUHFL_T_DL_Ctx, see stuhfl_ctx.h
 
 
 // - Internal implementation helpers ----------------------------------------
 STUHFL_T_RET_CODE SetParam_SndPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, uint8_t *sndPayload, uint16_t *sndPayloadOffset);
 STUHFL_T_RET_CODE SetParam_RcvPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, uint8_t *rcvPayload, uint16_t *rcvPayloadOffset);
 STUHFL_T_RET_CODE GetParam_SndPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, uint8_t *sndPayload, uint16_t *sndPayloadOffset);
-STUHFL_T_RET_CODE GetParam_RcvPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, uint8_t *rcvPayload, uint16_t rcvPayloadAvailable, uint16_t *rcvPayloadOffset);
+STUHFL_T_RET_CODE GetParam_RcvPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, STUHFL_T_TlvIter *it);
+static bool shadowLookup(STUHFL_T_DL_Ctx *dl, STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, bool count);
+static void shadowStore(STUHFL_T_DL_Ctx *dl, STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset);
+static void shadowInvalidate(STUHFL_T_DL_Ctx *dl);
+static void asyncStop(STUHFL_T_DL_Ctx *dl);
+static bool asyncRouteReply(STUHFL_T_DL_Ctx *dl, STUHFL_T_RET_CODE rcvRet, uint8_t *rcvPayload, uint16_t rcvPayloadLen);
 
 
 
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetRawData(uint8_t *data, uint16_t *dataLen)
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
 #define TB_SIZE    1024
     char tb[TB_SIZE];
     TRACE_DL_LOG_START();
-    STUHFL_T_RET_CODE ret = STUHFL_F_RcvRaw_Dispatcher(deviceCtx, data, dataLen);
+    STUHFL_T_RET_CODE ret = STUHFL_F_RcvRaw_Dispatcher(dl->deviceCtx, data, dataLen);
     TRACE_DL_LOG("STUHFL_F_GetRawData(*data = 0x%s, dataLen = %d) = %d", byteArray2HexString(tb, TB_SIZE, data, min(16, *dataLen)), *dataLen, ret);
 #undef TB_SIZE
     return ret;
@@ -106,8 +97,10 @@ STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetRawData(uint8_t *data, uint16_t *dataLen
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Connect(STUHFL_T_DEVICE_CTX *device, uint8_t *sndBuffer, uint16_t sndBufferLen, uint8_t *rcvBuffer, uint16_t rcvBufferLen)
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     STUHFL_T_RET_CODE ret = STUHFL_F_Connect_Dispatcher(device, sndBuffer, sndBufferLen, rcvBuffer, rcvBufferLen);
-    deviceCtx = device;
+    dl->deviceCtx = device;
+    shadowInvalidate(dl);
     TRACE_DL_LOG_START();
     TRACE_DL_LOG("STUHFL_F_Connect(device = 0x%x, *sndBuffer = 0x%x, sndBufferLen = %d, *rcvBuffer = 0x%x, rcvBufferLen = %d) = %d", *device, sndBuffer, sndBufferLen, rcvBuffer, rcvBufferLen, ret);
     return ret;
@@ -117,16 +110,19 @@ STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Connect(STUHFL_T_DEVICE_CTX *device, uint8_
 // --------------------------------------------------------------------------
 STUHFL_DLL_API STUHFL_T_DEVICE_CTX CALL_CONV STUHFL_F_GetCtx(void)
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     TRACE_DL_LOG_START();
-    TRACE_DL_LOG("STUHFL_F_GetCtx() .. deviceCtx = 0x%x)", deviceCtx);
-    return deviceCtx;
+    TRACE_DL_LOG("STUHFL_F_GetCtx() .. deviceCtx = 0x%x)", dl->deviceCtx);
+    return dl->deviceCtx;
 }
 
 // --------------------------------------------------------------------------
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Reset(STUHFL_T_RESET resetType)
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     TRACE_DL_LOG_START();
     STUHFL_T_RET_CODE ret = ERR_PARAM;
+    shadowInvalidate(dl);
     switch (resetType) {
     case STUHFL_RESET_TYPE_SOFT:
         break;
@@ -135,7 +131,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Reset(STUHFL_T_RESET resetTy
         break;
 
     case STUHFL_RESET_TYPE_CLEAR_COMM:
-        ret = STUHFL_F_Reset_Dispatcher(deviceCtx, resetType);
+        ret = STUHFL_F_Reset_Dispatcher(dl->deviceCtx, resetType);
         break;
 
     default:
@@ -149,9 +145,15 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Reset(STUHFL_T_RESET resetTy
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Disconnect()
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
+    asyncStop(dl);
     TRACE_DL_LOG_START();
-    STUHFL_T_RET_CODE ret = STUHFL_F_Disconnect_Dispatcher(deviceCtx);
-    TRACE_DL_LOG("STUHFL_F_Disconnect(deviceCtx = 0x%x) = %d", deviceCtx, ret);
+    STUHFL_T_RET_CODE ret = STUHFL_F_Disconnect_Dispatcher(dl->deviceCtx);
+    shadowInvalidate(dl);
+    TRACE_DL_LOG("STUHFL_F_Disconnect(deviceCtx = 0x%x) = %d", dl->deviceCtx, ret);
+    if (ret == ERR_NONE) {
+        dl->deviceCtx = NULL;
+    }
     return ret;
 }
 
@@ -194,9 +196,13 @@ STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetParamInfo(STUHFL_T_PARAM param, STUHFL_T
         case STUHFL_PARAM_KEY_BR:
         case STUHFL_PARAM_KEY_RD_TIMEOUT_MS:
         case STUHFL_PARAM_KEY_WR_TIMEOUT_MS:
+        case STUHFL_PARAM_KEY_RX_RESYNC_CNT:
+        case STUHFL_PARAM_KEY_RX_DROPPED_BYTES:
             break;
         case STUHFL_PARAM_KEY_DTR:
         case STUHFL_PARAM_KEY_RTS:
+        case STUHFL_PARAM_KEY_TX_QUEUE:
+        case STUHFL_PARAM_KEY_SHADOW_CACHE:
             info.type = (STUHFL_T_TYPE)STUHFL_TYPE_UINT8;
             info.size_of = sizeof(STUHFL_T_ParamTypeUINT8);
             break;
@@ -240,6 +246,7 @@ STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetParamInfo(STUHFL_T_PARAM param, STUHFL_T
 // --------------------------------------------------------------------------
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetMultipleParams(STUHFL_T_PARAM_CNT paramCnt, STUHFL_T_PARAM *params, STUHFL_T_PARAM_VALUE *values)
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     STUHFL_T_RET_CODE ret = ERR_PARAM;
     uint8_t *sndPayload = STUHFL_F_Get_SndPayloadPtr();
     uint16_t sndPayloadLen = 0;
@@ -262,28 +269,34 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetMultipleParams(STUHFL_T_P
         case STUHFL_PARAM_TYPE_CONNECTION: {
             switch (param) {
             case STUHFL_PARAM_KEY_PORT:
-                comPort = (STUHFL_T_ParamTypeConnectionPort)&(((uint8_t *)values)[valuesOffset]);
-                valuesOffset = (uint16_t)(valuesOffset + (uint16_t)strlen(comPort));        // Warning removal
+                dl->comPort = (STUHFL_T_ParamTypeConnectionPort)&(((uint8_t *)values)[valuesOffset]);
+                valuesOffset = (uint16_t)(valuesOffset + (uint16_t)strlen(dl->comPort));        // Warning removal
                 ret = ERR_NONE;
                 hostParam = true;
-                TRACE_DL_LOG_APPEND(" Port:%s", comPort);
+                TRACE_DL_LOG_APPEND(" Port:%s", dl->comPort);
                 break;
             case STUHFL_PARAM_KEY_BR:
-                br = *((STUHFL_T_ParamTypeConnectionBR*)&(((uint8_t *)values)[valuesOffset]));
+                dl->br = *((STUHFL_T_ParamTypeConnectionBR*)&(((uint8_t *)values)[valuesOffset]));
                 valuesOffset = (uint16_t)(valuesOffset + (uint16_t)sizeof(STUHFL_T_ParamTypeConnectionBR));     // Warning removal
                 ret = ERR_NONE;
                 hostParam = true;
-                TRACE_DL_LOG_APPEND(" BaudRate:%s", br);
+                TRACE_DL_LOG_APPEND(" BaudRate:%s", dl->br);
                 break;
 
             // forward to PL
             case STUHFL_PARAM_KEY_RD_TIMEOUT_MS:
             case STUHFL_PARAM_KEY_WR_TIMEOUT_MS:
-                ret = STUHFL_F_SetParam_Dispatcher(deviceCtx, type | param, &(((uint8_t *)values)[valuesOffset]));
+            case STUHFL_PARAM_KEY_RX_RESYNC_CNT:
+            case STUHFL_PARAM_KEY_RX_DROPPED_BYTES:
+                ret = STUHFL_F_SetParam_Dispatcher(dl->deviceCtx, type | param, &(((uint8_t *)values)[valuesOffset]));
                 if (param == STUHFL_PARAM_KEY_RD_TIMEOUT_MS) {
                     TRACE_DL_LOG_APPEND(" RdTimeout:%d ", *(uint32_t*)&(((uint8_t *)values)[valuesOffset]));
-                } else {
+                } else if (param == STUHFL_PARAM_KEY_WR_TIMEOUT_MS) {
                     TRACE_DL_LOG_APPEND(" WdTimeout:%d ", *(uint32_t*)&(((uint8_t *)values)[valuesOffset]));
+                } else if (param == STUHFL_PARAM_KEY_RX_RESYNC_CNT) {
+                    TRACE_DL_LOG_APPEND(" RxResyncCnt:%d ", *(uint32_t*)&(((uint8_t *)values)[valuesOffset]));
+                } else {
+                    TRACE_DL_LOG_APPEND(" RxDroppedBytes:%d ", *(uint32_t*)&(((uint8_t *)values)[valuesOffset]));
                 }
                 valuesOffset = (uint16_t)(valuesOffset + (uint16_t)sizeof(uint32_t));   // Warning removal
                 ret = ERR_NONE;
@@ -292,17 +305,31 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetMultipleParams(STUHFL_T_P
 
             case STUHFL_PARAM_KEY_DTR:
             case STUHFL_PARAM_KEY_RTS:
-                ret = STUHFL_F_SetParam_Dispatcher(deviceCtx, type | param, &(((uint8_t *)values)[valuesOffset]));
+            case STUHFL_PARAM_KEY_TX_QUEUE:
+                ret = STUHFL_F_SetParam_Dispatcher(dl->deviceCtx, type | param, &(((uint8_t *)values)[valuesOffset]));
                 if (param == STUHFL_PARAM_KEY_DTR) {
                     TRACE_DL_LOG_APPEND(" DTR:%d ", ((uint8_t *)values)[valuesOffset]);
-                } else {
+                } else if (param == STUHFL_PARAM_KEY_RTS) {
                     TRACE_DL_LOG_APPEND(" RTS:%d ", ((uint8_t *)values)[valuesOffset]);
+                } else {
+                    TRACE_DL_LOG_APPEND(" TxQueue:%d ", ((uint8_t *)values)[valuesOffset]);
                 }
                 valuesOffset = (uint16_t)(valuesOffset + (uint16_t)sizeof(uint8_t));    // Warning removal
                 ret = ERR_NONE;
                 hostParam = true;
                 break;
 
+            case STUHFL_PARAM_KEY_SHADOW_CACHE:
+                dl->shadowEnabled = (((uint8_t *)values)[valuesOffset] != 0);
+                shadowInvalidate(dl);
+                memset(dl->shadowHits, 0, sizeof(dl->shadowHits));
+                memset(dl->shadowMisses, 0, sizeof(dl->shadowMisses));
+                TRACE_DL_LOG_APPEND(" ShadowCache:%d ", dl->shadowEnabled);
+                valuesOffset = (uint16_t)(valuesOffset + (uint16_t)sizeof(uint8_t));    // Warning removal
+                ret = ERR_NONE;
+                hostParam = true;
+                break;
+
             default:
                 ret = ERR_PARAM;
                 break;
@@ -332,9 +359,9 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetMultipleParams(STUHFL_T_P
     }
 
     // Exchange all board relevant data..
-    if (!hostParam && ((STUHFL_T_POINTER2UINT)deviceCtx != (STUHFL_T_POINTER2UINT)NULL) && ((STUHFL_T_POINTER2UINT)deviceCtx != (STUHFL_T_POINTER2UINT)INVALID_HANDLE_VALUE)) {
-        ret = STUHFL_F_Snd_Dispatcher(deviceCtx, (STUHFL_CG_DL << 8) | STUHFL_CC_SET_PARAM, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
-        ret |= STUHFL_F_Rcv_Dispatcher(deviceCtx, rcvPayload, &rcvPayloadLen);
+    if (!hostParam && ((STUHFL_T_POINTER2UINT)dl->deviceCtx != (STUHFL_T_POINTER2UINT)NULL) && ((STUHFL_T_POINTER2UINT)dl->deviceCtx != (STUHFL_T_POINTER2UINT)INVALID_HANDLE_VALUE)) {
+        ret = STUHFL_F_Snd_Dispatcher(dl->deviceCtx, (STUHFL_CG_DL << 8) | STUHFL_CC_SET_PARAM, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
+        ret |= STUHFL_F_Rcv_Dispatcher(dl->deviceCtx, rcvPayload, &rcvPayloadLen);
         ret |= STUHFL_F_Get_RcvStatus();
 
         // if succeeded get data
@@ -354,8 +381,12 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetMultipleParams(STUHFL_T_P
                     case STUHFL_PARAM_KEY_BR:
                     case STUHFL_PARAM_KEY_RD_TIMEOUT_MS:
                     case STUHFL_PARAM_KEY_WR_TIMEOUT_MS:
+                    case STUHFL_PARAM_KEY_RX_RESYNC_CNT:
+                    case STUHFL_PARAM_KEY_RX_DROPPED_BYTES:
                     case STUHFL_PARAM_KEY_DTR:
                     case STUHFL_PARAM_KEY_RTS:
+                    case STUHFL_PARAM_KEY_TX_QUEUE:
+                    case STUHFL_PARAM_KEY_SHADOW_CACHE:
                         // already handled..
                         break;
 
@@ -383,7 +414,11 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetMultipleParams(STUHFL_T_P
                 }
             }
 
-
+            // keep shadow in sync with what the board accepted
+            valuesOffset = 0;
+            for (uint32_t i = 0; i < paramCnt; i++) {
+                shadowStore(dl, params[i] & STUHFL_PARAM_KEY_MASK, values, &valuesOffset);
+            }
         }
     }
 
@@ -393,6 +428,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetMultipleParams(STUHFL_T_P
 }
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetMultipleParams(STUHFL_T_PARAM_CNT paramCnt, STUHFL_T_PARAM *params, STUHFL_T_PARAM_VALUE *values)
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     STUHFL_T_RET_CODE ret = ERR_PARAM;
     uint8_t *sndPayload = STUHFL_F_Get_SndPayloadPtr();
     uint16_t sndPayloadLen = 0;
@@ -400,6 +436,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetMultipleParams(STUHFL_T_P
     uint16_t rcvPayloadLen = 0;
     uint16_t valuesOffset = 0;
     bool hostParam = false;
+    bool boardParam = false;
 
     TRACE_DL_LOG_CLEAR();
     TRACE_DL_LOG_APPEND("STUHFL_F_GetMultipleParams(paramCnt = %d, params:values =", paramCnt);
@@ -416,28 +453,34 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetMultipleParams(STUHFL_T_P
         case STUHFL_PARAM_TYPE_CONNECTION: {
             switch (param) {
             case STUHFL_PARAM_KEY_PORT:
-                *(STUHFL_T_ParamTypeConnectionPort*)&(((uint8_t *)values)[valuesOffset]) = comPort;
-                valuesOffset = (uint16_t)(valuesOffset + (uint16_t)strlen(comPort));        // Warning removal
+                *(STUHFL_T_ParamTypeConnectionPort*)&(((uint8_t *)values)[valuesOffset]) = dl->comPort;
+                valuesOffset = (uint16_t)(valuesOffset + (uint16_t)strlen(dl->comPort));        // Warning removal
                 ret = ERR_NONE;
                 hostParam = true;
-                TRACE_DL_LOG_APPEND(" Port:%s", comPort);
+                TRACE_DL_LOG_APPEND(" Port:%s", dl->comPort);
                 break;
             case STUHFL_PARAM_KEY_BR:
-                *(STUHFL_T_ParamTypeConnectionBR*)&(((uint8_t *)values)[valuesOffset]) = br;
+                *(STUHFL_T_ParamTypeConnectionBR*)&(((uint8_t *)values)[valuesOffset]) = dl->br;
                 valuesOffset = (uint16_t)(valuesOffset + (uint16_t)sizeof(STUHFL_T_ParamTypeConnectionBR));     // Warning removal
                 ret = ERR_NONE;
                 hostParam = true;
-                TRACE_DL_LOG_APPEND(" BaudRate:%d", br);
+                TRACE_DL_LOG_APPEND(" BaudRate:%d", dl->br);
                 break;
 
             // forward to PL
             case STUHFL_PARAM_KEY_RD_TIMEOUT_MS:
             case STUHFL_PARAM_KEY_WR_TIMEOUT_MS:
-                ret = STUHFL_F_GetParam_Dispatcher(deviceCtx, type | param, &(((uint8_t *)values)[valuesOffset]));
+            case STUHFL_PARAM_KEY_RX_RESYNC_CNT:
+            case STUHFL_PARAM_KEY_RX_DROPPED_BYTES:
+                ret = STUHFL_F_GetParam_Dispatcher(dl->deviceCtx, type | param, &(((uint8_t *)values)[valuesOffset]));
                 if (param == STUHFL_PARAM_KEY_RD_TIMEOUT_MS) {
                     TRACE_DL_LOG_APPEND(" RdTimeout:%d ", *(uint32_t*)&(((uint8_t *)values)[valuesOffset]));
-                } else {
+                } else if (param == STUHFL_PARAM_KEY_WR_TIMEOUT_MS) {
                     TRACE_DL_LOG_APPEND(" WdTimeout:%d ", *(uint32_t*)&(((uint8_t *)values)[valuesOffset]));
+                } else if (param == STUHFL_PARAM_KEY_RX_RESYNC_CNT) {
+                    TRACE_DL_LOG_APPEND(" RxResyncCnt:%d ", *(uint32_t*)&(((uint8_t *)values)[valuesOffset]));
+                } else {
+                    TRACE_DL_LOG_APPEND(" RxDroppedBytes:%d ", *(uint32_t*)&(((uint8_t *)values)[valuesOffset]));
                 }
                 valuesOffset = (uint16_t)(valuesOffset + (uint16_t)sizeof(uint32_t));   // Warning removal
                 ret = ERR_NONE;
@@ -447,17 +490,28 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetMultipleParams(STUHFL_T_P
             // forward to PL
             case STUHFL_PARAM_KEY_DTR:
             case STUHFL_PARAM_KEY_RTS:
-                ret = STUHFL_F_GetParam_Dispatcher(deviceCtx, type | param, &(((uint8_t *)values)[valuesOffset]));
+            case STUHFL_PARAM_KEY_TX_QUEUE:
+                ret = STUHFL_F_GetParam_Dispatcher(dl->deviceCtx, type | param, &(((uint8_t *)values)[valuesOffset]));
                 if (param == STUHFL_PARAM_KEY_DTR) {
                     TRACE_DL_LOG_APPEND(" DTR:%d ", ((uint8_t *)values)[valuesOffset]);
-                } else {
+                } else if (param == STUHFL_PARAM_KEY_RTS) {
                     TRACE_DL_LOG_APPEND(" RTS:%d ", ((uint8_t *)values)[valuesOffset]);
+                } else {
+                    TRACE_DL_LOG_APPEND(" TxQueue:%d ", ((uint8_t *)values)[valuesOffset]);
                 }
                 valuesOffset = (uint16_t)(valuesOffset + (uint16_t)sizeof(uint8_t));    // Warning removal
                 ret = ERR_NONE;
                 hostParam = true;
                 break;
 
+            case STUHFL_PARAM_KEY_SHADOW_CACHE:
+                ((uint8_t *)values)[valuesOffset] = dl->shadowEnabled ? 1 : 0;
+                TRACE_DL_LOG_APPEND(" ShadowCache:%d ", dl->shadowEnabled);
+                valuesOffset = (uint16_t)(valuesOffset + (uint16_t)sizeof(uint8_t));    // Warning removal
+                ret = ERR_NONE;
+                hostParam = true;
+                break;
+
             default:
                 ret = ERR_PARAM;
                 break;
@@ -470,7 +524,13 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetMultipleParams(STUHFL_T_P
                 ret = ERR_PARAM;
                 break;
             }
+            // served from shadow, nothing to be fetched from the board
+            if (shadowLookup(dl, param, values, &valuesOffset, true)) {
+                ret = ERR_NONE;
+                break;
+            }
             ret = GetParam_SndPayload_TYPE_ST25RU3993(param, values, &valuesOffset, sndPayload, &sndPayloadLen);
+            boardParam = true;
             break;
 
         default:
@@ -487,15 +547,16 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetMultipleParams(STUHFL_T_P
     }
 
     // Exchange all board relevant data..
-    if (!hostParam && ((STUHFL_T_POINTER2UINT)deviceCtx != (STUHFL_T_POINTER2UINT)NULL) && ((STUHFL_T_POINTER2UINT)deviceCtx != (STUHFL_T_POINTER2UINT)INVALID_HANDLE_VALUE)) {
-        ret = STUHFL_F_Snd_Dispatcher(deviceCtx, (STUHFL_CG_DL << 8) | STUHFL_CC_GET_PARAM, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
-        ret |= STUHFL_F_Rcv_Dispatcher(deviceCtx, rcvPayload, &rcvPayloadLen);
+    if (!hostParam && boardParam && ((STUHFL_T_POINTER2UINT)dl->deviceCtx != (STUHFL_T_POINTER2UINT)NULL) && ((STUHFL_T_POINTER2UINT)dl->deviceCtx != (STUHFL_T_POINTER2UINT)INVALID_HANDLE_VALUE)) {
+        ret = STUHFL_F_Snd_Dispatcher(dl->deviceCtx, (STUHFL_CG_DL << 8) | STUHFL_CC_GET_PARAM, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
+        ret |= STUHFL_F_Rcv_Dispatcher(dl->deviceCtx, rcvPayload, &rcvPayloadLen);
         ret |= STUHFL_F_Get_RcvStatus();
 
         // if succeeded get data
         if (ret == ERR_NONE) {
 
-            uint16_t rcvPayloadPos = 0;
+            STUHFL_T_TlvIter it;
+            tlvIterInit(&it, rcvPayload, rcvPayloadLen);
             valuesOffset = 0;
             for (uint32_t i = 0; i < paramCnt; i++) {
 
@@ -509,8 +570,12 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetMultipleParams(STUHFL_T_P
                     case STUHFL_PARAM_KEY_BR:
                     case STUHFL_PARAM_KEY_RD_TIMEOUT_MS:
                     case STUHFL_PARAM_KEY_WR_TIMEOUT_MS:
+                    case STUHFL_PARAM_KEY_RX_RESYNC_CNT:
+                    case STUHFL_PARAM_KEY_RX_DROPPED_BYTES:
                     case STUHFL_PARAM_KEY_DTR:
                     case STUHFL_PARAM_KEY_RTS:
+                    case STUHFL_PARAM_KEY_TX_QUEUE:
+                    case STUHFL_PARAM_KEY_SHADOW_CACHE:
                         // already handled..
                         break;
 
@@ -521,9 +586,17 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetMultipleParams(STUHFL_T_P
                     break;
                 }
 
-                case STUHFL_PARAM_TYPE_ST25RU3993:
-                    ret = GetParam_RcvPayload_TYPE_ST25RU3993(param, values, &valuesOffset, rcvPayload, (uint16_t)(rcvPayloadLen - rcvPayloadPos), &rcvPayloadPos);
+                case STUHFL_PARAM_TYPE_ST25RU3993: {
+                    uint16_t valueOffset = valuesOffset;
+                    if (!shadowLookup(dl, param, values, &valuesOffset, false)) {
+                        ret = GetParam_RcvPayload_TYPE_ST25RU3993(param, values, &valuesOffset, &it);
+                        // keep shadow in sync with what the board replied
+                        if (ret == ERR_NONE) {
+                            shadowStore(dl, param, values, &valueOffset);
+                        }
+                    }
                     break;
+                }
 
                 default:
                     ret = ERR_PARAM;
@@ -545,141 +618,408 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetMultipleParams(STUHFL_T_P
     return ret;
 }
 
+// - Command codec -----------------------------------------------------------
+// Each command is described once by the TLV it sends and the TLV it replies.
+// Commands that need more than a plain TLV copy provide their own decoder.
+
+#define CMD_FLAG_INVENTORY_ON       0x01    // inventory data is expected after this command
+#define CMD_FLAG_INVENTORY_OFF      0x02    // no more inventory data is expected after this command
+#define CMD_FLAG_CUSTOM             0x04    // payload is encoded and decoded outside of the codec
+
+typedef STUHFL_T_RET_CODE(*STUHFL_T_Cmd_Decode)(STUHFL_T_CMD_RCV_DATA rcvParams, STUHFL_T_TlvIter *it, bool *waitInventoryEnd);
+
+typedef struct {
+    STUHFL_T_TAG                        sndTag;     // TLV tag of the send parameters, 0 when sent without payload
+    uint16_t                            sndLen;     // size of the send parameters
+    uint16_t                            rcvLen;     // size of the received parameters, 0 when no data is replied
+    uint8_t                             flags;
+    STUHFL_T_Cmd_Decode                 decode;     // optional, replaces the plain TLV copy of the reply
+} STUHFL_T_Cmd_Desc;
+
+#define CMD_CODE_CNT                    0x20
+#define TAG_LIST_GROW_MIN               64      // first tagList size proposed to the inventory sink
+
+static STUHFL_T_RET_CODE decodeInventoryData(STUHFL_T_CMD_RCV_DATA rcvParams, STUHFL_T_TlvIter *it, bool *waitInventoryEnd);
+static STUHFL_T_RET_CODE decodeInventoryEnd(STUHFL_T_CMD_RCV_DATA rcvParams, STUHFL_T_TlvIter *it, bool *waitInventoryEnd);
+
+static const STUHFL_T_Cmd_Desc cmdDescs[STUHFL_CG_TS + 1][CMD_CODE_CNT] = {
+    [STUHFL_CG_GENERIC] = {
+        [STUHFL_CC_GET_VERSION]                 = { 0,                                  0,                                          0,  CMD_FLAG_CUSTOM, NULL },
+        [STUHFL_CC_GET_INFO]                    = { 0,                                  0,                                          0,  CMD_FLAG_CUSTOM, NULL },
+        [STUHFL_CC_UPGRADE]                     = { 0,                                  0,                                          0,  CMD_FLAG_CUSTOM, NULL },
+        [STUHFL_CC_ENTER_BOOTLOADER]            = { 0,                                  0,                                          0,  CMD_FLAG_CUSTOM, NULL },
+        [STUHFL_CC_REBOOT]                      = { 0,                                  0,                                          0,  CMD_FLAG_CUSTOM, NULL },
+    },
+    [STUHFL_CG_DL] = {
+        [STUHFL_CC_GET_PARAM]                   = { 0,                                  0,                                          0,  CMD_FLAG_CUSTOM, NULL },
+        [STUHFL_CC_SET_PARAM]                   = { 0,                                  0,                                          0,  CMD_FLAG_CUSTOM, NULL },
+        [STUHFL_CC_TUNE]                        = { STUHFL_TAG_TUNE,                    sizeof(STUHFL_T_ST25RU3993_Tune),           sizeof(STUHFL_T_ST25RU3993_Tune),           0, NULL },
+        [STUHFL_CC_TUNE_CHANNEL]                = { STUHFL_TAG_TUNE_CHANNEL,            sizeof(STUHFL_T_ST25RU3993_TuneCfg),        sizeof(STUHFL_T_ST25RU3993_ChannelList),    0, NULL },
+    },
+    [STUHFL_CG_AL] = {
+        [STUHFL_CC_INVENTORY_START]             = { STUHFL_TAG_INVENTORY_OPTION,        sizeof(STUHFL_T_Inventory_Option),          0,  CMD_FLAG_INVENTORY_ON, NULL },
+#ifdef USE_INVENTORY_EXT
+        [STUHFL_CC_INVENTORY_START_W_SLOT_STATISTICS] = { STUHFL_TAG_INVENTORY_OPTION,  sizeof(STUHFL_T_Inventory_Option),          0,  CMD_FLAG_INVENTORY_ON, NULL },
+#endif
+        [STUHFL_CC_INVENTORY_STOP]              = { 0,                                  0,                                          0,  CMD_FLAG_INVENTORY_OFF, NULL },
+        [STUHFL_CC_INVENTORY_DATA]              = { 0,                                  0,                                          0,  0, decodeInventoryData },
+    },
+    [STUHFL_CG_SL] = {
+        // Gen2
+        [STUHFL_CC_GEN2_INVENTORY]              = { STUHFL_TAG_GEN2_INVENTORY_OPTION,   sizeof(STUHFL_T_Inventory_Option),          0,  CMD_FLAG_INVENTORY_ON, decodeInventoryEnd },
+        [STUHFL_CC_GEN2_SELECT]                 = { STUHFL_TAG_GEN2_SELECT,             sizeof(STUHFL_T_Gen2_Select),               0,  0, NULL },
+        [STUHFL_CC_GEN2_READ]                   = { STUHFL_TAG_GEN2_READ,               sizeof(STUHFL_T_Read),                      sizeof(STUHFL_T_Read),                      0, NULL },
+        [STUHFL_CC_GEN2_WRITE]                  = { STUHFL_TAG_GEN2_WRITE,              sizeof(STUHFL_T_Write),                     sizeof(STUHFL_T_Write),                     0, NULL },
+        [STUHFL_CC_GEN2_BLOCKWRITE]             = { STUHFL_TAG_GEN2_BLOCKWRITE,         sizeof(STUHFL_T_BlockWrite),                sizeof(STUHFL_T_BlockWrite),                0, NULL },
+        [STUHFL_CC_GEN2_LOCK]                   = { STUHFL_TAG_GEN2_LOCK,               sizeof(STUHFL_T_Gen2_Lock),                 0,  0, NULL },
+        [STUHFL_CC_GEN2_KILL]                   = { STUHFL_TAG_GEN2_KILL,               sizeof(STUHFL_T_Kill),                      0,  0, NULL },
+        [STUHFL_CC_GEN2_GENERIC_CMD]            = { STUHFL_TAG_GEN2_GENERIC,            sizeof(STUHFL_T_Gen2_GenericCmdSnd),        sizeof(STUHFL_T_Gen2_GenericCmdRcv),        0, NULL },
+        [STUHFL_CC_GEN2_QUERY_MEASURE_RSSI_CMD] = { STUHFL_TAG_GEN2_QUERY_MEASURE_RSSI, sizeof(STUHFL_T_Gen2_QueryMeasureRssi),     sizeof(STUHFL_T_Gen2_QueryMeasureRssi),     0, NULL },
+        // ISO18000-6B
+        // GB29768
+        [STUHFL_CC_GB29768_INVENTORY]           = { STUHFL_TAG_GB29768_INVENTORY_OPTION, sizeof(STUHFL_T_Inventory_Option),         0,  CMD_FLAG_INVENTORY_ON, decodeInventoryEnd },
+        [STUHFL_CC_GB29768_SORT]                = { STUHFL_TAG_GB29768_SORT,            sizeof(STUHFL_T_Gb29768_Sort),              0,  0, NULL },
+        [STUHFL_CC_GB29768_READ]                = { STUHFL_TAG_GB29768_READ,            sizeof(STUHFL_T_Read),                      sizeof(STUHFL_T_Read),                      0, NULL },
+        [STUHFL_CC_GB29768_WRITE]               = { STUHFL_TAG_GB29768_WRITE,           sizeof(STUHFL_T_Write),                     sizeof(STUHFL_T_Write),                     0, NULL },
+        [STUHFL_CC_GB29768_LOCK]                = { STUHFL_TAG_GB29768_LOCK,            sizeof(STUHFL_T_Gb29768_Lock),              0,  0, NULL },
+        [STUHFL_CC_GB29768_KILL]                = { STUHFL_TAG_GB29768_KILL,            sizeof(STUHFL_T_Kill),                      0,  0, NULL },
+        [STUHFL_CC_GB29768_ERASE]               = { STUHFL_TAG_GB29768_ERASE,           sizeof(STUHFL_T_Gb29768_Erase),             0,  0, NULL },
+        [STUHFL_CC_GB29768_GENERIC_CMD]         = { 0,                                  0,                                          0,  CMD_FLAG_CUSTOM, NULL },
+    },
+};
+
+static const STUHFL_T_Cmd_Desc *cmdDesc(STUHFL_T_CMD cmd)
+{
+    uint8_t cg = (uint8_t)(cmd >> 8);
+    uint8_t c = (uint8_t)cmd;
+    if ((cg > STUHFL_CG_TS) || (c >= CMD_CODE_CNT)) {
+        return NULL;
+    }
+    return &cmdDescs[cg][c];
+}
+
+bool STUHFL_F_IsKnownCmd(STUHFL_T_CMD cmd)
+{
+    const STUHFL_T_Cmd_Desc *desc = cmdDesc(cmd);
+    return (desc != NULL) && ((desc->sndTag != 0) || (desc->rcvLen != 0) || (desc->flags != 0) || (desc->decode != NULL));
+}
+
+// inventory and runner commands reply with an undefined number of frames, custom ones are not handled by the codec
+static bool isPipelineCmd(STUHFL_T_CMD cmd)
+{
+    const STUHFL_T_Cmd_Desc *desc = cmdDesc(cmd);
+    if (!STUHFL_F_IsKnownCmd(cmd) || ((cmd >> 8) == STUHFL_CG_AL)) {
+        return false;
+    }
+    return (desc->flags & (CMD_FLAG_INVENTORY_ON | CMD_FLAG_INVENTORY_OFF | CMD_FLAG_CUSTOM)) == 0;
+}
+
 // --------------------------------------------------------------------------
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SendCmd(STUHFL_T_CMD cmd, STUHFL_T_CMD_SND_PARAMS sndParams)
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     STUHFL_T_RET_CODE ret = ERR_PARAM;
     TRACE_DL_LOG_START();
     uint8_t *sndPayload = STUHFL_F_Get_SndPayloadPtr();
     uint16_t sndPayloadLen = 0;
 
-    uint8_t cg = (uint8_t)(cmd >> 8);
-    uint8_t c = (uint8_t)cmd;
+    const STUHFL_T_Cmd_Desc *desc = cmdDesc(cmd);
+    if (desc != NULL) {
+        if (desc->flags & CMD_FLAG_INVENTORY_ON) {
+            dl->ignoreInventoryData = false;
+        }
+        if (desc->flags & CMD_FLAG_INVENTORY_OFF) {
+            dl->ignoreInventoryData = true;
+        }
+        if (desc->sndTag != 0) {
+            sndPayloadLen = addTlvExt(sndPayload, desc->sndTag, desc->sndLen, sndParams);
+        }
+    }
 
-    switch (cg) {
-    case STUHFL_CG_DL:
-        switch (c) {
-        case STUHFL_CC_TUNE:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_TUNE, sizeof(STUHFL_T_ST25RU3993_Tune), (STUHFL_T_ST25RU3993_Tune *)sndParams);
-            break;
-        case STUHFL_CC_TUNE_CHANNEL:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_TUNE_CHANNEL, sizeof(STUHFL_T_ST25RU3993_TuneCfg), (STUHFL_T_ST25RU3993_Tune *)sndParams);
-            break;
+    //
+    ret = STUHFL_F_Snd_Dispatcher(dl->deviceCtx, cmd, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
+    TRACE_DL_LOG("STUHFL_F_SendCmd(cmd = 0x%x, sndParams = 0x%x) = %d", cmd, sndParams, ret);
+    return ret;
+}
+// --------------------------------------------------------------------------
+static bool growTagList(STUHFL_T_DL_Ctx *dl, STUHFL_T_Inventory_Data *invData)
+{
+    uint32_t curMax = invData->tagListSizeMax;
+    uint32_t newMax = (curMax == 0U) ? TAG_LIST_GROW_MIN : ((curMax > (UINT32_MAX / 2U)) ? UINT32_MAX : (2U * curMax));
+    STUHFL_T_Inventory_Tag *list;
 
-        default:
-            break;
-        }
-        break;
+    if ((dl->invGrow == NULL) || (curMax == UINT32_MAX)) {
+        return false;
+    }
+    list = dl->invGrow(dl->invGrowCtx, invData->tagList, curMax, &newMax);
+    if ((list == NULL) || (newMax <= curMax)) {
+        return false;
+    }
+    invData->tagList = list;
+    invData->tagListSizeMax = newMax;
+    return true;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_SetInventorySink(STUHFL_T_InventoryGrow grow, void *userCtx)
+{
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
+    dl->invGrow = grow;
+    dl->invGrowCtx = userCtx;
+    TRACE_DL_LOG_START();
+    TRACE_DL_LOG("STUHFL_F_SetInventorySink(grow = 0x%x, userCtx = 0x%x) = %d", grow, userCtx, ERR_NONE);
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+#define TAG_BATCH_COLUMN_SIZE(cnt, type)    ((((cnt) * sizeof(type)) + (STUHFL_D_TAG_BATCH_ALIGN - 1U)) & ~(size_t)(STUHFL_D_TAG_BATCH_ALIGN - 1U))
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_AllocTagBatch(STUHFL_T_Inventory_Tag_Batch *batch, uint32_t tagCntMax, uint32_t epcDataSizeMax)
+{
+    size_t cnt = tagCntMax;
+    size_t size;
+    uint8_t *p;
+
+    if ((batch == NULL) || (tagCntMax == 0U)) {
+        return ERR_PARAM;
+    }
+    if (epcDataSizeMax == 0U) {
+        epcDataSizeMax = tagCntMax * MAX_EPC_LENGTH;
+    }
+    size = TAG_BATCH_COLUMN_SIZE(cnt, uint32_t)             // timestamp
+           + (6U * TAG_BATCH_COLUMN_SIZE(cnt, uint8_t))     // antenna, agc, rssiLogI/Q, rssiLinI/Q
+           + TAG_BATCH_COLUMN_SIZE(cnt, uint8_t)            // epcLen
+           + TAG_BATCH_COLUMN_SIZE(cnt + 1U, uint32_t)      // epcOffset
+           + TAG_BATCH_COLUMN_SIZE(epcDataSizeMax, uint8_t);
+
+    *batch = STUHFL_O_INVENTORY_TAG_BATCH_INIT();
+    batch->block = malloc(size + STUHFL_D_TAG_BATCH_ALIGN - 1U);
+    if (batch->block == NULL) {
+        return ERR_NOMEM;
+    }
+    p = (uint8_t *)(((uintptr_t)batch->block + (STUHFL_D_TAG_BATCH_ALIGN - 1U)) & ~(uintptr_t)(STUHFL_D_TAG_BATCH_ALIGN - 1U));
+    batch->timestamp = (uint32_t *)p;   p += TAG_BATCH_COLUMN_SIZE(cnt, uint32_t);
+    batch->antenna = p;                 p += TAG_BATCH_COLUMN_SIZE(cnt, uint8_t);
+    batch->agc = p;                     p += TAG_BATCH_COLUMN_SIZE(cnt, uint8_t);
+    batch->rssiLogI = p;                p += TAG_BATCH_COLUMN_SIZE(cnt, uint8_t);
+    batch->rssiLogQ = p;                p += TAG_BATCH_COLUMN_SIZE(cnt, uint8_t);
+    batch->rssiLinI = (int8_t *)p;      p += TAG_BATCH_COLUMN_SIZE(cnt, int8_t);
+    batch->rssiLinQ = (int8_t *)p;      p += TAG_BATCH_COLUMN_SIZE(cnt, int8_t);
+    batch->epcLen = p;                  p += TAG_BATCH_COLUMN_SIZE(cnt, uint8_t);
+    batch->epcOffset = (uint32_t *)p;   p += TAG_BATCH_COLUMN_SIZE(cnt + 1U, uint32_t);
+    batch->epcData = p;
+    batch->epcOffset[0] = 0;
+    batch->tagCntMax = tagCntMax;
+    batch->epcDataSizeMax = epcDataSizeMax;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_FreeTagBatch(STUHFL_T_Inventory_Tag_Batch *batch)
+{
+    if (batch == NULL) {
+        return ERR_PARAM;
+    }
+    free(batch->block);
+    *batch = STUHFL_O_INVENTORY_TAG_BATCH_INIT();
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_TagBatchAppend(void *batch, const STUHFL_T_Inventory_Tag_View *tag)
+{
+    STUHFL_T_Inventory_Tag_Batch *b = (STUHFL_T_Inventory_Tag_Batch *)batch;
+    uint32_t i;
+
+    if ((b == NULL) || (tag == NULL)) {
+        return ERR_PARAM;
+    }
+    i = b->tagCnt;
+    if ((i >= b->tagCntMax) || (tag->epc.len > (b->epcDataSizeMax - b->epcDataSize))) {
+        b->dropped++;
+        return ERR_NONE;
+    }
+    b->timestamp[i] = tag->timestamp;
+    b->antenna[i] = tag->antenna;
+    b->agc[i] = tag->agc;
+    b->rssiLogI[i] = tag->rssiLogI;
+    b->rssiLogQ[i] = tag->rssiLogQ;
+    b->rssiLinI[i] = tag->rssiLinI;
+    b->rssiLinQ[i] = tag->rssiLinQ;
+    b->epcLen[i] = (uint8_t)tag->epc.len;
+    b->epcOffset[i] = b->epcDataSize;
+    memcpy(&b->epcData[b->epcDataSize], tag->epc.data, tag->epc.len);
+    b->epcDataSize += tag->epc.len;
+    b->epcOffset[i + 1U] = b->epcDataSize;
+    b->tagCnt++;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE decodeInventoryData(STUHFL_T_CMD_RCV_DATA rcvParams, STUHFL_T_TlvIter *it, bool *waitInventoryEnd)
+{
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
+    STUHFL_T_Tlv tlv;
+
+    (void)waitInventoryEnd;
+
+    if (dl->ignoreInventoryData) {
+        return ERR_NONE;
+    }
 
-    case STUHFL_CG_AL:
-        switch (c) {
-        case STUHFL_CC_INVENTORY_START:
 #ifdef USE_INVENTORY_EXT
-        case STUHFL_CC_INVENTORY_START_W_SLOT_STATISTICS:
+    STUHFL_T_Inventory_Data *invData = &((STUHFL_T_Inventory_Data_Ext*)rcvParams)->invData;
+    STUHFL_T_Inventory_Slot_Info_Data *slotData = &((STUHFL_T_Inventory_Data_Ext*)rcvParams)->invSlotInfoData;
+#else
+    STUHFL_T_Inventory_Data *invData = rcvParams;
 #endif
-            gIgnoreInventoryData = false;
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_INVENTORY_OPTION, sizeof(STUHFL_T_Inventory_Option), (STUHFL_T_Inventory_Option *)sndParams);
-            break;
 
-        case STUHFL_CC_INVENTORY_STOP:
-            gIgnoreInventoryData = true;
-            break;
+    while (tlvIterNext(it, &tlv)) {
+        // tag TLVs are stored at tagListSize until TAG_FINISHED, a tag that has no room is skipped
+        uint32_t tagIdx = invData->tagListSize;
+        bool tagRoom = (tagIdx < invData->tagListSizeMax);
 
-        case STUHFL_CC_INVENTORY_DATA:
-            break;
+        switch (tlv.tag) {
 
-        default:
+        case STUHFL_TAG_INVENTORY_STATISTICS:
+            tlvCopy(&tlv, &invData->statistics, sizeof(STUHFL_T_Inventory_Statistics));
             break;
-        }
-        break;
 
-    case STUHFL_CG_SL:
-        switch (c) {
-        // Gen2
-        case STUHFL_CC_GEN2_INVENTORY:
-            gIgnoreInventoryData = false;
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GEN2_INVENTORY_OPTION, sizeof(STUHFL_T_Inventory_Option), (STUHFL_T_Inventory_Option *)sndParams);
-            break;
-        case STUHFL_CC_GEN2_SELECT:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GEN2_SELECT, sizeof(STUHFL_T_Gen2_Select), (STUHFL_T_Gen2_Select *)sndParams);
-            break;
-        case STUHFL_CC_GEN2_READ:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GEN2_READ, sizeof(STUHFL_T_Read), (STUHFL_T_Read *)sndParams);
-            break;
-        case STUHFL_CC_GEN2_WRITE:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GEN2_WRITE, sizeof(STUHFL_T_Write), (STUHFL_T_Write *)sndParams);
-            break;
-        case STUHFL_CC_GEN2_BLOCKWRITE:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GEN2_BLOCKWRITE, sizeof(STUHFL_T_BlockWrite), (STUHFL_T_BlockWrite *)sndParams);
-            break;
-        case STUHFL_CC_GEN2_LOCK:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GEN2_LOCK, sizeof(STUHFL_T_Gen2_Lock), (STUHFL_T_Gen2_Lock *)sndParams);
-            break;
-        case STUHFL_CC_GEN2_KILL:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GEN2_KILL, sizeof(STUHFL_T_Kill), (STUHFL_T_Kill *)sndParams);
-            break;
-        case STUHFL_CC_GEN2_GENERIC_CMD:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GEN2_GENERIC, sizeof(STUHFL_T_Gen2_GenericCmdSnd), (STUHFL_T_Gen2_GenericCmdSnd *)sndParams);
-            break;
-        case STUHFL_CC_GEN2_QUERY_MEASURE_RSSI_CMD:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GEN2_QUERY_MEASURE_RSSI, sizeof(STUHFL_T_Gen2_QueryMeasureRssi), (STUHFL_T_Gen2_QueryMeasureRssi *)sndParams);
+        case STUHFL_TAG_INVENTORY_TAG_INFO_HEADER:
+            if (!tagRoom) {
+                tagRoom = growTagList(dl, invData);
+            }
+            if (tagRoom) {
+                tlvCopy(&tlv, &invData->tagList[tagIdx], sizeof(STUHFL_T_Inventory_Tag));
+            }
             break;
 
-        // ISO18000-6B
-        // GB29768
-        case STUHFL_CC_GB29768_INVENTORY:
-            gIgnoreInventoryData = false;
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GB29768_INVENTORY_OPTION, sizeof(STUHFL_T_Inventory_Option), (STUHFL_T_Inventory_Option *)sndParams);
-            break;
-        case STUHFL_CC_GB29768_SORT:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GB29768_SORT, sizeof(STUHFL_T_Gb29768_Sort), (STUHFL_T_Gb29768_Sort *)sndParams);
+        case STUHFL_TAG_INVENTORY_TAG_EPC:
+            if (tagRoom) {
+                invData->tagList[tagIdx].epc.len = (uint8_t)tlvCopy(&tlv, invData->tagList[tagIdx].epc.data, MAX_EPC_LENGTH);
+            }
             break;
-        case STUHFL_CC_GB29768_READ:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GB29768_READ, sizeof(STUHFL_T_Read), (STUHFL_T_Read *)sndParams);
+
+        case STUHFL_TAG_INVENTORY_TAG_TID:
+            if (tagRoom) {
+                invData->tagList[tagIdx].tid.len = (uint8_t)tlvCopy(&tlv, invData->tagList[tagIdx].tid.data, MAX_TID_LENGTH);
+            }
             break;
-        case STUHFL_CC_GB29768_WRITE:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GB29768_WRITE, sizeof(STUHFL_T_Write), (STUHFL_T_Write *)sndParams);
+
+        case STUHFL_TAG_INVENTORY_TAG_XPC:
+            if (tagRoom) {
+                invData->tagList[tagIdx].xpc.len = (uint8_t)tlvCopy(&tlv, invData->tagList[tagIdx].xpc.data, MAX_XPC_LENGTH);
+            }
             break;
-        case STUHFL_CC_GB29768_LOCK:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GB29768_LOCK, sizeof(STUHFL_T_Gb29768_Lock), (STUHFL_T_Gb29768_Lock *)sndParams);
+
+        case STUHFL_TAG_INVENTORY_TAG_FINISHED:
+            if (tagRoom) {
+                invData->tagListSize++;
+                if (invData->tagListSize > invData->tagListSizeHighWater) {
+                    invData->tagListSizeHighWater = invData->tagListSize;
+                }
+            } else {
+                invData->tagListDropped++;
+            }
             break;
-        case STUHFL_CC_GB29768_KILL:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GB29768_KILL, sizeof(STUHFL_T_Kill), (STUHFL_T_Kill *)sndParams);
+
+#ifdef USE_INVENTORY_EXT
+        //
+        case  STUHFL_TAG_INVENTORY_SLOT_INFO_SYNC:
+            tlvCopy(&tlv, &slotData->slotSync, sizeof(STUHFL_T_Inventory_Slot_Info_Sync));
+            slotData->slotInfoListSize = 0;
             break;
-        case STUHFL_CC_GB29768_ERASE:
-            sndPayloadLen = addTlvExt(sndPayload, STUHFL_TAG_GB29768_ERASE, sizeof(STUHFL_T_Gb29768_Erase), (STUHFL_T_Gb29768_Erase *)sndParams);
+
+        case STUHFL_TAG_INVENTORY_SLOT_INFO:
+            if (slotData->slotInfoListSize < INVENTORYREPORT_SLOT_INFO_LIST_SIZE) {
+                tlvCopy(&tlv, &slotData->slotInfoList[slotData->slotInfoListSize++], sizeof(STUHFL_T_Inventory_Slot_Info));
+                if (slotData->slotInfoListSize > slotData->slotInfoListSizeHighWater) {
+                    slotData->slotInfoListSizeHighWater = slotData->slotInfoListSize;
+                }
+            } else {
+                slotData->slotInfoDropped++;
+            }
             break;
+#endif  // USE_INVENTORY_EXT
+
         default:
             break;
         }
-        break;
+    }
+    return it->overrun ? ERR_PROTO : ERR_NONE;
+}
 
-    default:
-        break;
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE decodeInventoryEnd(STUHFL_T_CMD_RCV_DATA rcvParams, STUHFL_T_TlvIter *it, bool *waitInventoryEnd)
+{
+    // final reply of a Gen2Inventory/Gb29768Inventory, all tags were delivered as INVENTORY_DATA before
+    (void)rcvParams;
+    (void)it;
+    *waitInventoryEnd = false;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE decodeRcvCmdData(STUHFL_T_CMD cmd, STUHFL_T_CMD_RCV_DATA rcvParams, uint8_t *rcvPayload, uint16_t rcvPayloadLen, bool *waitInventoryEnd)
+{
+    STUHFL_T_TlvIter it;
+    STUHFL_T_Tlv tlv;
+
+    // in case we are waiting for a Gen2Inventory/Gb29768Inventory reply we get on our way a
+    // possible many STUHFL_CC_INVENTORY_DATA replies.
+    if (*waitInventoryEnd) {
+        if (STUHFL_F_Get_RcvCmd() == ((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA)) {
+            // divert cmd because FW do not distinguish here
+            // and reply always with STUHFL_CG_AL and STUHFL_CC_INVENTORY_DATA
+            cmd = (STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA;
+        }
+    } else {
+        // in all other cases verify that received data matches to expected cmd
+        if (STUHFL_F_Get_RcvCmd() != cmd) {
+            return ERR_IO;
+        }
     }
 
-    //
-    ret = STUHFL_F_Snd_Dispatcher(deviceCtx, cmd, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
-    TRACE_DL_LOG("STUHFL_F_SendCmd(cmd = 0x%x, sndParams = 0x%x) = %d", cmd, sndParams, ret);
+    const STUHFL_T_Cmd_Desc *desc = cmdDesc(cmd);
+    if (desc == NULL) {
+        return ERR_NONE;
+    }
+
+    tlvIterInit(&it, rcvPayload, rcvPayloadLen);
+    if (desc->decode) {
+        return desc->decode(rcvParams, &it, waitInventoryEnd);
+    }
+    if ((desc->rcvLen != 0) && tlvIterNext(&it, &tlv)) {
+        tlvCopy(&tlv, rcvParams, desc->rcvLen);
+    }
+    return it.overrun ? ERR_PROTO : ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+// receive the next frame, replies to commands the runner sent in between are completed on the way
+static STUHFL_T_RET_CODE rcvFrame(STUHFL_T_DL_Ctx *dl, uint8_t *rcvPayload, uint16_t *rcvPayloadLen)
+{
+    STUHFL_T_RET_CODE ret;
+    do {
+        ret = STUHFL_F_Rcv_Dispatcher(dl->deviceCtx, rcvPayload, rcvPayloadLen);
+    } while (asyncRouteReply(dl, ret, rcvPayload, *rcvPayloadLen));
     return ret;
 }
+
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ReceiveCmdData(STUHFL_T_CMD cmd, STUHFL_T_CMD_RCV_DATA rcvParams)
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     STUHFL_T_RET_CODE ret = ERR_PARAM;
     TRACE_DL_LOG_START();
     uint8_t *rcvPayload = STUHFL_F_Get_RcvPayloadPtr();
     uint16_t rcvPayloadLen = 0;
-    uint8_t tag;
-    uint16_t len;
 
-    uint8_t cg = (uint8_t)(cmd >> 8);
-    uint8_t c = (uint8_t)cmd;
     bool waitInventoryEnd = (cmd == ((STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_INVENTORY)) || (cmd == ((STUHFL_CG_SL << 8) | STUHFL_CC_GB29768_INVENTORY));
 
     do {
         //
-        ret = STUHFL_F_Rcv_Dispatcher(deviceCtx, rcvPayload, &rcvPayloadLen);
-        if ((cmd == ((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA)) && gIgnoreInventoryData)  {
+        ret = rcvFrame(dl, rcvPayload, &rcvPayloadLen);
+        if ((cmd == ((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA)) && dl->ignoreInventoryData)  {
             ret =  ERR_IO;          // RUNNERSTOP is on going, no more INVENTORYDATA is expected: generate error
         } else {
             ret |= STUHFL_F_Get_RcvStatus();
@@ -689,178 +1029,8 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ReceiveCmdData(STUHFL_T_CMD
             break;
         }
 
-
-        // in case we are waiting for a Gen2Inventory/Gb29768Inventory reply we get on our way a
-        // possible many STUHFL_CC_INVENTORY_DATA replies.
-        if(waitInventoryEnd) {
-            if (STUHFL_F_Get_RcvCmd() == ((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA)) {
-                // divert cg and c because FW do not distinguish here
-                // and reply always with STUHFL_CG_AL and STUHFL_CC_INVENTORY_DATA
-                cg = STUHFL_CG_AL;
-                c = STUHFL_CC_INVENTORY_DATA;
-            } else {
-                cg = (uint8_t)(cmd >> 8);
-                c = (uint8_t)cmd;
-            }
-
-        } else {
-            // in all other cases verify that received data matches to expected cmd
-            if (STUHFL_F_Get_RcvCmd() != cmd) {
-                ret = ERR_IO;
-                break;
-            }
-        }
-
-        switch (cg) {
-        case STUHFL_CG_DL:
-            switch (c) {
-            case STUHFL_CC_TUNE: {
-                STUHFL_T_ST25RU3993_Tune *tune = rcvParams;
-                getTlvExt(rcvPayload, &tag, &len, tune);
-                break;
-            }
-            case STUHFL_CC_TUNE_CHANNEL: {
-                STUHFL_T_ST25RU3993_ChannelList *channelList = rcvParams;
-                getTlvExt(rcvPayload, &tag, &len, channelList);
-                break;
-            }
-            default:
-                break;
-            }
-            break;
-        case STUHFL_CG_AL:
-            switch (c) {
-
-            default:
-            case STUHFL_CC_INVENTORY_STOP:
-            case STUHFL_CC_INVENTORY_START:
-#ifdef USE_INVENTORY_EXT
-            case STUHFL_CC_INVENTORY_START_W_SLOT_STATISTICS:
-#endif
-                // no data replied here
-                break;
-
-            case STUHFL_CC_INVENTORY_DATA: {
-                if (gIgnoreInventoryData) {
-                    break;
-                }
-
-#ifdef USE_INVENTORY_EXT
-                STUHFL_T_Inventory_Data *invData = &((STUHFL_T_Inventory_Data_Ext*)rcvParams)->invData;
-                STUHFL_T_Inventory_Slot_Info_Data *slotData = &((STUHFL_T_Inventory_Data_Ext*)rcvParams)->invSlotInfoData;
-#else
-                STUHFL_T_Inventory_Data *invData = rcvParams;
-#endif
-    
-                uint16_t rcvPayloadOffset = 0;
-                while (rcvPayloadOffset < rcvPayloadLen) {
-                    tag = getTlvTag(&rcvPayload[rcvPayloadOffset]);
-                    len = 0;
-
-                    uint16_t tagIdx = (invData->tagListSize < invData->tagListSizeMax) ? invData->tagListSize : (uint16_t)(invData->tagListSizeMax-1U);
-
-                    switch (tag) {
-
-                    case STUHFL_TAG_INVENTORY_STATISTICS:
-                        rcvPayloadOffset = (uint16_t)(rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[rcvPayloadOffset], &tag, &len, &invData->statistics));
-                        break;
-
-                    case STUHFL_TAG_INVENTORY_TAG_INFO_HEADER:
-                        rcvPayloadOffset = (uint16_t)(rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[rcvPayloadOffset], &tag, &len, &invData->tagList[tagIdx]));
-                        break;
-
-                    case STUHFL_TAG_INVENTORY_TAG_EPC:
-                        rcvPayloadOffset = (uint16_t)(rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[rcvPayloadOffset], &tag, &len, &invData->tagList[tagIdx].epc.data));
-                        invData->tagList[tagIdx].epc.len = (uint8_t)len;
-                        break;
-
-                    case STUHFL_TAG_INVENTORY_TAG_TID:
-                        rcvPayloadOffset = (uint16_t)(rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[rcvPayloadOffset], &tag, &len, &invData->tagList[tagIdx].tid.data));
-                        invData->tagList[tagIdx].tid.len = (uint8_t)len;
-                        break;
-
-                    case STUHFL_TAG_INVENTORY_TAG_XPC:
-                        rcvPayloadOffset = (uint16_t)(rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[rcvPayloadOffset], &tag, &len, &invData->tagList[tagIdx].xpc.data));
-                        invData->tagList[tagIdx].xpc.len = (uint8_t)len;
-                        break;
-
-                    case STUHFL_TAG_INVENTORY_TAG_FINISHED:
-                        rcvPayloadOffset = (uint16_t)(rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[rcvPayloadOffset], &tag, &len, NULL));
-                        if (invData->tagListSize < invData->tagListSizeMax) {
-                            invData->tagListSize++;
-                        }
-                        break;
-
-#ifdef USE_INVENTORY_EXT
-                    //
-                    case  STUHFL_TAG_INVENTORY_SLOT_INFO_SYNC:
-                        rcvPayloadOffset = (uint16_t)(rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[rcvPayloadOffset], &tag, &len, &slotData->slotSync));
-                        slotData->slotInfoListSize = 0;
-                        break;
-
-                    case STUHFL_TAG_INVENTORY_SLOT_INFO:
-                        rcvPayloadOffset = (uint16_t)(rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[rcvPayloadOffset], &tag, &len, &slotData->slotInfoList[slotData->slotInfoListSize++]));
-                        break;
-#endif  // USE_INVENTORY_EXT
-
-                    default:
-                        break;
-                    }
-                }
-                break;
-              }
-            }
-            break;
-
-        case STUHFL_CG_SL:
-            switch (c) {
-            case STUHFL_CC_GB29768_INVENTORY:   /* Pass through */
-            case STUHFL_CC_GEN2_INVENTORY: {
-                waitInventoryEnd = false;
-                break;
-            }
-
-            case STUHFL_CC_GB29768_READ:    /* Pass through */
-            case STUHFL_CC_GEN2_READ: {
-                STUHFL_T_Read *readData = rcvParams;
-                getTlvExt(rcvPayload, &tag, &len, readData);
-                break;
-            }
-            case STUHFL_CC_GB29768_WRITE:    /* Pass through */
-            case STUHFL_CC_GEN2_WRITE: {
-                STUHFL_T_Write *writeData = rcvParams;
-                getTlvExt(rcvPayload, &tag, &len, writeData);
-                break;
-            }
-            case STUHFL_CC_GEN2_BLOCKWRITE: {
-                STUHFL_T_BlockWrite *blockWrite = rcvParams;
-                getTlvExt(rcvPayload, &tag, &len, blockWrite);
-                break;
-            }
-            case STUHFL_CC_GEN2_GENERIC_CMD: {
-                STUHFL_T_Gen2_GenericCmdRcv *rcvData = rcvParams;
-                getTlvExt(rcvPayload, &tag, &len, rcvData);
-                break;
-            }
-            case STUHFL_CC_GEN2_QUERY_MEASURE_RSSI_CMD: {
-                STUHFL_T_Gen2_QueryMeasureRssi *rssiData = rcvParams;
-                getTlvExt(rcvPayload, &tag, &len, rssiData);
-                break;
-            }
-
-            case STUHFL_CC_GB29768_SORT:
-            case STUHFL_CC_GEN2_SELECT:
-            case STUHFL_CC_GB29768_LOCK:
-            case STUHFL_CC_GEN2_LOCK:
-            case STUHFL_CC_GB29768_KILL:
-            case STUHFL_CC_GEN2_KILL:
-            case STUHFL_CC_GB29768_ERASE:
-            default:
-                break;
-            }
-            break;
-
-        default:
+        ret = decodeRcvCmdData(cmd, rcvParams, rcvPayload, rcvPayloadLen, &waitInventoryEnd);
+        if (ret != ERR_NONE) {
             break;
         }
 
@@ -879,9 +1049,491 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ExecuteCmd(STUHFL_T_CMD cmd,
 }
 
 // --------------------------------------------------------------------------
-STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetVersionOld(uint8_t *swVersion)
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ReceiveInventoryViews(STUHFL_T_InventoryTagView tagCallback, STUHFL_T_InventoryStatisticsView statisticsCallback, void *userCtx, STUHFL_T_Inventory_Statistics *statistics)
 {
-
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
+    STUHFL_T_RET_CODE ret = ERR_PARAM;
+    TRACE_DL_LOG_START();
+    uint8_t *rcvPayload = STUHFL_F_Get_RcvPayloadPtr();
+    uint16_t rcvPayloadLen = 0;
+
+    if (tagCallback == NULL) {
+        return ERR_PARAM;
+    }
+
+    ret = rcvFrame(dl, rcvPayload, &rcvPayloadLen);
+    if (dl->ignoreInventoryData) {
+        ret = ERR_IO;               // RUNNERSTOP is on going, no more INVENTORYDATA is expected: generate error
+    } else {
+        ret |= STUHFL_F_Get_RcvStatus();
+    }
+    if ((ret == ERR_NONE) && (STUHFL_F_Get_RcvCmd() != ((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA))) {
+        ret = ERR_IO;
+    }
+
+    STUHFL_T_Inventory_Tag_View tagView = STUHFL_O_INVENTORY_TAG_VIEW_INIT();
+    STUHFL_T_TlvIter it;
+    STUHFL_T_Tlv tlv;
+    tlvIterInit(&it, rcvPayload, rcvPayloadLen);
+    while ((ret == ERR_NONE) && tlvIterNext(&it, &tlv)) {
+        STUHFL_T_Data_View value = { .data = tlv.value, .len = tlv.len };
+
+        switch (tlv.tag) {
+        case STUHFL_TAG_INVENTORY_STATISTICS:
+            tlvCopy(&tlv, statistics, sizeof(STUHFL_T_Inventory_Statistics));
+            if (statisticsCallback) {
+                ret = statisticsCallback(userCtx, statistics);
+            }
+            break;
+        case STUHFL_TAG_INVENTORY_TAG_INFO_HEADER:
+            // header fields are few bytes of fixed size, these are decoded by value
+            tlvCopy(&tlv, &tagView, offsetof(STUHFL_T_Inventory_Tag_View, xpc));
+            break;
+        case STUHFL_TAG_INVENTORY_TAG_EPC:
+            tagView.epc = value;
+            break;
+        case STUHFL_TAG_INVENTORY_TAG_TID:
+            tagView.tid = value;
+            break;
+        case STUHFL_TAG_INVENTORY_TAG_XPC:
+            tagView.xpc = value;
+            break;
+        case STUHFL_TAG_INVENTORY_TAG_FINISHED:
+            STUHFL_F_EpcKeyFromBytes(&tagView.epcKey, tagView.epc.data, (uint8_t)tagView.epc.len);
+            ret = tagCallback(userCtx, &tagView);
+            tagView = STUHFL_O_INVENTORY_TAG_VIEW_INIT();
+            break;
+        default:
+            break;
+        }
+    }
+    if ((ret == ERR_NONE) && it.overrun) {
+        ret = ERR_PROTO;
+    }
+
+    TRACE_DL_LOG("STUHFL_F_ReceiveInventoryViews(tagCallback = 0x%x, statisticsCallback = 0x%x, userCtx = 0x%x, statistics = 0x%x) = %d", tagCallback, statisticsCallback, userCtx, statistics, ret);
+    return ret;
+}
+
+// --------------------------------------------------------------------------
+#define PIPELINE_UNRELATED_MAX  STUHFL_D_PIPELINE_WINDOW_MAX    // unrelated frames tolerated per completion
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ExecuteCmdPipelined(STUHFL_T_Cmd_Pipeline_Entry *cmds, uint16_t cmdCnt, uint8_t window)
+{
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
+    STUHFL_T_RET_CODE ret = ERR_NONE;
+    uint8_t *rcvPayload = STUHFL_F_Get_RcvPayloadPtr();
+    uint16_t pendingID[STUHFL_D_PIPELINE_WINDOW_MAX];
+    uint16_t pendingIdx[STUHFL_D_PIPELINE_WINDOW_MAX];
+    uint8_t pendingCnt = 0;     // commands in flight, oldest first
+    uint16_t nextIdx = 0;
+    uint16_t doneCnt = 0;
+    uint8_t unrelatedCnt = 0;   // frames matching no command in flight since the last completion
+
+    if ((cmds == NULL) || (window == 0)) {
+        return ERR_PARAM;
+    }
+    if (window > STUHFL_D_PIPELINE_WINDOW_MAX) {
+        window = STUHFL_D_PIPELINE_WINDOW_MAX;
+    }
+
+    for (uint16_t i = 0; i < cmdCnt; i++) {
+        if (!isPipelineCmd(cmds[i].cmd)) {
+            return ERR_PARAM;
+        }
+        cmds[i].ret = ERR_NOMSG;
+    }
+
+    while (doneCnt < cmdCnt) {
+        // fill up the window
+        while ((nextIdx < cmdCnt) && (pendingCnt < window)) {
+            cmds[nextIdx].ret = STUHFL_F_SendCmd(cmds[nextIdx].cmd, cmds[nextIdx].sndParams);
+            if (cmds[nextIdx].ret != ERR_NONE) {
+                ret |= cmds[nextIdx].ret;
+                doneCnt++;
+            } else {
+                pendingID[pendingCnt] = STUHFL_F_Get_SndID();
+                pendingIdx[pendingCnt] = nextIdx;
+                pendingCnt++;
+            }
+            nextIdx++;
+        }
+        if (pendingCnt == 0) {
+            continue;
+        }
+
+        // receive next reply
+        uint16_t rcvPayloadLen = 0;
+        STUHFL_T_RET_CODE rcvRet = STUHFL_F_Rcv_Dispatcher(dl->deviceCtx, rcvPayload, &rcvPayloadLen);
+        uint8_t slot = pendingCnt;
+        if ((rcvRet == ERR_NONE) || (rcvRet == ERR_PROTO)) {
+            // match reply to command in flight
+            uint16_t id = STUHFL_F_Get_RcvID();
+            for (uint8_t i = 0; i < pendingCnt; i++) {
+                if (pendingID[i] == id) {
+                    slot = i;
+                    break;
+                }
+            }
+            if (slot == pendingCnt) {
+                // corrupted or unrelated frame, a few stale replies are skipped before the oldest command is given up
+                TRACE_DL_LOG_START();
+                TRACE_DL_LOG("STUHFL_F_ExecuteCmdPipelined: ignoring reply (ret = %d)", rcvRet);
+                if (++unrelatedCnt <= PIPELINE_UNRELATED_MAX) {
+                    continue;
+                }
+                slot = 0;
+                rcvRet = ERR_PROTO;
+            }
+        } else if (rcvRet == ERR_IO) {
+            // link is gone, none of the remaining commands will be answered
+            while (nextIdx < cmdCnt) {
+                cmds[nextIdx++].ret = ERR_IO;
+                doneCnt++;
+            }
+            for (uint8_t i = 0; i < pendingCnt; i++) {
+                cmds[pendingIdx[i]].ret = ERR_IO;
+                doneCnt++;
+            }
+            pendingCnt = 0;
+            ret |= ERR_IO;
+            break;
+        } else {
+            // no reply within timeout or receive error, the oldest command is lost
+            slot = 0;
+        }
+
+        STUHFL_T_Cmd_Pipeline_Entry *entry = &cmds[pendingIdx[slot]];
+        if (rcvRet == ERR_NONE) {
+            rcvRet = STUHFL_F_Get_RcvStatus();
+        }
+        if (rcvRet == ERR_NONE) {
+            bool waitInventoryEnd = false;
+            rcvRet = decodeRcvCmdData(entry->cmd, entry->rcvParams, rcvPayload, rcvPayloadLen, &waitInventoryEnd);
+        }
+        entry->ret = rcvRet;
+        ret |= rcvRet;
+        doneCnt++;
+        unrelatedCnt = 0;
+
+        // remove from window
+        pendingCnt--;
+        for (uint8_t i = slot; i < pendingCnt; i++) {
+            pendingID[i] = pendingID[i + 1U];
+            pendingIdx[i] = pendingIdx[i + 1U];
+        }
+    }
+
+    TRACE_DL_LOG_START();
+    TRACE_DL_LOG("STUHFL_F_ExecuteCmdPipelined(cmds = 0x%x, cmdCnt = %d, window = %d) = %d", cmds, cmdCnt, window, ret);
+    return ret;
+}
+
+// --------------------------------------------------------------------------
+#define ASYNC_IDLE_WAIT     1000    // ms, I/O thread rechecks its exit request at least this often
+
+static void asyncComplete(STUHFL_T_DL_Ctx *dl, STUHFL_T_Cmd_Async *async, STUHFL_T_RET_CODE ret)
+{
+    if (async->done) {
+        // nobody waits on entries with callback, it is the last access and may release the entry
+        async->ret = ret;
+        async->completed = 1;
+        async->done(async);
+        return;
+    }
+    STUHFL_MUTEX_LOCK(&dl->asyncLock);
+    async->ret = ret;
+    async->completed = 1;
+    STUHFL_COND_BROADCAST(&dl->asyncCond);
+    STUHFL_MUTEX_UNLOCK(&dl->asyncLock);
+}
+
+static STUHFL_T_Cmd_Async* asyncServedRemove(STUHFL_T_DL_Ctx *dl, uint8_t slot)
+{
+    STUHFL_T_Cmd_Async *async = dl->asyncServed[slot];
+
+    dl->asyncServedCnt--;
+    for (uint8_t i = slot; i < dl->asyncServedCnt; i++) {
+        dl->asyncServed[i] = dl->asyncServed[i + 1U];
+        dl->asyncServedID[i] = dl->asyncServedID[i + 1U];
+        dl->asyncServedTime[i] = dl->asyncServedTime[i + 1U];
+    }
+    return async;
+}
+
+// complete the commands sent by the runner which got no reply within the receive timeout, all of them on link loss
+static void asyncServedExpire(STUHFL_T_Reader_Ctx *ctx, bool linkLost)
+{
+    STUHFL_T_DL_Ctx *dl = &ctx->dl;
+    uint8_t slot = 0;
+
+    while (slot < dl->asyncServedCnt) {
+        if (linkLost) {
+            asyncComplete(dl, asyncServedRemove(dl, slot), ERR_IO);
+        } else if (getMilliSpan(dl->asyncServedTime[slot]) >= ctx->bl.rdComTimeout) {
+            asyncComplete(dl, asyncServedRemove(dl, slot), ERR_TIMEOUT);
+        } else {
+            slot++;
+        }
+    }
+}
+
+static bool asyncRouteReply(STUHFL_T_DL_Ctx *dl, STUHFL_T_RET_CODE rcvRet, uint8_t *rcvPayload, uint16_t rcvPayloadLen)
+{
+    if ((dl->asyncServedCnt == 0) || ((rcvRet != ERR_NONE) && (rcvRet != ERR_PROTO))
+            || (STUHFL_F_Get_RcvCmd() == ((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA))) {
+        return false;
+    }
+
+    // match reply to command in flight, as for pipelining
+    uint16_t id = STUHFL_F_Get_RcvID();
+    for (uint8_t slot = 0; slot < dl->asyncServedCnt; slot++) {
+        if (dl->asyncServedID[slot] == id) {
+            STUHFL_T_Cmd_Async *async = asyncServedRemove(dl, slot);
+            if (rcvRet == ERR_NONE) {
+                rcvRet = STUHFL_F_Get_RcvStatus();
+            }
+            if (rcvRet == ERR_NONE) {
+                bool waitInventoryEnd = false;
+                rcvRet = decodeRcvCmdData(async->cmd, async->rcvParams, rcvPayload, rcvPayloadLen, &waitInventoryEnd);
+            }
+            asyncComplete(dl, async, rcvRet);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void* CALL_CONV_STD threadAsyncFunc(void *ptr)
+{
+    // I/O thread operates on the reader that started it
+    STUHFL_T_Reader_Ctx *ctx = (STUHFL_T_Reader_Ctx *)ptr;
+    STUHFL_F_SelectReaderCtx(ctx);
+
+    STUHFL_T_DL_Ctx *dl = &ctx->dl;
+    STUHFL_T_AL_Ctx *al = &ctx->al;
+    STUHFL_T_Cmd_Async *batch[STUHFL_D_PIPELINE_WINDOW_MAX];
+    STUHFL_T_Cmd_Pipeline_Entry entries[STUHFL_D_PIPELINE_WINDOW_MAX];
+
+    for (;;) {
+        uint8_t cnt = 0;
+
+        STUHFL_MUTEX_LOCK(&dl->asyncLock);
+        while ((dl->asyncHead == NULL) && !dl->asyncExit) {
+            STUHFL_F_CondWait(&dl->asyncCond, &dl->asyncLock, ASYNC_IDLE_WAIT);
+        }
+        bool exitRequested = dl->asyncExit;
+        STUHFL_MUTEX_UNLOCK(&dl->asyncLock);
+        if (exitRequested) {
+            break;
+        }
+
+        // the runner owns the port, it sends the queued commands in between its frames.
+        // Otherwise the port is claimed for the batch, a runner start waits until it is handed back
+        bool runnerActive;
+        STUHFL_MUTEX_LOCK(&al->runnerLock);
+        runnerActive = al->runnerClaimed;
+        if (runnerActive) {
+            STUHFL_F_CondWait(&al->runnerDoneCond, &al->runnerLock, ASYNC_IDLE_WAIT);
+        } else {
+            al->asyncBatchActive = true;
+        }
+        STUHFL_MUTEX_UNLOCK(&al->runnerLock);
+        if (runnerActive) {
+            continue;
+        }
+
+        // take as many commands as can be pipelined
+        STUHFL_MUTEX_LOCK(&dl->asyncLock);
+        while ((dl->asyncHead != NULL) && (cnt < STUHFL_D_PIPELINE_WINDOW_MAX)) {
+            batch[cnt++] = dl->asyncHead;
+            dl->asyncHead = dl->asyncHead->next;
+        }
+        if (dl->asyncHead == NULL) {
+            dl->asyncTail = NULL;
+        }
+        STUHFL_MUTEX_UNLOCK(&dl->asyncLock);
+
+        if (cnt > 0) {
+            for (uint8_t i = 0; i < cnt; i++) {
+                entries[i] = (STUHFL_T_Cmd_Pipeline_Entry) { .cmd = batch[i]->cmd, .sndParams = batch[i]->sndParams, .rcvParams = batch[i]->rcvParams, .ret = ERR_REQUEST };
+            }
+            STUHFL_F_ExecuteCmdPipelined(entries, cnt, STUHFL_D_PIPELINE_WINDOW_MAX);
+        }
+
+        STUHFL_MUTEX_LOCK(&al->runnerLock);
+        al->asyncBatchActive = false;
+        STUHFL_COND_BROADCAST(&al->runnerDoneCond);
+        STUHFL_MUTEX_UNLOCK(&al->runnerLock);
+
+        for (uint8_t i = 0; i < cnt; i++) {
+            asyncComplete(dl, batch[i], entries[i].ret);
+        }
+    }
+    return NULL;
+}
+
+static void asyncStop(STUHFL_T_DL_Ctx *dl)
+{
+    STUHFL_T_Cmd_Async *pending;
+
+    if (!dl->asyncRunning) {
+        return;
+    }
+    STUHFL_MUTEX_LOCK(&dl->asyncLock);
+    dl->asyncExit = true;
+    STUHFL_COND_BROADCAST(&dl->asyncCond);
+    STUHFL_MUTEX_UNLOCK(&dl->asyncLock);
+
+#if defined(WIN32) || defined(WIN64)
+    WaitForSingleObject(dl->asyncThread, INFINITE);
+    CloseHandle(dl->asyncThread);
+#elif defined(POSIX)
+    pthread_join(dl->asyncThread, NULL);
+#endif
+
+    // commands not executed any more
+    STUHFL_MUTEX_LOCK(&dl->asyncLock);
+    pending = dl->asyncHead;
+    dl->asyncHead = NULL;
+    dl->asyncTail = NULL;
+    dl->asyncRunning = false;
+    dl->asyncExit = false;
+    STUHFL_MUTEX_UNLOCK(&dl->asyncLock);
+    while (pending != NULL) {
+        STUHFL_T_Cmd_Async *next = pending->next;
+        asyncComplete(dl, pending, ERR_REQUEST);
+        pending = next;
+    }
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_ExecuteCmdAsync(STUHFL_T_Cmd_Async *async)
+{
+    STUHFL_T_Reader_Ctx *ctx = STUHFL_F_CurReaderCtx();
+    STUHFL_T_DL_Ctx *dl = &ctx->dl;
+    STUHFL_T_RET_CODE ret = ERR_NONE;
+
+    if (async == NULL) {
+        return ERR_PARAM;
+    }
+    // same restriction as for pipelining
+    if (!isPipelineCmd(async->cmd)) {
+        return ERR_PARAM;
+    }
+    if (dl->deviceCtx == NULL) {
+        return ERR_REQUEST;
+    }
+
+    async->ret = ERR_NOMSG;
+    async->completed = 0;
+    async->readerCtx = ctx;
+    async->next = NULL;
+
+    STUHFL_MUTEX_LOCK(&dl->asyncLock);
+    if (!dl->asyncRunning) {
+#if defined(WIN32) || defined(WIN64)
+        dl->asyncThread = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)threadAsyncFunc, (void*)ctx, 0, 0);
+        dl->asyncRunning = (dl->asyncThread != NULL);
+#elif defined(POSIX)
+        dl->asyncRunning = (pthread_create(&dl->asyncThread, NULL, threadAsyncFunc, (void*)ctx) == 0);
+#endif
+    }
+    if (dl->asyncRunning) {
+        if (dl->asyncTail != NULL) {
+            dl->asyncTail->next = async;
+        } else {
+            dl->asyncHead = async;
+        }
+        dl->asyncTail = async;
+        STUHFL_COND_BROADCAST(&dl->asyncCond);
+    } else {
+        ret = ERR_NOMEM;
+    }
+    STUHFL_MUTEX_UNLOCK(&dl->asyncLock);
+
+    TRACE_DL_LOG_START();
+    TRACE_DL_LOG("STUHFL_F_ExecuteCmdAsync(cmd = 0x%x, sndParams = 0x%x) = %d", async->cmd, async->sndParams, ret);
+    return ret;
+}
+
+STUHFL_T_RET_CODE STUHFL_F_ServeCmdAsync(bool drain)
+{
+    STUHFL_T_Reader_Ctx *ctx = STUHFL_F_CurReaderCtx();
+    STUHFL_T_DL_Ctx *dl = &ctx->dl;
+    STUHFL_T_RET_CODE ret = ERR_NONE;
+
+    if (drain) {
+        // inventory frames still in flight are dropped
+        uint8_t *rcvPayload = STUHFL_F_Get_RcvPayloadPtr();
+        uint32_t rdComTimeout = ctx->bl.rdComTimeout;
+        while (dl->asyncServedCnt > 0) {
+            // commands are served in order, the oldest one expires first
+            uint32_t elapsed = getMilliSpan(dl->asyncServedTime[0]);
+            if (elapsed < rdComTimeout) {
+                uint16_t rcvPayloadLen = 0;
+                ctx->bl.rdComTimeout = rdComTimeout - elapsed;
+                ret = rcvFrame(dl, rcvPayload, &rcvPayloadLen);
+                ctx->bl.rdComTimeout = rdComTimeout;
+            }
+            asyncServedExpire(ctx, (ret == ERR_IO));
+        }
+        return ERR_NONE;
+    }
+
+    asyncServedExpire(ctx, false);
+    while (dl->asyncServedCnt < STUHFL_D_PIPELINE_WINDOW_MAX) {
+        STUHFL_MUTEX_LOCK(&dl->asyncLock);
+        STUHFL_T_Cmd_Async *async = dl->asyncHead;
+        if (async != NULL) {
+            dl->asyncHead = async->next;
+            if (dl->asyncHead == NULL) {
+                dl->asyncTail = NULL;
+            }
+        }
+        STUHFL_MUTEX_UNLOCK(&dl->asyncLock);
+        if (async == NULL) {
+            break;
+        }
+
+        ret = STUHFL_F_SendCmd(async->cmd, async->sndParams);
+        if (ret != ERR_NONE) {
+            asyncComplete(dl, async, ret);
+            break;
+        }
+        dl->asyncServed[dl->asyncServedCnt] = async;
+        dl->asyncServedID[dl->asyncServedCnt] = STUHFL_F_Get_SndID();
+        dl->asyncServedTime[dl->asyncServedCnt] = getMilliCount();
+        dl->asyncServedCnt++;
+    }
+    return ret;
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_WaitCmdAsync(STUHFL_T_Cmd_Async *async, uint32_t timeout)
+{
+    if ((async == NULL) || (async->readerCtx == NULL) || (async->done != NULL)) {
+        return ERR_PARAM;
+    }
+    STUHFL_T_DL_Ctx *dl = &((STUHFL_T_Reader_Ctx *)async->readerCtx)->dl;
+    uint32_t startTime = getMilliCount();
+
+    STUHFL_MUTEX_LOCK(&dl->asyncLock);
+    while (!async->completed) {
+        uint32_t elapsed = getMilliSpan(startTime);
+        if (elapsed >= timeout) {
+            break;
+        }
+        STUHFL_F_CondWait(&dl->asyncCond, &dl->asyncLock, timeout - elapsed);
+    }
+    STUHFL_T_RET_CODE ret = async->completed ? async->ret : ERR_TIMEOUT;
+    STUHFL_MUTEX_UNLOCK(&dl->asyncLock);
+    return ret;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetVersionOld(uint8_t *swVersion)
+{
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
+
     STUHFL_T_RET_CODE ret = ERR_PARAM;
     TRACE_DL_LOG_START();
     uint8_t *sndPayload = STUHFL_F_Get_SndPayloadPtr();
@@ -893,8 +1545,8 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetVersionOld(uint8_t *swVer
     sndPayloadLen = sizeof(oldGetVersion);
     memcpy(sndPayload, oldGetVersion, sndPayloadLen = sizeof(oldGetVersion));
 
-    ret = STUHFL_F_SndRaw_Dispatcher(deviceCtx, sndPayload, sndPayloadLen);
-    ret |= STUHFL_F_RcvRaw_Dispatcher(deviceCtx, rcvPayload, &rcvPayloadLen);
+    ret = STUHFL_F_SndRaw_Dispatcher(dl->deviceCtx, sndPayload, sndPayloadLen);
+    ret |= STUHFL_F_RcvRaw_Dispatcher(dl->deviceCtx, rcvPayload, &rcvPayloadLen);
 
     if (ERR_NONE == ret) {
         if ((rcvPayload[4] == 0x67) && (rcvPayload[5] == 0x00) && (rcvPayload[6] == 0x00) && (rcvPayload[7] == 0x00) && (rcvPayload[8] == 0x03)) {
@@ -912,6 +1564,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetVersion(uint8_t *swVersio
         uint8_t *hwVersionMajor, uint8_t *hwVersionMinor, uint8_t *hwVersionMicro, uint8_t *hwVersionBuild)
 
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     STUHFL_T_RET_CODE ret = ERR_PARAM;
     TRACE_DL_LOG_START();
     uint8_t *sndPayload = STUHFL_F_Get_SndPayloadPtr();
@@ -921,8 +1574,8 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetVersion(uint8_t *swVersio
     uint8_t swVersion[256];
     uint8_t hwVersion[256];
 
-    ret = STUHFL_F_Snd_Dispatcher(deviceCtx, (STUHFL_CG_GENERIC << 8) | STUHFL_CC_GET_VERSION, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
-    ret |= STUHFL_F_Rcv_Dispatcher(deviceCtx, rcvPayload, &rcvPayloadLen);
+    ret = STUHFL_F_Snd_Dispatcher(dl->deviceCtx, (STUHFL_CG_GENERIC << 8) | STUHFL_CC_GET_VERSION, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
+    ret |= STUHFL_F_Rcv_Dispatcher(dl->deviceCtx, rcvPayload, &rcvPayloadLen);
 
     if (ERR_NONE == ret) {
         uint8_t tag;
@@ -955,6 +1608,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetVersion(uint8_t *swVersio
 }
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetInfo(char *szSwInfo, char *szHwInfo)
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     STUHFL_T_RET_CODE ret = ERR_PARAM;
     TRACE_DL_LOG_START();
     uint8_t *sndPayload = STUHFL_F_Get_SndPayloadPtr();
@@ -962,8 +1616,8 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetInfo(char *szSwInfo, char
     uint8_t *rcvPayload = STUHFL_F_Get_RcvPayloadPtr();
     uint16_t rcvPayloadLen = 0;
 
-    ret = STUHFL_F_Snd_Dispatcher(deviceCtx, (STUHFL_CG_GENERIC << 8) | STUHFL_CC_GET_INFO, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
-    ret |= STUHFL_F_Rcv_Dispatcher(deviceCtx, rcvPayload, &rcvPayloadLen);
+    ret = STUHFL_F_Snd_Dispatcher(dl->deviceCtx, (STUHFL_CG_GENERIC << 8) | STUHFL_CC_GET_INFO, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
+    ret |= STUHFL_F_Rcv_Dispatcher(dl->deviceCtx, rcvPayload, &rcvPayloadLen);
 
     if (ERR_NONE == ret) {
         uint8_t tag;
@@ -990,609 +1644,370 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Upgrade(uint8_t *fwData, uin
 }
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_EnterBootloader()
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     uint8_t *sndPayload = STUHFL_F_Get_SndPayloadPtr();
     uint16_t sndPayloadLen = 0;
     TRACE_DL_LOG_START();
-    STUHFL_T_RET_CODE ret = STUHFL_F_Snd_Dispatcher(deviceCtx, (STUHFL_CG_GENERIC << 8) | STUHFL_CC_ENTER_BOOTLOADER, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
+    shadowInvalidate(dl);
+    STUHFL_T_RET_CODE ret = STUHFL_F_Snd_Dispatcher(dl->deviceCtx, (STUHFL_CG_GENERIC << 8) | STUHFL_CC_ENTER_BOOTLOADER, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
     TRACE_DL_LOG("STUHFL_F_EnterBootloader() = %d", ret);
     return ret;
 }
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Reboot()
 {
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
     uint8_t *sndPayload = STUHFL_F_Get_SndPayloadPtr();
     uint16_t sndPayloadLen = 0;
     TRACE_DL_LOG_START();
-    STUHFL_T_RET_CODE ret = STUHFL_F_Snd_Dispatcher(deviceCtx, (STUHFL_CG_GENERIC << 8) | STUHFL_CC_REBOOT, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
+    shadowInvalidate(dl);
+    STUHFL_T_RET_CODE ret = STUHFL_F_Snd_Dispatcher(dl->deviceCtx, (STUHFL_CG_GENERIC << 8) | STUHFL_CC_REBOOT, STATUS_DEFAULT_SND, sndPayload, sndPayloadLen);
     TRACE_DL_LOG("STUHFL_F_Reboot() = %d", ret);
     return ret;
 }
 
 
 
-// --------------------------------------------------------------------------
-STUHFL_T_RET_CODE SetParam_SndPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, uint8_t *sndPayload, uint16_t *sndPayloadOffset)
-{
-    switch (param) {
+// - Param codec (ST25RU3993) ------------------------------------------------
+// Each key is described once by its TLV tag, the size of its value struct and
+// the leading part of the value that is sent along with a GET to select what is replied.
 
-    case STUHFL_PARAM_KEY_RWD_REGISTER: {
-        STUHFL_T_ST25RU3993_Register *reg = (STUHFL_T_ST25RU3993_Register*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Register));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_REGISTER, sizeof(STUHFL_T_ST25RU3993_Register), reg));
-        TRACE_DL_LOG_APPEND(" Register(addr: 0x%02x, data: 0x%02x)", reg->addr, reg->data);
-        break;
-    }
+#define PARAM_FLAG_RD                   0x01
+#define PARAM_FLAG_WR                   0x02
+#define PARAM_FLAG_ACTION               0x04    // SET triggers an action, no value is sent
 
-    case STUHFL_PARAM_KEY_RWD_CONFIG: {
-        STUHFL_T_ST25RU3993_RwdConfig *cfg = (STUHFL_T_ST25RU3993_RwdConfig*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_RwdConfig));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_RWD_CONFIG, sizeof(STUHFL_T_ST25RU3993_RwdConfig), cfg));
-        TRACE_DL_LOG_APPEND(" RwdCfg(id: 0x%02x, value: 0x%02x)", cfg->id, cfg->value);
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_ANTENNA_POWER: {
-        STUHFL_T_ST25RU3993_Antenna_Power *antPwr = (STUHFL_T_ST25RU3993_Antenna_Power*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Antenna_Power));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_ANTENNA_POWER, sizeof(STUHFL_T_ST25RU3993_Antenna_Power), antPwr));
-        TRACE_DL_LOG_APPEND(" AntennaPower(mode: 0x%02x timeout: %d, frequency: %d)", antPwr->mode, antPwr->timeout, antPwr->frequency);
-        break;
-    }
-
-    //case STUHFL_PARAM_KEY_RWD_FREQ_RSSI:
-    //case STUHFL_PARAM_KEY_RWD_FREQ_REFLECTED:
-
-    case STUHFL_PARAM_KEY_RWD_CHANNEL_LIST: {
-        STUHFL_T_ST25RU3993_ChannelList *channelList = (STUHFL_T_ST25RU3993_ChannelList*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_ChannelList));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_CHANNEL_LIST, sizeof(STUHFL_T_ST25RU3993_ChannelList), channelList));
-        TRACE_DL_LOG_APPEND(" ChannelList(antenna: %d, nFrequencies: %d, currentChannelListIdx: %d, persistent: %d, idx:{Freq, (cin,clen,cout)} = ", channelList->antenna, channelList->nFrequencies, channelList->currentChannelListIdx, channelList->persistent);
-        for (int i = 0; i < channelList->nFrequencies; i++) {
-            TRACE_DL_LOG_APPEND("%d:{%d, (%d,%d,%d)}, ", i, channelList->item[i].frequency, channelList->item[i].caps.cin, channelList->item[i].caps.clen, channelList->item[i].caps.cout);
-        }
-        break;
-    }
+#define MEMBER_END(t, m)                (uint16_t)(offsetof(t, m) + sizeof(((t *)0)->m))
 
-    case STUHFL_PARAM_KEY_RWD_FREQ_PROFILE: {
-        STUHFL_T_ST25RU3993_Freq_Profile *freqProfile = (STUHFL_T_ST25RU3993_Freq_Profile*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_Profile));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_FREQ_PROFILE, sizeof(STUHFL_T_ST25RU3993_Freq_Profile), freqProfile));
-        TRACE_DL_LOG_APPEND(" FreqProfile(profile: %d)", freqProfile->profile);
-        break;
-    }
+typedef void(*STUHFL_T_Param_Trace)(const void *value);
 
-    case STUHFL_PARAM_KEY_RWD_FREQ_PROFILE_ADD2CUSTOM: {
-        STUHFL_T_ST25RU3993_Freq_Profile_Add2Custom *freqProfileAdd2Custom = (STUHFL_T_ST25RU3993_Freq_Profile_Add2Custom*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_Profile_Add2Custom));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_FREQ_PROFILE_ADD2CUSTOM, sizeof(STUHFL_T_ST25RU3993_Freq_Profile_Add2Custom), freqProfileAdd2Custom));
-        TRACE_DL_LOG_APPEND(" ProfileAdd2Custom(clearList: %d, frequency: %d)", freqProfileAdd2Custom->clearList, freqProfileAdd2Custom->frequency);
-        break;
-    }
+typedef struct {
+    STUHFL_T_TAG                        tag;        // TLV tag, 0 for unknown keys
+    uint16_t                            size;       // size of the value struct
+    uint16_t                            getLen;     // leading bytes of the value sent with a GET
+    uint8_t                             flags;
+    STUHFL_T_Param_Trace                trace;
+    uint8_t                             shadowSlot; // slot in host side shadow cache (1..SHADOW_SLOT_CNT), 0 if not cached
+} STUHFL_T_Param_Desc;
 
-    //case STUHFL_PARAM_KEY_RWD_FREQ_PROFILE_INFO:
+#define PARAM_KEY_CNT                   0x40
 
-    case STUHFL_PARAM_KEY_RWD_FREQ_HOP: {
-        STUHFL_T_ST25RU3993_Freq_Hop *freqHop = (STUHFL_T_ST25RU3993_Freq_Hop*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_Hop));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_FREQ_HOP, sizeof(STUHFL_T_ST25RU3993_Freq_Hop), freqHop));
-        TRACE_DL_LOG_APPEND(" FreqHop(maxSendingTime: %d)", freqHop->maxSendingTime);
-        break;
+static void traceRegister(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Register *reg = value;
+    TRACE_DL_LOG_APPEND(" Register(addr: 0x%02x, data: 0x%02x)", reg->addr, reg->data);
+}
+static void traceRwdConfig(const void *value)
+{
+    const STUHFL_T_ST25RU3993_RwdConfig *cfg = value;
+    TRACE_DL_LOG_APPEND(" RwdCfg(id: 0x%02x, value: 0x%02x)", cfg->id, cfg->value);
+}
+static void traceAntennaPower(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Antenna_Power *antPwr = value;
+    TRACE_DL_LOG_APPEND(" AntennaPower(mode: 0x%02x timeout: %d, frequency: %d)", antPwr->mode, antPwr->timeout, antPwr->frequency);
+}
+static void traceFreqRssi(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Freq_Rssi *freqRssi = value;
+    TRACE_DL_LOG_APPEND(" FreqRSSI(frequency: %d, rssiLogI: %d, rssiLogQ: %d)", freqRssi->frequency, freqRssi->rssiLogI, freqRssi->rssiLogQ);
+}
+static void traceFreqReflected(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Freq_ReflectedPower_Info *freqReflectedPower = value;
+    TRACE_DL_LOG_APPEND(" FreqReflectedPower(frequency: %d, applyTunerSetting: %d, reflectedI: %d, reflectedQ: %d)", freqReflectedPower->frequency, freqReflectedPower->applyTunerSetting, freqReflectedPower->reflectedI, freqReflectedPower->reflectedQ);
+}
+static void traceChannelList(const void *value)
+{
+    const STUHFL_T_ST25RU3993_ChannelList *channelList = value;
+    TRACE_DL_LOG_APPEND(" ChannelList(antenna: %d, nFrequencies: %d, currentChannelListIdx: %d, persistent: %d, idx:{Freq, (cin,clen,cout)} = ", channelList->antenna, channelList->nFrequencies, channelList->currentChannelListIdx, channelList->persistent);
+    for (uint32_t i = 0; (i < channelList->nFrequencies) && (i < MAX_FREQUENCY); i++) {
+        TRACE_DL_LOG_APPEND("%d:{%d, (%d,%d,%d)}, ", i, channelList->item[i].frequency, channelList->item[i].caps.cin, channelList->item[i].caps.clen, channelList->item[i].caps.cout);
     }
+}
+static void traceFreqProfile(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Freq_Profile *freqProfile = value;
+    TRACE_DL_LOG_APPEND(" FreqProfile(profile: %d)", freqProfile->profile);
+}
+static void traceFreqProfileAdd2Custom(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Freq_Profile_Add2Custom *freqProfileAdd2Custom = value;
+    TRACE_DL_LOG_APPEND(" ProfileAdd2Custom(clearList: %d, frequency: %d)", freqProfileAdd2Custom->clearList, freqProfileAdd2Custom->frequency);
+}
+static void traceFreqProfileInfo(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Freq_Profile_Info *freqProfileInfo = value;
+    TRACE_DL_LOG_APPEND(" FreqProfileInfo(profile: %d, minFreq : %d, maxFreq: %d, numFrequencies : %d)", freqProfileInfo->profile, freqProfileInfo->minFrequency, freqProfileInfo->maxFrequency, freqProfileInfo->numFrequencies);
+}
+static void traceFreqHop(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Freq_Hop *freqHop = value;
+    TRACE_DL_LOG_APPEND(" FreqHop(maxSendingTime: %d)", freqHop->maxSendingTime);
+}
+static void traceFreqLBT(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Freq_LBT *freqLBT = value;
+    TRACE_DL_LOG_APPEND(" FreqLBT(listeningTime: %d, idleTime: %d, rssiLogThreshold: %d, skipLBTcheck: %d)", freqLBT->listeningTime, freqLBT->idleTime, freqLBT->rssiLogThreshold, freqLBT->skipLBTcheck);
+}
+static void traceFreqContMod(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Freq_ContMod *freqContMod = value;
+    TRACE_DL_LOG_APPEND(" FreqContMod(frequency: %d, enableContMod : %d, maxSendingTime : %d, modulationMode : %d)", freqContMod->frequency, freqContMod->enableContMod, freqContMod->maxSendingTime, freqContMod->modulationMode);
+}
+static void traceGen2Timings(const void *value)
+{
+    const STUHFL_T_Gen2_Timings *gen2Timings = value;
+    TRACE_DL_LOG_APPEND(" Gen2Timings(T4Min: %d)", gen2Timings->T4Min);
+}
+static void traceGen2ProtocolCfg(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Gen2Protocol_Cfg *gen2ProtocolCfg = value;
+    TRACE_DL_LOG_APPEND(" Gen2ProtocolCfg(tari: %d, blf: %d, coding: %d, trext: %d)",
+                        gen2ProtocolCfg->tari, gen2ProtocolCfg->blf, gen2ProtocolCfg->coding, gen2ProtocolCfg->trext);
+}
+static void traceGb29768ProtocolCfg(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Gb29768Protocol_Cfg *gb29768ProtocolCfg = value;
+    TRACE_DL_LOG_APPEND(" Gb29768ProtocolCfg(tc: %d, blf: %d, coding: %d, trext: %d)", gb29768ProtocolCfg->tc, gb29768ProtocolCfg->blf, gb29768ProtocolCfg->coding, gb29768ProtocolCfg->trext);
+}
+static void traceTxRxCfg(const void *value)
+{
+    const STUHFL_T_ST25RU3993_TxRx_Cfg *txRxCfg = value;
+    TRACE_DL_LOG_APPEND(" TxRxCfg(txOutputLevel: %d, rxSensitivity: %d, usedAntenna: %d, alternateAntennaInterval: %d)", txRxCfg->txOutputLevel, txRxCfg->rxSensitivity, txRxCfg->usedAntenna, txRxCfg->alternateAntennaInterval);
+}
+static void tracePaCfg(const void *value)
+{
+    const STUHFL_T_ST25RU3993_PA_Cfg *paCfg = value;
+    TRACE_DL_LOG_APPEND(" PA_Cfg(useExternal: %d)", paCfg->useExternal);
+}
+static void traceGen2InventoryCfg(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Gen2Inventory_Cfg *invGen2Cfg = value;
+    TRACE_DL_LOG_APPEND(" Gen2InventoryCfg(fastInv: %d, autoAck: %d, readTID: %d, startQ: %d, adaptiveQEnable: %d, minQ: %d, maxQ: %d, adjustOptions: %d, C1: (%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d), C2: (%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d), autoTuningInterval: %d, autoTuningLevel: %d, autoTuningAlgo: %d, autoTuningFalsePositiveDetection: %d, sel: %d, session: %d, target: %d, toggleTarget: %d, targetDepletionMode: %d, adaptiveSensitivityEnable: %d, adaptiveSensitivityInterval: %d)",
+                        invGen2Cfg->fastInv, invGen2Cfg->autoAck, invGen2Cfg->readTID,
+                        invGen2Cfg->startQ, invGen2Cfg->adaptiveQEnable, invGen2Cfg->minQ, invGen2Cfg->maxQ, invGen2Cfg->adjustOptions,
+                        invGen2Cfg->C1[0], invGen2Cfg->C1[1], invGen2Cfg->C1[2], invGen2Cfg->C1[3], invGen2Cfg->C1[4], invGen2Cfg->C1[5], invGen2Cfg->C1[6], invGen2Cfg->C1[7],
+                        invGen2Cfg->C1[8], invGen2Cfg->C1[9], invGen2Cfg->C1[10], invGen2Cfg->C1[11], invGen2Cfg->C1[12], invGen2Cfg->C1[13], invGen2Cfg->C1[14], invGen2Cfg->C1[15],
+                        invGen2Cfg->C2[0], invGen2Cfg->C2[1], invGen2Cfg->C2[2], invGen2Cfg->C2[3], invGen2Cfg->C2[4], invGen2Cfg->C2[5], invGen2Cfg->C2[6], invGen2Cfg->C2[7],
+                        invGen2Cfg->C2[8], invGen2Cfg->C2[9], invGen2Cfg->C2[10], invGen2Cfg->C2[11], invGen2Cfg->C2[12], invGen2Cfg->C2[13], invGen2Cfg->C2[14], invGen2Cfg->C2[15],
+                        invGen2Cfg->autoTuningInterval, invGen2Cfg->autoTuningLevel, invGen2Cfg->autoTuningAlgo & ~TUNING_ALGO_ENABLE_FPD, (invGen2Cfg->autoTuningAlgo & TUNING_ALGO_ENABLE_FPD) ? true : false,
+                        invGen2Cfg->sel, invGen2Cfg->session, invGen2Cfg->target, invGen2Cfg->toggleTarget, invGen2Cfg->targetDepletionMode,
+                        invGen2Cfg->adaptiveSensitivityEnable, invGen2Cfg->adaptiveSensitivityInterval);
+}
+static void traceGb29768InventoryCfg(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg *invGb29768Cfg = value;
+    TRACE_DL_LOG_APPEND(" Gb29768InventoryCfg(readTID: %d, autoTuningInterval: %d, autoTuningLevel: %d, autoTuningAlgo: %d, autoTuningFalsePositiveDetection: %d, adaptiveSensitivityEnable: %d, adaptiveSensitivityInterval: %d, condition: %d, session: %d, target: %d, toggleTarget: %d, targetDepletionMode: %d, endThreshold:%d, ccnThreshold:%d, cinThreshold:%d)",
+                        invGb29768Cfg->readTID,
+                        invGb29768Cfg->autoTuningInterval, invGb29768Cfg->autoTuningLevel, invGb29768Cfg->autoTuningAlgo & ~TUNING_ALGO_ENABLE_FPD, (invGb29768Cfg->autoTuningAlgo & TUNING_ALGO_ENABLE_FPD) ? true : false,
+                        invGb29768Cfg->adaptiveSensitivityEnable, invGb29768Cfg->adaptiveSensitivityInterval,
+                        invGb29768Cfg->condition, invGb29768Cfg->session, invGb29768Cfg->target, invGb29768Cfg->toggleTarget, invGb29768Cfg->targetDepletionMode,
+                        invGb29768Cfg->endThreshold, invGb29768Cfg->ccnThreshold, invGb29768Cfg->cinThreshold);
+}
+static void traceTuningCaps(const void *value)
+{
+    const STUHFL_T_ST25RU3993_TuningCaps *tuning = value;
+    TRACE_DL_LOG_APPEND(" TuningCaps(antenna: %d, channelListIdx: %d, cin: %d, clen: %d, cout: %d)", tuning->antenna, tuning->channelListIdx, tuning->caps.cin, tuning->caps.clen, tuning->caps.cout);
+}
+static void traceTuning(const void *value)
+{
+    const STUHFL_T_ST25RU3993_Tuning *tuning = value;
+    TRACE_DL_LOG_APPEND(" Tuning(antenna: %d, cin: %d, clen: %d, cout: %d)", tuning->antenna, tuning->cin, tuning->clen, tuning->cout);
+}
+static void traceTuningTableEntry(const void *value)
+{
+#define TB_SIZE    128
+    char tb[4][TB_SIZE];
+    STUHFL_T_ST25RU3993_TuningTableEntry *tuningTableEntry = (STUHFL_T_ST25RU3993_TuningTableEntry *)value;
+    TRACE_DL_LOG_APPEND(" TuningTableEntry(entry: %d, freq: %d, cin: 0x%s, clen: 0x%s, cout: 0x%s, IQ: 0x%s)",
+                        tuningTableEntry->entry, tuningTableEntry->freq, byteArray2HexString(tb[0], TB_SIZE, tuningTableEntry->cin, MAX_ANTENNA), byteArray2HexString(tb[1], TB_SIZE, tuningTableEntry->clen, MAX_ANTENNA), byteArray2HexString(tb[2], TB_SIZE, tuningTableEntry->cout, MAX_ANTENNA), byteArray2HexString(tb[3], TB_SIZE, (uint8_t *)tuningTableEntry->IQ, MAX_ANTENNA * sizeof(uint16_t)));
+#undef TB_SIZE
+}
+static void traceTuningTableDefault(const void *value)
+{
+    const STUHFL_T_ST25RU3993_TunerTableSet *tuningTableSet = value;
+    TRACE_DL_LOG_APPEND(" TuningTableDefault(profile: %d, freq: %d)", tuningTableSet->profile, tuningTableSet->freq);
+}
+static void traceTuningTableInfo(const void *value)
+{
+    const STUHFL_T_ST25RU3993_TuningTableInfo *tuningTableInfo = value;
+    TRACE_DL_LOG_APPEND(" TuningTableInfo(profile: %d, numEntries: %d)", tuningTableInfo->profile, tuningTableInfo->numEntries);
+}
+static void traceTuningTableSave(const void *value)
+{
+    (void)value;
+    TRACE_DL_LOG_APPEND(" TuningTableSave2Flash()");
+}
+static void traceTuningTableEmpty(const void *value)
+{
+    (void)value;
+    TRACE_DL_LOG_APPEND(" TuningTableClear()");
+}
 
-    case STUHFL_PARAM_KEY_RWD_FREQ_LBT: {
-        STUHFL_T_ST25RU3993_Freq_LBT *freqLBT = (STUHFL_T_ST25RU3993_Freq_LBT*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_LBT));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_FREQ_LBT, sizeof(STUHFL_T_ST25RU3993_Freq_LBT), freqLBT));
-        TRACE_DL_LOG_APPEND(" FreqLBT(listeningTime: %d, idleTime: %d, rssiLogThreshold: %d, skipLBTcheck: %d)", freqLBT->listeningTime, freqLBT->idleTime, freqLBT->rssiLogThreshold, freqLBT->skipLBTcheck);
-        break;
+static const STUHFL_T_Param_Desc paramDescs[PARAM_KEY_CNT] = {
+    [STUHFL_PARAM_KEY_RWD_REGISTER]                 = { STUHFL_TAG_REGISTER,                sizeof(STUHFL_T_ST25RU3993_Register),                   MEMBER_END(STUHFL_T_ST25RU3993_Register, addr),                         PARAM_FLAG_RD | PARAM_FLAG_WR, traceRegister },
+    [STUHFL_PARAM_KEY_RWD_CONFIG]                   = { STUHFL_TAG_RWD_CONFIG,              sizeof(STUHFL_T_ST25RU3993_RwdConfig),                  MEMBER_END(STUHFL_T_ST25RU3993_RwdConfig, id),                          PARAM_FLAG_RD | PARAM_FLAG_WR, traceRwdConfig },
+    [STUHFL_PARAM_KEY_RWD_ANTENNA_POWER]            = { STUHFL_TAG_ANTENNA_POWER,           sizeof(STUHFL_T_ST25RU3993_Antenna_Power),              0,                                                                      PARAM_FLAG_RD | PARAM_FLAG_WR, traceAntennaPower },
+    [STUHFL_PARAM_KEY_RWD_FREQ_RSSI]                = { STUHFL_TAG_FREQ_RSSI,               sizeof(STUHFL_T_ST25RU3993_Freq_Rssi),                  MEMBER_END(STUHFL_T_ST25RU3993_Freq_Rssi, frequency),                   PARAM_FLAG_RD, traceFreqRssi },
+    [STUHFL_PARAM_KEY_RWD_FREQ_REFLECTED]           = { STUHFL_TAG_FREQ_REFLECTED,          sizeof(STUHFL_T_ST25RU3993_Freq_ReflectedPower_Info),   MEMBER_END(STUHFL_T_ST25RU3993_Freq_ReflectedPower_Info, applyTunerSetting), PARAM_FLAG_RD, traceFreqReflected },
+    [STUHFL_PARAM_KEY_RWD_FREQ_PROFILE]             = { STUHFL_TAG_FREQ_PROFILE,            sizeof(STUHFL_T_ST25RU3993_Freq_Profile),               0,                                                                      PARAM_FLAG_WR, traceFreqProfile },
+    [STUHFL_PARAM_KEY_RWD_FREQ_PROFILE_ADD2CUSTOM]  = { STUHFL_TAG_FREQ_PROFILE_ADD2CUSTOM, sizeof(STUHFL_T_ST25RU3993_Freq_Profile_Add2Custom),    0,                                                                      PARAM_FLAG_WR, traceFreqProfileAdd2Custom },
+    [STUHFL_PARAM_KEY_RWD_FREQ_PROFILE_INFO]        = { STUHFL_TAG_FREQ_PROFILE_INFO,       sizeof(STUHFL_T_ST25RU3993_Freq_Profile_Info),          MEMBER_END(STUHFL_T_ST25RU3993_Freq_Profile_Info, profile),             PARAM_FLAG_RD, traceFreqProfileInfo },
+    [STUHFL_PARAM_KEY_RWD_FREQ_HOP]                 = { STUHFL_TAG_FREQ_HOP,                sizeof(STUHFL_T_ST25RU3993_Freq_Hop),                   0,                                                                      PARAM_FLAG_RD | PARAM_FLAG_WR, traceFreqHop, 1 },
+    [STUHFL_PARAM_KEY_RWD_FREQ_LBT]                 = { STUHFL_TAG_FREQ_LBT,                sizeof(STUHFL_T_ST25RU3993_Freq_LBT),                   0,                                                                      PARAM_FLAG_RD | PARAM_FLAG_WR, traceFreqLBT, 2 },
+    [STUHFL_PARAM_KEY_RWD_FREQ_CONT_MOD]            = { STUHFL_TAG_FREQ_CONT_MOD,           sizeof(STUHFL_T_ST25RU3993_Freq_ContMod),               0,                                                                      PARAM_FLAG_WR, traceFreqContMod },
+    [STUHFL_PARAM_KEY_RWD_TXRX_CFG]                 = { STUHFL_TAG_TXRX_CFG,                sizeof(STUHFL_T_ST25RU3993_TxRx_Cfg),                   0,                                                                      PARAM_FLAG_RD | PARAM_FLAG_WR, traceTxRxCfg, 3 },
+    [STUHFL_PARAM_KEY_RWD_PA_CFG]                   = { STUHFL_TAG_PA_CFG,                  sizeof(STUHFL_T_ST25RU3993_PA_Cfg),                     0,                                                                      PARAM_FLAG_RD | PARAM_FLAG_WR, tracePaCfg, 4 },
+    [STUHFL_PARAM_KEY_RWD_CHANNEL_LIST]             = { STUHFL_TAG_CHANNEL_LIST,            sizeof(STUHFL_T_ST25RU3993_ChannelList),                MEMBER_END(STUHFL_T_ST25RU3993_ChannelList, persistent),                PARAM_FLAG_RD | PARAM_FLAG_WR, traceChannelList },
+    [STUHFL_PARAM_KEY_RWD_GEN2PROTOCOL_CFG]         = { STUHFL_TAG_GEN2PROTOCOL_CFG,        sizeof(STUHFL_T_ST25RU3993_Gen2Protocol_Cfg),           0,                                                                      PARAM_FLAG_RD | PARAM_FLAG_WR, traceGen2ProtocolCfg, 5 },
+    [STUHFL_PARAM_KEY_RWD_GEN2INVENTORY_CFG]        = { STUHFL_TAG_GEN2INVENTORY_CFG,       sizeof(STUHFL_T_ST25RU3993_Gen2Inventory_Cfg),          0,                                                                      PARAM_FLAG_RD | PARAM_FLAG_WR, traceGen2InventoryCfg, 6 },
+    [STUHFL_PARAM_KEY_RWD_GEN2TIMINGS]              = { STUHFL_TAG_GEN2TIMINGS,             sizeof(STUHFL_T_Gen2_Timings),                          0,                                                                      PARAM_FLAG_RD | PARAM_FLAG_WR, traceGen2Timings, 7 },
+    [STUHFL_PARAM_KEY_RWD_GB29768PROTOCOL_CFG]      = { STUHFL_TAG_GB29768PROTOCOL_CFG,     sizeof(STUHFL_T_ST25RU3993_Gb29768Protocol_Cfg),        0,                                                                      PARAM_FLAG_RD | PARAM_FLAG_WR, traceGb29768ProtocolCfg, 8 },
+    [STUHFL_PARAM_KEY_RWD_GB29768INVENTORY_CFG]     = { STUHFL_TAG_GB29768INVENTORY_CFG,    sizeof(STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg),       0,                                                                      PARAM_FLAG_RD | PARAM_FLAG_WR, traceGb29768InventoryCfg, 9 },
+    [STUHFL_PARAM_KEY_TUNING]                       = { STUHFL_TAG_TUNING,                  sizeof(STUHFL_T_ST25RU3993_Tuning),                     MEMBER_END(STUHFL_T_ST25RU3993_Tuning, antenna),                        PARAM_FLAG_RD | PARAM_FLAG_WR, traceTuning },
+    [STUHFL_PARAM_KEY_TUNING_TABLE_ENTRY]           = { STUHFL_TAG_TUNING_TABLE_ENTRY,      sizeof(STUHFL_T_ST25RU3993_TuningTableEntry),           MEMBER_END(STUHFL_T_ST25RU3993_TuningTableEntry, entry),                PARAM_FLAG_RD | PARAM_FLAG_WR, traceTuningTableEntry },
+    [STUHFL_PARAM_KEY_TUNING_TABLE_DEFAULT]         = { STUHFL_TAG_TUNING_TABLE_DEFAULT,    sizeof(STUHFL_T_ST25RU3993_TunerTableSet),              0,                                                                      PARAM_FLAG_WR, traceTuningTableDefault },
+    [STUHFL_PARAM_KEY_TUNING_TABLE_SAVE]            = { STUHFL_TAG_TUNING_TABLE_SAVE,       0,                                                      0,                                                                      PARAM_FLAG_WR | PARAM_FLAG_ACTION, traceTuningTableSave },
+    [STUHFL_PARAM_KEY_TUNING_TABLE_EMPTY]           = { STUHFL_TAG_TUNING_TABLE_EMPTY,      0,                                                      0,                                                                      PARAM_FLAG_WR | PARAM_FLAG_ACTION, traceTuningTableEmpty },
+    [STUHFL_PARAM_KEY_TUNING_TABLE_INFO]            = { STUHFL_TAG_TUNING_TABLE_INFO,       sizeof(STUHFL_T_ST25RU3993_TuningTableInfo),            MEMBER_END(STUHFL_T_ST25RU3993_TuningTableInfo, profile),               PARAM_FLAG_RD, traceTuningTableInfo },
+    [STUHFL_PARAM_KEY_TUNING_CAPS]                  = { STUHFL_TAG_TUNING_CAPS,             sizeof(STUHFL_T_ST25RU3993_TuningCaps),                 MEMBER_END(STUHFL_T_ST25RU3993_TuningCaps, channelListIdx),             PARAM_FLAG_RD | PARAM_FLAG_WR, traceTuningCaps },
+};
+
+static const STUHFL_T_Param_Desc *paramDesc(STUHFL_T_PARAM param, uint8_t access)
+{
+    if ((param >= PARAM_KEY_CNT) || (paramDescs[param].tag == 0) || ((paramDescs[param].flags & access) == 0)) {
+        return NULL;
     }
+    return &paramDescs[param];
+}
 
-    case STUHFL_PARAM_KEY_RWD_FREQ_CONT_MOD: {
-        STUHFL_T_ST25RU3993_Freq_ContMod *freqContMod = (STUHFL_T_ST25RU3993_Freq_ContMod*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_ContMod));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_FREQ_CONT_MOD, sizeof(STUHFL_T_ST25RU3993_Freq_ContMod), freqContMod));
-        TRACE_DL_LOG_APPEND(" FreqContMod(frequency: %d, enableContMod : %d, maxSendingTime : %d, modulationMode : %d)", freqContMod->frequency, freqContMod->enableContMod, freqContMod->maxSendingTime, freqContMod->modulationMode);
-        break;
-    }
+// - Shadow cache -------------------------------------------------------------
+// Last value set to or read from the reader for all params marked with a shadow slot.
+// Only used when enabled with STUHFL_PARAM_KEY_SHADOW_CACHE.
 
-    case STUHFL_PARAM_KEY_RWD_GEN2TIMINGS: {
-        STUHFL_T_Gen2_Timings *gen2Timings = (STUHFL_T_Gen2_Timings*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_Gen2_Timings));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_GEN2TIMINGS, sizeof(STUHFL_T_Gen2_Timings), gen2Timings));
-        TRACE_DL_LOG_APPEND(" SetGen2Timings(T4Min: %d)", gen2Timings->T4Min);
-        break;
+static bool shadowLookup(STUHFL_T_DL_Ctx *dl, STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, bool count)
+{
+    const STUHFL_T_Param_Desc *desc = paramDesc(param, PARAM_FLAG_RD);
+    if (!dl->shadowEnabled || (desc == NULL) || (desc->shadowSlot == 0)) {
+        return false;
     }
 
-    case STUHFL_PARAM_KEY_RWD_GEN2PROTOCOL_CFG: {
-        STUHFL_T_ST25RU3993_Gen2Protocol_Cfg *gen2ProtocolCfg = (STUHFL_T_ST25RU3993_Gen2Protocol_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Gen2Protocol_Cfg));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_GEN2PROTOCOL_CFG, sizeof(STUHFL_T_ST25RU3993_Gen2Protocol_Cfg), gen2ProtocolCfg));
-        TRACE_DL_LOG_APPEND(" Gen2ProtocolCfg(tari: %d, blf: %d, coding: %d, trext: %d)",
-                            gen2ProtocolCfg->tari, gen2ProtocolCfg->blf, gen2ProtocolCfg->coding, gen2ProtocolCfg->trext);
-        break;
+    uint8_t slot = (uint8_t)(desc->shadowSlot - 1);
+    if ((dl->shadowValid & (1U << slot)) == 0) {
+        if (count) {
+            dl->shadowMisses[slot]++;
+        }
+        return false;
     }
 
-    case STUHFL_PARAM_KEY_RWD_GB29768PROTOCOL_CFG: {
-        STUHFL_T_ST25RU3993_Gb29768Protocol_Cfg *gb29768ProtocolCfg = (STUHFL_T_ST25RU3993_Gb29768Protocol_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Gb29768Protocol_Cfg));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_GB29768PROTOCOL_CFG, sizeof(STUHFL_T_ST25RU3993_Gb29768Protocol_Cfg), gb29768ProtocolCfg));
-        TRACE_DL_LOG_APPEND(" Gb29768ProtocolCfg(tc: %d, blf: %d, coding: %d, trext: %d)", gb29768ProtocolCfg->tc, gb29768ProtocolCfg->blf, gb29768ProtocolCfg->coding, gb29768ProtocolCfg->trext);
-        break;
+    uint8_t *value = &(((uint8_t *)values)[*valuesOffset]);
+    *valuesOffset = (uint16_t)(*valuesOffset + desc->size);
+    memcpy(value, dl->shadow[slot], desc->size);
+    if (count) {
+        dl->shadowHits[slot]++;
+        desc->trace(value);
+        TRACE_DL_LOG_APPEND(" (cached)");
     }
+    return true;
+}
 
-    case STUHFL_PARAM_KEY_RWD_TXRX_CFG: {
-        STUHFL_T_ST25RU3993_TxRx_Cfg *txRxCfg = (STUHFL_T_ST25RU3993_TxRx_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TxRx_Cfg));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TXRX_CFG, sizeof(STUHFL_T_ST25RU3993_TxRx_Cfg), txRxCfg));
-        TRACE_DL_LOG_APPEND(" TxRxCfg(txOutputLevel: %d, rxSensitivity: %d, usedAntenna: %d, alternateAntennaInterval: %d)", txRxCfg->txOutputLevel, txRxCfg->rxSensitivity, txRxCfg->usedAntenna, txRxCfg->alternateAntennaInterval);
-        break;
+static void shadowStore(STUHFL_T_DL_Ctx *dl, STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset)
+{
+    const STUHFL_T_Param_Desc *desc = paramDesc(param, PARAM_FLAG_RD | PARAM_FLAG_WR);
+    if (desc == NULL) {
+        return;
     }
 
-    case STUHFL_PARAM_KEY_RWD_PA_CFG: {
-        STUHFL_T_ST25RU3993_PA_Cfg *paCfg = (STUHFL_T_ST25RU3993_PA_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_PA_Cfg));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_PA_CFG, sizeof(STUHFL_T_ST25RU3993_PA_Cfg), paCfg));
-        TRACE_DL_LOG_APPEND(" PA_Cfg(useExternal: %d)", paCfg->useExternal);
-        break;
+    uint8_t *value = &(((uint8_t *)values)[*valuesOffset]);
+    *valuesOffset = (uint16_t)(*valuesOffset + desc->size);
+    if (dl->shadowEnabled && (desc->shadowSlot != 0)) {
+        uint8_t slot = (uint8_t)(desc->shadowSlot - 1);
+        memcpy(dl->shadow[slot], value, desc->size);
+        dl->shadowValid = (uint16_t)(dl->shadowValid | (1U << slot));
     }
+}
 
-    case STUHFL_PARAM_KEY_RWD_GEN2INVENTORY_CFG: {
-        STUHFL_T_ST25RU3993_Gen2Inventory_Cfg *invGen2Cfg = (STUHFL_T_ST25RU3993_Gen2Inventory_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Gen2Inventory_Cfg));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_GEN2INVENTORY_CFG, sizeof(STUHFL_T_ST25RU3993_Gen2Inventory_Cfg), invGen2Cfg));
-        TRACE_DL_LOG_APPEND(" Gen2InventoryCfg(fastInv: %d, autoAck: %d, readTID: %d, startQ: %d, adaptiveQEnable: %d, minQ: %d, maxQ: %d, adjustOptions: %d, C1: (%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d), C2: (%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d), autoTuningInterval: %d, autoTuningLevel: %d, autoTuningAlgo: %d, autoTuningFalsePositiveDetection: %d, sel: %d, session: %d, target: %d, toggleTarget: %d, targetDepletionMode: %d, adaptiveSensitivityEnable: %d, adaptiveSensitivityInterval: %d)",
-                            invGen2Cfg->fastInv, invGen2Cfg->autoAck, invGen2Cfg->readTID,
-                            invGen2Cfg->startQ, invGen2Cfg->adaptiveQEnable, invGen2Cfg->minQ, invGen2Cfg->maxQ, invGen2Cfg->adjustOptions,
-                            invGen2Cfg->C1[0], invGen2Cfg->C1[1], invGen2Cfg->C1[2], invGen2Cfg->C1[3], invGen2Cfg->C1[4], invGen2Cfg->C1[5], invGen2Cfg->C1[6], invGen2Cfg->C1[7],
-                            invGen2Cfg->C1[8], invGen2Cfg->C1[9], invGen2Cfg->C1[10], invGen2Cfg->C1[11], invGen2Cfg->C1[12], invGen2Cfg->C1[13], invGen2Cfg->C1[14], invGen2Cfg->C1[15],
-                            invGen2Cfg->C2[0], invGen2Cfg->C2[1], invGen2Cfg->C2[2], invGen2Cfg->C2[3], invGen2Cfg->C2[4], invGen2Cfg->C2[5], invGen2Cfg->C2[6], invGen2Cfg->C2[7],
-                            invGen2Cfg->C2[8], invGen2Cfg->C2[9], invGen2Cfg->C2[10], invGen2Cfg->C2[11], invGen2Cfg->C2[12], invGen2Cfg->C2[13], invGen2Cfg->C2[14], invGen2Cfg->C2[15],
-                            invGen2Cfg->autoTuningInterval, invGen2Cfg->autoTuningLevel, invGen2Cfg->autoTuningAlgo & ~TUNING_ALGO_ENABLE_FPD, (invGen2Cfg->autoTuningAlgo & TUNING_ALGO_ENABLE_FPD) ? true : false,
-                            invGen2Cfg->sel, invGen2Cfg->session, invGen2Cfg->target, invGen2Cfg->toggleTarget, invGen2Cfg->targetDepletionMode,
-                            invGen2Cfg->adaptiveSensitivityEnable, invGen2Cfg->adaptiveSensitivityInterval);
-        break;
-    }
+static void shadowInvalidate(STUHFL_T_DL_Ctx *dl)
+{
+    dl->shadowValid = 0;
+}
 
-    case STUHFL_PARAM_KEY_RWD_GB29768INVENTORY_CFG: {
-        STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg *invGb29768Cfg = (STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_GB29768INVENTORY_CFG, sizeof(STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg), invGb29768Cfg));
-        TRACE_DL_LOG_APPEND(" Gb29768InventoryCfg(readTID: %d, autoTuningInterval: %d, autoTuningLevel: %d, autoTuningAlgo: %d, autoTuningFalsePositiveDetection: %d, adaptiveSensitivityEnable: %d, adaptiveSensitivityInterval: %d, condition: %d, session: %d, target: %d, toggleTarget: %d, targetDepletionMode: %d, endThreshold:%d, ccnThreshold:%d, cinThreshold:%d)",
-                            invGb29768Cfg->readTID,
-                            invGb29768Cfg->autoTuningInterval, invGb29768Cfg->autoTuningLevel, invGb29768Cfg->autoTuningAlgo & ~TUNING_ALGO_ENABLE_FPD, (invGb29768Cfg->autoTuningAlgo & TUNING_ALGO_ENABLE_FPD) ? true : false,
-                            invGb29768Cfg->adaptiveSensitivityEnable, invGb29768Cfg->adaptiveSensitivityInterval,
-                            invGb29768Cfg->condition, invGb29768Cfg->session, invGb29768Cfg->target, invGb29768Cfg->toggleTarget, invGb29768Cfg->targetDepletionMode,
-                            invGb29768Cfg->endThreshold, invGb29768Cfg->ccnThreshold, invGb29768Cfg->cinThreshold);
-        break;
-    }
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_GetShadowCacheStats(STUHFL_T_PARAM param, STUHFL_T_Shadow_Stats *stats)
+{
+    STUHFL_T_DL_Ctx *dl = &STUHFL_F_CurReaderCtx()->dl;
+    STUHFL_T_RET_CODE ret = ERR_PARAM;
+    const STUHFL_T_Param_Desc *desc = NULL;
 
-    case STUHFL_PARAM_KEY_TUNING_CAPS: {
-        STUHFL_T_ST25RU3993_TuningCaps *tuning = (STUHFL_T_ST25RU3993_TuningCaps*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TuningCaps));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TUNING_CAPS, sizeof(STUHFL_T_ST25RU3993_TuningCaps), tuning));
-        TRACE_DL_LOG_APPEND(" TuningCaps(antenna: %d, channelListIdx: %d, cin: %d, clen: %d, cout: %d)", tuning->antenna, tuning->channelListIdx, tuning->caps.cin, tuning->caps.clen, tuning->caps.cout);
-        break;
-    }
-    case STUHFL_PARAM_KEY_TUNING: {
-        STUHFL_T_ST25RU3993_Tuning *tuning = (STUHFL_T_ST25RU3993_Tuning*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Tuning));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TUNING, sizeof(STUHFL_T_ST25RU3993_Tuning), tuning));
-        TRACE_DL_LOG_APPEND(" Tuning(antenna: %d, cin: %d, clen: %d, cout: %d)", tuning->antenna, tuning->cin, tuning->clen, tuning->cout);
-        break;
-    }
-    case STUHFL_PARAM_KEY_TUNING_TABLE_ENTRY: {
-#define TB_SIZE    128
-        char tb[4][TB_SIZE];
-        STUHFL_T_ST25RU3993_TuningTableEntry *tuningTableEntry = (STUHFL_T_ST25RU3993_TuningTableEntry*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TuningTableEntry));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TUNING_TABLE_ENTRY, sizeof(STUHFL_T_ST25RU3993_TuningTableEntry), tuningTableEntry));
-        TRACE_DL_LOG_APPEND(" TuningTableEntry(entry: %d, freq: %d, cin: 0x%s, clen: 0x%s, cout: 0x%s, IQ: 0x%s)",
-                            tuningTableEntry->entry, tuningTableEntry->freq, byteArray2HexString(tb[0], TB_SIZE, tuningTableEntry->cin, MAX_ANTENNA), byteArray2HexString(tb[1], TB_SIZE, tuningTableEntry->clen, MAX_ANTENNA), byteArray2HexString(tb[2], TB_SIZE, tuningTableEntry->cout, MAX_ANTENNA), byteArray2HexString(tb[3], TB_SIZE, (uint8_t *)tuningTableEntry->IQ, MAX_ANTENNA * sizeof(uint16_t)));
-#undef TB_SIZE
-        break;
+    TRACE_DL_LOG_START();
+    if (((param & STUHFL_PARAM_TYPE_MASK) == STUHFL_PARAM_TYPE_ST25RU3993) && (stats != NULL)) {
+        desc = paramDesc(param & STUHFL_PARAM_KEY_MASK, PARAM_FLAG_RD);
     }
-    case STUHFL_PARAM_KEY_TUNING_TABLE_DEFAULT: {
-        STUHFL_T_ST25RU3993_TunerTableSet *tuningTableSet = (STUHFL_T_ST25RU3993_TunerTableSet*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TunerTableSet));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TUNING_TABLE_DEFAULT, sizeof(STUHFL_T_ST25RU3993_TunerTableSet), tuningTableSet));
-        TRACE_DL_LOG_APPEND(" TuningTableDefault(profile: %d, freq: %d)", tuningTableSet->profile, tuningTableSet->freq);
-        break;
+    if ((desc != NULL) && (desc->shadowSlot != 0)) {
+        stats->hits = dl->shadowHits[desc->shadowSlot - 1];
+        stats->misses = dl->shadowMisses[desc->shadowSlot - 1];
+        ret = ERR_NONE;
+        TRACE_DL_LOG("STUHFL_F_GetShadowCacheStats(param = 0x%x, hits = %d, misses = %d) = %d", param, stats->hits, stats->misses, ret);
+    } else {
+        TRACE_DL_LOG("STUHFL_F_GetShadowCacheStats(param = 0x%x) = %d", param, ret);
     }
-    case STUHFL_PARAM_KEY_TUNING_TABLE_SAVE:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TUNING_TABLE_SAVE, 0, NULL));
-        TRACE_DL_LOG_APPEND(" TuningTableSave2Flash()");
-        break;
-    case STUHFL_PARAM_KEY_TUNING_TABLE_EMPTY:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TUNING_TABLE_EMPTY, 0, NULL));
-        TRACE_DL_LOG_APPEND(" TuningTableClear()");
-        break;
+    return ret;
+}
 
-    default:
+// --------------------------------------------------------------------------
+STUHFL_T_RET_CODE SetParam_SndPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, uint8_t *sndPayload, uint16_t *sndPayloadOffset)
+{
+    const STUHFL_T_Param_Desc *desc = paramDesc(param, PARAM_FLAG_WR);
+    if (desc == NULL) {
         return ERR_PARAM;
     }
 
-    //
+    uint8_t *value = &(((uint8_t *)values)[*valuesOffset]);
+    *valuesOffset = (uint16_t)(*valuesOffset + desc->size);
+    *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], desc->tag, desc->size, (desc->size != 0) ? value : NULL));
+    desc->trace(value);
     return ERR_NONE;
 }
+
 STUHFL_T_RET_CODE SetParam_RcvPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, uint8_t *rcvPayload, uint16_t *rcvPayloadOffset)
 {
-    switch (param) {
-
-    case STUHFL_PARAM_KEY_RWD_REGISTER:
-    case STUHFL_PARAM_KEY_RWD_CONFIG:
-    case STUHFL_PARAM_KEY_RWD_ANTENNA_POWER:
-    //case STUHFL_PARAM_KEY_RWD_FREQ_RSSI:
-    //case STUHFL_PARAM_KEY_RWD_FREQ_REFLECTED:
-    case STUHFL_PARAM_KEY_RWD_CHANNEL_LIST:
-    case STUHFL_PARAM_KEY_RWD_FREQ_PROFILE:
-    case STUHFL_PARAM_KEY_RWD_FREQ_PROFILE_ADD2CUSTOM:
-    //case STUHFL_PARAM_KEY_RWD_FREQ_PROFILE_INFO:
-    case STUHFL_PARAM_KEY_RWD_FREQ_HOP:
-    case STUHFL_PARAM_KEY_RWD_FREQ_LBT:
-    case STUHFL_PARAM_KEY_RWD_FREQ_CONT_MOD:
-    case STUHFL_PARAM_KEY_RWD_GEN2PROTOCOL_CFG:
-    case STUHFL_PARAM_KEY_RWD_GB29768PROTOCOL_CFG:
-    case STUHFL_PARAM_KEY_RWD_TXRX_CFG:
-    case STUHFL_PARAM_KEY_RWD_PA_CFG:
-    case STUHFL_PARAM_KEY_RWD_GEN2TIMINGS:
-    case STUHFL_PARAM_KEY_RWD_GEN2INVENTORY_CFG:
-    case STUHFL_PARAM_KEY_RWD_GB29768INVENTORY_CFG:
-    case STUHFL_PARAM_KEY_TUNING_CAPS:
-    case STUHFL_PARAM_KEY_TUNING:
-    case STUHFL_PARAM_KEY_TUNING_TABLE_ENTRY:
-    case STUHFL_PARAM_KEY_TUNING_TABLE_DEFAULT:
-    case STUHFL_PARAM_KEY_TUNING_TABLE_SAVE:
-    case STUHFL_PARAM_KEY_TUNING_TABLE_EMPTY:
-        break;
-    default:
-        return ERR_PARAM;
-    }
-
-    //
-    return ERR_NONE;
+    // SET replies carry no data
+    (void)values;
+    (void)valuesOffset;
+    (void)rcvPayload;
+    (void)rcvPayloadOffset;
+    return (paramDesc(param, PARAM_FLAG_WR) != NULL) ? ERR_NONE : ERR_PARAM;
 }
 
 STUHFL_T_RET_CODE GetParam_SndPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, uint8_t *sndPayload, uint16_t *sndPayloadOffset)
 {
-    switch (param) {
-
-    case STUHFL_PARAM_KEY_RWD_REGISTER: {
-        STUHFL_T_ST25RU3993_Register *reg = (STUHFL_T_ST25RU3993_Register*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Register));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlv8(&sndPayload[*sndPayloadOffset], STUHFL_TAG_REGISTER, reg->addr));
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_CONFIG: {
-        STUHFL_T_ST25RU3993_RwdConfig *cfg = (STUHFL_T_ST25RU3993_RwdConfig*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_RwdConfig));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlv8(&sndPayload[*sndPayloadOffset], STUHFL_TAG_RWD_CONFIG, cfg->id));
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_ANTENNA_POWER:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_ANTENNA_POWER, 0, NULL));
-        break;
-
-    case STUHFL_PARAM_KEY_RWD_FREQ_RSSI: {
-        STUHFL_T_ST25RU3993_Freq_Rssi *freqRssi = (STUHFL_T_ST25RU3993_Freq_Rssi*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_Rssi));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlv32(&sndPayload[*sndPayloadOffset], STUHFL_TAG_FREQ_RSSI, freqRssi->frequency));
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_FREQ_REFLECTED: {
-        STUHFL_T_ST25RU3993_Freq_ReflectedPower_Info *freqRefl = (STUHFL_T_ST25RU3993_Freq_ReflectedPower_Info*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_ReflectedPower_Info));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_FREQ_REFLECTED, sizeof(freqRefl->frequency) + sizeof(freqRefl->applyTunerSetting), freqRefl));
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_CHANNEL_LIST: {
-        STUHFL_T_ST25RU3993_ChannelList *channelList = (STUHFL_T_ST25RU3993_ChannelList*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_ChannelList));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_CHANNEL_LIST, sizeof(channelList->antenna) + sizeof(channelList->persistent), channelList));
-        break;
-    }
-
-    //case STUHFL_PARAM_KEY_RWD_FREQ_ADD_2_PROFILE:
-
-    case STUHFL_PARAM_KEY_RWD_FREQ_PROFILE_INFO: {
-        STUHFL_T_ST25RU3993_Freq_Profile_Info *freqProfInfo = (STUHFL_T_ST25RU3993_Freq_Profile_Info*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_Profile_Info));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_FREQ_PROFILE_INFO, sizeof(freqProfInfo->profile), freqProfInfo));
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_FREQ_HOP:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_FREQ_HOP, 0, NULL));
-        break;
-    case STUHFL_PARAM_KEY_RWD_FREQ_LBT:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_FREQ_LBT, 0, NULL));
-        break;
-
-    //case STUHFL_PARAM_KEY_RWD_FREQ_CONT_MOD:
-
-    case STUHFL_PARAM_KEY_RWD_GEN2TIMINGS:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_GEN2TIMINGS, 0, NULL));
-        break;
-    case STUHFL_PARAM_KEY_RWD_GEN2PROTOCOL_CFG:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_GEN2PROTOCOL_CFG, 0, NULL));
-        break;
-    case STUHFL_PARAM_KEY_RWD_GB29768PROTOCOL_CFG:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_GB29768PROTOCOL_CFG, 0, NULL));
-        break;
-    case STUHFL_PARAM_KEY_RWD_TXRX_CFG:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TXRX_CFG, 0, NULL));
-        break;
-    case STUHFL_PARAM_KEY_RWD_PA_CFG:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_PA_CFG, 0, NULL));
-        break;
-    case STUHFL_PARAM_KEY_RWD_GEN2INVENTORY_CFG:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_GEN2INVENTORY_CFG, 0, NULL));
-        break;
-    case STUHFL_PARAM_KEY_RWD_GB29768INVENTORY_CFG:
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_GB29768INVENTORY_CFG, 0, NULL));
-        break;
-
-    case STUHFL_PARAM_KEY_TUNING_CAPS: {
-        STUHFL_T_ST25RU3993_TuningCaps *tuning = (STUHFL_T_ST25RU3993_TuningCaps*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TuningCaps));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TUNING_CAPS, sizeof(tuning->antenna) + sizeof(tuning->channelListIdx), tuning));
-        break;
-    }
-    case STUHFL_PARAM_KEY_TUNING: {
-        STUHFL_T_ST25RU3993_Tuning *tuning = (STUHFL_T_ST25RU3993_Tuning*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Tuning));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TUNING, sizeof(tuning->antenna), tuning));
-        break;
-    }
-    case STUHFL_PARAM_KEY_TUNING_TABLE_ENTRY: {
-        STUHFL_T_ST25RU3993_TuningTableEntry *tuningTableEntry = (STUHFL_T_ST25RU3993_TuningTableEntry*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TuningTableEntry));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TUNING_TABLE_ENTRY, sizeof(tuningTableEntry->entry), tuningTableEntry));
-        break;
-    }
-    case STUHFL_PARAM_KEY_TUNING_TABLE_INFO: {
-        STUHFL_T_ST25RU3993_TuningTableInfo *tuningTableInfo = (STUHFL_T_ST25RU3993_TuningTableInfo*)&(((uint8_t *)values)[*valuesOffset]);
-        *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TuningTableInfo));
-        *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], STUHFL_TAG_TUNING_TABLE_INFO, sizeof(tuningTableInfo->profile), tuningTableInfo));
-        break;
-    }
-    default:
+    const STUHFL_T_Param_Desc *desc = paramDesc(param, PARAM_FLAG_RD);
+    if (desc == NULL) {
         return ERR_PARAM;
     }
 
-    //
+    uint8_t *value = &(((uint8_t *)values)[*valuesOffset]);
+    *valuesOffset = (uint16_t)(*valuesOffset + desc->size);
+    *sndPayloadOffset = (uint16_t)(*sndPayloadOffset + (uint16_t)addTlvExt(&sndPayload[*sndPayloadOffset], desc->tag, desc->getLen, (desc->getLen != 0) ? value : NULL));
     return ERR_NONE;
 }
-STUHFL_T_RET_CODE GetParam_RcvPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, uint8_t *rcvPayload, uint16_t rcvPayloadAvailable, uint16_t *rcvPayloadOffset)
-{
-    uint8_t tag;
-    uint16_t len;
 
-    switch (param) {
-    case STUHFL_PARAM_KEY_RWD_REGISTER: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Register)) {
-            STUHFL_T_ST25RU3993_Register *reg = (STUHFL_T_ST25RU3993_Register*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Register));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, reg));
-            TRACE_DL_LOG_APPEND(" Register(addr: 0x%02x, data: 0x%02x)", reg->addr, reg->data);
-        }
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_CONFIG: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_RwdConfig)) {
-            STUHFL_T_ST25RU3993_RwdConfig *cfg = (STUHFL_T_ST25RU3993_RwdConfig*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_RwdConfig));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, cfg));
-            TRACE_DL_LOG_APPEND(" RwdCfg(id: 0x%02x, value: 0x%02x)", cfg->id, cfg->value);
-        }
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_ANTENNA_POWER: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Antenna_Power)) {
-            STUHFL_T_ST25RU3993_Antenna_Power *antPwr = (STUHFL_T_ST25RU3993_Antenna_Power *)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Antenna_Power));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, antPwr));
-            TRACE_DL_LOG_APPEND(" AntennaPower(mode: 0x%02x timeout: %d, frequency: %d)", antPwr->mode, antPwr->timeout, antPwr->frequency);
-        }
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_FREQ_RSSI: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Freq_Rssi)) {
-            STUHFL_T_ST25RU3993_Freq_Rssi *freqRssi = (STUHFL_T_ST25RU3993_Freq_Rssi*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_Rssi));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, freqRssi));
-            TRACE_DL_LOG_APPEND(" FreqRSSI(frequency: %d, rssiLogI: %d, rssiLogQ: %d)", freqRssi->frequency, freqRssi->rssiLogI, freqRssi->rssiLogQ);
-        }
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_FREQ_REFLECTED: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Freq_ReflectedPower_Info)) {
-            STUHFL_T_ST25RU3993_Freq_ReflectedPower_Info *freqReflectedPower = (STUHFL_T_ST25RU3993_Freq_ReflectedPower_Info*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_ReflectedPower_Info));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, freqReflectedPower));
-            TRACE_DL_LOG_APPEND(" FreqReflectedPower(frequency: %d, applyTunerSetting: %d, reflectedI: %d, reflectedQ: %d)", freqReflectedPower->frequency, freqReflectedPower->applyTunerSetting, freqReflectedPower->reflectedI, freqReflectedPower->reflectedQ);
-        }
-        break;
-    }
-
-    //case STUHFL_PARAM_KEY_RWD_FREQ_ADD_2_PROFILE:
-
-    case STUHFL_PARAM_KEY_RWD_CHANNEL_LIST: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_ChannelList)) {
-            STUHFL_T_ST25RU3993_ChannelList *channelList = (STUHFL_T_ST25RU3993_ChannelList*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_ChannelList));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, channelList));
-            TRACE_DL_LOG_APPEND(" ChannelList(antenna: %d, nFrequencies: %d, currentChannelListIdx: %d, persistent: %d, idx:{Freq, (cin,clen,cout)} = ", channelList->antenna, channelList->nFrequencies, channelList->currentChannelListIdx, channelList->persistent);
-            for (int i = 0; i < channelList->nFrequencies; i++) {
-                TRACE_DL_LOG_APPEND("%d:{%d, (%d,%d,%d)}, ", i, channelList->item[i].frequency, channelList->item[i].caps.cin, channelList->item[i].caps.clen, channelList->item[i].caps.cout);
-            }
-        }
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_FREQ_PROFILE_INFO: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Freq_Profile_Info)) {
-            STUHFL_T_ST25RU3993_Freq_Profile_Info *freqProfileInfo = (STUHFL_T_ST25RU3993_Freq_Profile_Info*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_Profile_Info));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, freqProfileInfo));
-            TRACE_DL_LOG_APPEND(" FreqProfileInfo(profile: %d, minFreq : %d, maxFreq: %d, numFrequencies : %d)", freqProfileInfo->profile, freqProfileInfo->minFrequency, freqProfileInfo->maxFrequency, freqProfileInfo->numFrequencies);
-        }
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_FREQ_HOP: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Freq_Hop)) {
-            STUHFL_T_ST25RU3993_Freq_Hop *freqHop = (STUHFL_T_ST25RU3993_Freq_Hop*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_Hop));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, freqHop));
-            TRACE_DL_LOG_APPEND(" FreqHop(maxSendingTime: %d)", freqHop->maxSendingTime);
-        }
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_RWD_FREQ_LBT: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Freq_LBT)) {
-            STUHFL_T_ST25RU3993_Freq_LBT *freqLBT = (STUHFL_T_ST25RU3993_Freq_LBT*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Freq_LBT));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, freqLBT));
-            TRACE_DL_LOG_APPEND(" FreqLBT(listeningTime: %d, idleTime: %d, rssiLogThreshold: %d, skipLBTcheck: %d)", freqLBT->listeningTime, freqLBT->idleTime, freqLBT->rssiLogThreshold, freqLBT->skipLBTcheck);
-        }
-        break;
-    }
-
-    //case STUHFL_PARAM_KEY_RWD_FREQ_CONT_MOD:
-
-    case STUHFL_PARAM_KEY_RWD_GEN2TIMINGS: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_Gen2_Timings)) {
-            STUHFL_T_Gen2_Timings *gen2Timings = (STUHFL_T_Gen2_Timings*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_Gen2_Timings));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, gen2Timings));
-            TRACE_DL_LOG_APPEND(" GetGen2Timings(T4Min: %d)", gen2Timings->T4Min);
-        }
-        break;
-    }
-    case STUHFL_PARAM_KEY_RWD_GEN2PROTOCOL_CFG: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Gen2Protocol_Cfg)) {
-            STUHFL_T_ST25RU3993_Gen2Protocol_Cfg *gen2ProtocolCfg = (STUHFL_T_ST25RU3993_Gen2Protocol_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Gen2Protocol_Cfg));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, gen2ProtocolCfg));
-            TRACE_DL_LOG_APPEND(" Gen2ProtocolCfg(tari: %d, blf: %d, coding: %d, trext: %d)",
-                                gen2ProtocolCfg->tari, gen2ProtocolCfg->blf, gen2ProtocolCfg->coding, gen2ProtocolCfg->trext);
-        }
-        break;
-    }
-    case STUHFL_PARAM_KEY_RWD_GB29768PROTOCOL_CFG: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Gb29768Protocol_Cfg)) {
-            STUHFL_T_ST25RU3993_Gb29768Protocol_Cfg *gb29768ProtocolCfg = (STUHFL_T_ST25RU3993_Gb29768Protocol_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Gb29768Protocol_Cfg));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, gb29768ProtocolCfg));
-            TRACE_DL_LOG_APPEND(" Gb29768ProtocolCfg(tc: %d, blf: %d, coding: %d, trext: %d)", gb29768ProtocolCfg->tc, gb29768ProtocolCfg->blf, gb29768ProtocolCfg->coding, gb29768ProtocolCfg->trext);
-        }
-        break;
-    }
-    case STUHFL_PARAM_KEY_RWD_TXRX_CFG: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_TxRx_Cfg)) {
-            STUHFL_T_ST25RU3993_TxRx_Cfg *txRxCfg = (STUHFL_T_ST25RU3993_TxRx_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TxRx_Cfg));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, txRxCfg));
-            TRACE_DL_LOG_APPEND(" TxRxCfg(txOutputLevel: %d, rxSensitivity: %d, usedAntenna: %d, alternateAntennaInterval: %d)", txRxCfg->txOutputLevel, txRxCfg->rxSensitivity, txRxCfg->usedAntenna, txRxCfg->alternateAntennaInterval);
-        }
-        break;
-    }
-    case STUHFL_PARAM_KEY_RWD_PA_CFG: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_PA_Cfg)) {
-            STUHFL_T_ST25RU3993_PA_Cfg *paCfg = (STUHFL_T_ST25RU3993_PA_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_PA_Cfg));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, paCfg));
-            TRACE_DL_LOG_APPEND(" PA_Cfg(useExternal: %d)", paCfg->useExternal);
-        }
-        break;
-    }
-    case STUHFL_PARAM_KEY_RWD_GEN2INVENTORY_CFG: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Gen2Inventory_Cfg)) {
-            STUHFL_T_ST25RU3993_Gen2Inventory_Cfg *invGen2Cfg = (STUHFL_T_ST25RU3993_Gen2Inventory_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Gen2Inventory_Cfg));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, invGen2Cfg));
-            TRACE_DL_LOG_APPEND(" Gen2InventoryCfg(fastInv: %d, autoAck: %d, readTID: %d, startQ: %d, adaptiveQEnable: %d, minQ: %d, maxQ: %d, adjustOptions: %d, C1: (%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d), C2: (%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d), autoTuningInterval: %d, autoTuningLevel: %d, autoTuningAlgo: %d, autoTuningFalsePositiveDetection: %d, sel: %d, session: %d, target: %d, toggleTarget: %d, targetDepletionMode: %d, adaptiveSensitivityEnable: %d, adaptiveSensitivityInterval: %d)",
-                                invGen2Cfg->fastInv, invGen2Cfg->autoAck, invGen2Cfg->readTID,
-                                invGen2Cfg->startQ, invGen2Cfg->adaptiveQEnable, invGen2Cfg->minQ, invGen2Cfg->maxQ, invGen2Cfg->adjustOptions,
-                                invGen2Cfg->C1[0], invGen2Cfg->C1[1], invGen2Cfg->C1[2], invGen2Cfg->C1[3], invGen2Cfg->C1[4], invGen2Cfg->C1[5], invGen2Cfg->C1[6], invGen2Cfg->C1[7],
-                                invGen2Cfg->C1[8], invGen2Cfg->C1[9], invGen2Cfg->C1[10], invGen2Cfg->C1[11], invGen2Cfg->C1[12], invGen2Cfg->C1[13], invGen2Cfg->C1[14], invGen2Cfg->C1[15],
-                                invGen2Cfg->C2[0], invGen2Cfg->C2[1], invGen2Cfg->C2[2], invGen2Cfg->C2[3], invGen2Cfg->C2[4], invGen2Cfg->C2[5], invGen2Cfg->C2[6], invGen2Cfg->C2[7],
-                                invGen2Cfg->C2[8], invGen2Cfg->C2[9], invGen2Cfg->C2[10], invGen2Cfg->C2[11], invGen2Cfg->C2[12], invGen2Cfg->C2[13], invGen2Cfg->C2[14], invGen2Cfg->C2[15],
-                                invGen2Cfg->autoTuningInterval, invGen2Cfg->autoTuningLevel, invGen2Cfg->autoTuningAlgo & ~TUNING_ALGO_ENABLE_FPD, (invGen2Cfg->autoTuningAlgo & TUNING_ALGO_ENABLE_FPD) ? true : false,
-                                invGen2Cfg->sel, invGen2Cfg->session, invGen2Cfg->target, invGen2Cfg->toggleTarget, invGen2Cfg->targetDepletionMode,
-                                invGen2Cfg->adaptiveSensitivityEnable, invGen2Cfg->adaptiveSensitivityInterval);
-        }
-        break;
-    }
-    case STUHFL_PARAM_KEY_RWD_GB29768INVENTORY_CFG: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg)) {
-            STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg *invGb29768Cfg = (STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Gb29768Inventory_Cfg));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, invGb29768Cfg));
-            TRACE_DL_LOG_APPEND(" Gb29768InventoryCfg(readTID: %d, autoTuningInterval: %d, autoTuningLevel: %d, autoTuningAlgo: %d, autoTuningFalsePositiveDetection: %d, adaptiveSensitivityEnable: %d, adaptiveSensitivityInterval: %d, condition: %d, session: %d, target: %d, toggleTarget: %d, targetDepletionMode: %d, endThreshold:%d, ccnThreshold:%d, cinThreshold:%d)",
-                                invGb29768Cfg->readTID,
-                                invGb29768Cfg->autoTuningInterval, invGb29768Cfg->autoTuningLevel, invGb29768Cfg->autoTuningAlgo & ~TUNING_ALGO_ENABLE_FPD, (invGb29768Cfg->autoTuningAlgo & TUNING_ALGO_ENABLE_FPD) ? true : false,
-                                invGb29768Cfg->adaptiveSensitivityEnable, invGb29768Cfg->adaptiveSensitivityInterval,
-                                invGb29768Cfg->condition, invGb29768Cfg->session, invGb29768Cfg->target, invGb29768Cfg->toggleTarget, invGb29768Cfg->targetDepletionMode,
-                                invGb29768Cfg->endThreshold, invGb29768Cfg->ccnThreshold, invGb29768Cfg->cinThreshold);
-        }
-        break;
-    }
-
-    case STUHFL_PARAM_KEY_TUNING_CAPS: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_TuningCaps)) {
-            STUHFL_T_ST25RU3993_TuningCaps *tuning = (STUHFL_T_ST25RU3993_TuningCaps*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TuningCaps));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, tuning));
-            TRACE_DL_LOG_APPEND(" Tuning(antenna: %d, channelListIdx: %d, cin: %d, clen: %d, cout: %d)", tuning->antenna, tuning->channelListIdx, tuning->caps.cin, tuning->caps.clen, tuning->caps.cout);
-        }
-        break;
-    }
-    case STUHFL_PARAM_KEY_TUNING: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_Tuning)) {
-            STUHFL_T_ST25RU3993_Tuning *tuning = (STUHFL_T_ST25RU3993_Tuning*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_Tuning));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, tuning));
-            TRACE_DL_LOG_APPEND(" Tuning(antenna: %d, cin: %d, clen: %d, cout: %d)", tuning->antenna, tuning->cin, tuning->clen, tuning->cout);
-        }
-        break;
-    }
-    case STUHFL_PARAM_KEY_TUNING_TABLE_ENTRY: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_TuningTableEntry)) {
-#define TB_SIZE    128
-            char tb[4][TB_SIZE];
-            STUHFL_T_ST25RU3993_TuningTableEntry *tuningTableEntry = (STUHFL_T_ST25RU3993_TuningTableEntry*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TuningTableEntry));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, tuningTableEntry));
-            TRACE_DL_LOG_APPEND(" TuningTableEntry(entry: %d, freq: %d, cin: 0x%s, clen: 0x%s, cout: 0x%s, IQ: 0x%s)",
-                                tuningTableEntry->entry, tuningTableEntry->freq, byteArray2HexString(tb[0], TB_SIZE, tuningTableEntry->cin, MAX_ANTENNA), byteArray2HexString(tb[1], TB_SIZE, tuningTableEntry->clen, MAX_ANTENNA), byteArray2HexString(tb[2], TB_SIZE, tuningTableEntry->cout, MAX_ANTENNA), byteArray2HexString(tb[3], TB_SIZE, (uint8_t *)tuningTableEntry->IQ, MAX_ANTENNA * sizeof(uint16_t)));
-#undef TB_SIZE
-        }
-        break;
-    }
-    case STUHFL_PARAM_KEY_TUNING_TABLE_INFO: {
-        if (rcvPayloadAvailable >= sizeof(STUHFL_T_ST25RU3993_TuningTableInfo)) {
-            STUHFL_T_ST25RU3993_TuningTableInfo *tuningTableInfo = (STUHFL_T_ST25RU3993_TuningTableInfo*)&(((uint8_t *)values)[*valuesOffset]);
-            *valuesOffset = (uint16_t)(*valuesOffset + (uint16_t)sizeof(STUHFL_T_ST25RU3993_TuningTableInfo));
-            *rcvPayloadOffset = (uint16_t)(*rcvPayloadOffset + (uint16_t)getTlvExt(&rcvPayload[*rcvPayloadOffset], &tag, &len, tuningTableInfo));
-            TRACE_DL_LOG_APPEND(" TuningTableInfo(profile: %d, numEntries: %d)", tuningTableInfo->profile, tuningTableInfo->numEntries);
-        }
-        break;
-    }
-    default:
+STUHFL_T_RET_CODE GetParam_RcvPayload_TYPE_ST25RU3993(STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE *values, uint16_t *valuesOffset, STUHFL_T_TlvIter *it)
+{
+    STUHFL_T_Tlv tlv;
+    const STUHFL_T_Param_Desc *desc = paramDesc(param, PARAM_FLAG_RD);
+    if (desc == NULL) {
         return ERR_PARAM;
     }
 
-    //
-    return ERR_NONE;
+    // every requested param is replied, a missing one would shift all following values
+    if (!tlvIterNext(it, &tlv)) {
+        return ERR_PROTO;
+    }
+    uint8_t *value = &(((uint8_t *)values)[*valuesOffset]);
+    *valuesOffset = (uint16_t)(*valuesOffset + desc->size);
+    tlvCopy(&tlv, value, desc->size);
+    desc->trace(value);
+    return it->overrun ? ERR_PROTO : ERR_NONE;
 }
 
 /**
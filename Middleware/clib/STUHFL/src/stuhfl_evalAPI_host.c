@@ -33,6 +33,10 @@
   * @{
   */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
 #include "stuhfl.h"
 #include "stuhfl_sl.h"
 #include "stuhfl_sl_gen2.h"
@@ -45,6 +49,7 @@
 #include "stuhfl_err.h"
 #include "stuhfl_helpers.h"
 #include "stuhfl_log.h"
+#include "stuhfl_ctx.h"
 
 //
 #define TRACE_EVAL_API_CLEAR()    { STUHFL_F_LogClear(LOG_LEVEL_TRACE_EVAL_API); }
@@ -54,20 +59,54 @@
 #define TRACE_EVAL_API_START()      { STUHFL_F_LogClear(LOG_LEVEL_TRACE_EVAL_API); }
 #define TRACE_EVAL_API(...)         { STUHFL_F_LogAppend(LOG_LEVEL_TRACE_EVAL_API, __VA_ARGS__); STUHFL_F_LogFlush(LOG_LEVEL_TRACE_EVAL_API); }
 
-//
-STUHFL_T_DEVICE_CTX device = 0;
+// device handle and frame buffers are kept per reader in STUHFL_T_API_Ctx, see stuhfl_ctx.h
 #define SND_BUFFER_SIZE         (UART_RX_BUFFER_SIZE)   /* HOST SND buffer based on FW RCV buffer */
 #define RCV_BUFFER_SIZE         (UART_TX_BUFFER_SIZE)   /* HOST RCV buffer based on FW SND buffer */
-uint8_t sndData[SND_BUFFER_SIZE];
-uint16_t sndDataLen = SND_BUFFER_SIZE;
-uint8_t rcvData[RCV_BUFFER_SIZE];
-uint16_t rcvDataLen = RCV_BUFFER_SIZE;
+
+// baudrate probing, candidates from highest to lowest
+static const uint32_t probeBaudrates[] = { 3000000, 2000000, 1500000, 1000000, 921600, 460800, 230400, 115200 };
+#define PROBE_BOOT_TIMEOUT_MS   1500    // time the board may need to answer after the reset done on connect
+#define PROBE_RD_TIMEOUT_MS     100     // read timeout of a single version exchange
+#define PROBE_CACHE_MAX_LINES   64
+#define READY_PROBE_RD_TIMEOUT_MS   20  // read timeout of a single version probe while waiting for the board
+#define PROBE_CACHE_LINE_LEN    256
+#define PROBE_CACHE_TMP_SUFFIX  ".tmp"
+
+static STUHFL_T_RET_CODE probeBaudrate(STUHFL_T_BaudProbe *probe);
+static bool probeCacheLookup(const char *cacheFile, const char *port, uint32_t *br);
+static void probeCacheStore(const char *cacheFile, const char *port, uint32_t br);
+
+// profile members in the order they are applied
+typedef struct {
+    uint16_t                            use;
+    STUHFL_T_PARAM                      param;
+    uint16_t                            offset;
+    uint16_t                            size;
+} STUHFL_T_Profile_Member;
+
+#define PROFILE_MEMBER(u, k, m)     { u, STUHFL_PARAM_TYPE_ST25RU3993 | k, (uint16_t)offsetof(STUHFL_T_Reader_Profile, m), (uint16_t)sizeof(((STUHFL_T_Reader_Profile *)0)->m) }
+static const STUHFL_T_Profile_Member profileMembers[] = {
+    PROFILE_MEMBER(STUHFL_D_PROFILE_TXRX_CFG,           STUHFL_PARAM_KEY_RWD_TXRX_CFG,          txRxCfg),
+    PROFILE_MEMBER(STUHFL_D_PROFILE_GEN2INVENTORY_CFG,  STUHFL_PARAM_KEY_RWD_GEN2INVENTORY_CFG, gen2InventoryCfg),
+    PROFILE_MEMBER(STUHFL_D_PROFILE_GEN2PROTOCOL_CFG,   STUHFL_PARAM_KEY_RWD_GEN2PROTOCOL_CFG,  gen2ProtocolCfg),
+    PROFILE_MEMBER(STUHFL_D_PROFILE_FREQ_LBT,           STUHFL_PARAM_KEY_RWD_FREQ_LBT,          freqLBT),
+    PROFILE_MEMBER(STUHFL_D_PROFILE_CHANNEL_LIST,       STUHFL_PARAM_KEY_RWD_CHANNEL_LIST,      channelList),
+    PROFILE_MEMBER(STUHFL_D_PROFILE_FREQ_HOP,           STUHFL_PARAM_KEY_RWD_FREQ_HOP,          freqHop),
+    PROFILE_MEMBER(STUHFL_D_PROFILE_ANTENNA_POWER,      STUHFL_PARAM_KEY_RWD_ANTENNA_POWER,     antennaPower),
+};
+#define PROFILE_MEMBER_CNT          (sizeof(profileMembers) / sizeof(profileMembers[0]))
+#define PROFILE_FRAME_PAYLOAD_MAX   (SND_BUFFER_SIZE - COMM_PAYLOAD_POS - 1U)  /* board receive buffer less header and signature */
+
+static STUHFL_T_RET_CODE applyProfileFrame(STUHFL_T_Reader_Profile *profile, uint16_t members, STUHFL_T_PARAM_CNT paramCnt, STUHFL_T_PARAM *params, uint8_t *values);
+static void forgetProfileMembers(uint16_t use);
 
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV Connect(char *szComPort)
 {
+    STUHFL_T_API_Ctx *api = &STUHFL_F_CurReaderCtx()->api;
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_PORT, (STUHFL_T_PARAM_VALUE)szComPort);
-    retCode |= STUHFL_F_Connect(&device, sndData, SND_BUFFER_SIZE, rcvData, RCV_BUFFER_SIZE);
+    retCode |= STUHFL_F_Connect(&api->device, api->sndData, SND_BUFFER_SIZE, api->rcvData, RCV_BUFFER_SIZE);
+    forgetProfileMembers(STUHFL_D_PROFILE_ALL);
     // enable data line
     uint8_t on = TRUE;
     retCode |= STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_DTR, (STUHFL_T_PARAM_VALUE)&on);
@@ -82,9 +121,149 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV Connect(char *szComPort)
 
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV Disconnect()
 {
+    forgetProfileMembers(STUHFL_D_PROFILE_ALL);
     return STUHFL_F_Disconnect();
 }
 
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV ConnectWaitReady(char *szComPort, uint32_t bootTimeout, uint32_t *bootTime)
+{
+    STUHFL_T_RET_CODE retCode = Connect(szComPort);
+    if (retCode == ERR_NONE) {
+        retCode = WaitForBoard(bootTimeout, bootTime);
+    }
+    return retCode;
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV WaitForBoard(uint32_t bootTimeout, uint32_t *bootTime)
+{
+    STUHFL_T_Version swVersion;
+    STUHFL_T_Version hwVersion;
+    uint32_t rdTimeout = 0;
+    uint32_t probeTimeout = READY_PROBE_RD_TIMEOUT_MS;
+    STUHFL_T_RET_CODE retCode;
+
+    STUHFL_F_GetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, &rdTimeout);
+    STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, &probeTimeout);
+
+    // probe until the firmware answers, requests sent while still booting are lost
+    // and whatever the board sent so far is dropped before the next try
+    uint32_t startTime = getMilliCount();
+    uint32_t elapsed;
+    do {
+        retCode = GetBoardVersion(&swVersion, &hwVersion);
+        if (retCode != ERR_NONE) {
+            STUHFL_F_Reset(STUHFL_RESET_TYPE_CLEAR_COMM);
+        }
+        elapsed = getMilliSpan(startTime);
+    } while ((retCode != ERR_NONE) && (elapsed < bootTimeout));
+
+    STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, &rdTimeout);
+    if (retCode != ERR_NONE) {
+        retCode = ERR_TIMEOUT;
+    }
+    if (bootTime) {
+        *bootTime = elapsed;
+    }
+    TRACE_EVAL_API_START();
+    TRACE_EVAL_API("WaitForBoard(bootTimeout: %d, bootTime: %d) = %d", bootTimeout, elapsed, retCode);
+    return retCode;
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV ConnectAutoBaud(char *szComPort, STUHFL_T_BaudProbe *probe)
+{
+    STUHFL_T_ParamTypeConnectionBR prevBr = 0;
+    STUHFL_T_ParamTypeConnectionBR br = 0;
+    STUHFL_T_RET_CODE retCode;
+
+    if ((szComPort == NULL) || (probe == NULL) || (probe->exchanges == 0)) {
+        return ERR_PARAM;
+    }
+    probe->br = 0;
+    probe->avgRttUs = 0;
+    probe->errors = 0;
+    probe->candidates = 0;
+    probe->cached = false;
+    STUHFL_F_GetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_BR, &prevBr);
+
+    // a cached baudrate is trusted after a single good exchange
+    if (!probe->forceProbe && probeCacheLookup(probe->cacheFile, szComPort, &br)) {
+        STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_BR, &br);
+        retCode = Connect(szComPort);
+        if (retCode == ERR_NONE) {
+            STUHFL_T_BaudProbe check = *probe;
+            check.exchanges = 1;
+            retCode = probeBaudrate(&check);
+            if (retCode == ERR_NONE) {
+                probe->br = br;
+                probe->avgRttUs = check.avgRttUs;
+                probe->cached = true;
+                TRACE_EVAL_API_START();
+                TRACE_EVAL_API("ConnectAutoBaud(Port: %s, cached br: %d) = %d", szComPort, br, retCode);
+                return ERR_NONE;
+            }
+        }
+        Disconnect();
+    }
+
+    retCode = ERR_IO;
+    for (uint8_t i = 0; i < (sizeof(probeBaudrates) / sizeof(probeBaudrates[0])); i++) {
+        br = probeBaudrates[i];
+        probe->candidates++;
+        STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_BR, &br);
+        retCode = Connect(szComPort);
+        if (retCode == ERR_NONE) {
+            retCode = probeBaudrate(probe);
+        }
+        TRACE_EVAL_API_START();
+        TRACE_EVAL_API("ConnectAutoBaud(Port: %s, probed br: %d, avgRtt: %dus, errors: %d/%d) = %d", szComPort, br, probe->avgRttUs, probe->errors, probe->exchanges, retCode);
+        if (retCode == ERR_NONE) {
+            probe->br = br;
+            probeCacheStore(probe->cacheFile, szComPort, br);
+            return ERR_NONE;
+        }
+        Disconnect();
+    }
+
+    // nothing stable, leave the configured baudrate as it was
+    STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_BR, &prevBr);
+    probe->avgRttUs = 0;
+    probe->errors = 0;
+    return ERR_IO;
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV ConnectReader(STUHFL_T_READER_CTX *ctx, char *szComPort)
+{
+    STUHFL_T_READER_CTX prevCtx = STUHFL_F_GetReaderCtx();
+    STUHFL_T_RET_CODE retCode = STUHFL_F_CreateReaderCtx(ctx);
+    if (retCode != ERR_NONE) {
+        return retCode;
+    }
+
+    STUHFL_F_SelectReaderCtx(*ctx);
+    retCode = Connect(szComPort);
+    if (retCode != ERR_NONE) {
+        STUHFL_F_Disconnect();
+        STUHFL_F_SelectReaderCtx(prevCtx);
+        // a context that can not be destroyed yet is left to the caller, to be released with DisconnectReader
+        if (STUHFL_F_DestroyReaderCtx(*ctx) == ERR_NONE) {
+            *ctx = NULL;
+        }
+    }
+    return retCode;
+}
+
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV DisconnectReader(STUHFL_T_READER_CTX ctx)
+{
+    STUHFL_T_READER_CTX prevCtx = STUHFL_F_GetReaderCtx();
+    STUHFL_F_SelectReaderCtx(ctx);
+    STUHFL_T_RET_CODE retCode = STUHFL_F_Disconnect();
+    STUHFL_F_SelectReaderCtx((prevCtx != ctx) ? prevCtx : NULL);
+    if (retCode == ERR_NONE) {
+        retCode = STUHFL_F_DestroyReaderCtx(ctx);
+    }
+    return retCode;
+}
+
 // ---- Getter Generic ----
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV GetBoardVersion(STUHFL_T_Version *swVersion, STUHFL_T_Version *hwVersion)
 {
@@ -113,12 +292,14 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV GetBoardInfo(STUHFL_T_Version_Info *s
 STUHFL_DLL_API void CALL_CONV Reboot()
 {
     TRACE_EVAL_API_START();
+    forgetProfileMembers(STUHFL_D_PROFILE_ALL);
     STUHFL_F_Reboot();
     TRACE_EVAL_API("Reboot()");
 }
 STUHFL_DLL_API void CALL_CONV EnterBootloader()
 {
     TRACE_EVAL_API_START();
+    forgetProfileMembers(STUHFL_D_PROFILE_ALL);
     STUHFL_F_EnterBootloader();
     TRACE_EVAL_API("EnterBootloader()");
 }
@@ -222,6 +403,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetAntennaPower(STUHFL_T_ST25RU3993_A
     if (ERR_NONE == STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&tmpRdTimeOut)) {
         // set power..
         retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_ANTENNA_POWER, (STUHFL_T_PARAM_VALUE)antPwr);
+        forgetProfileMembers(STUHFL_D_PROFILE_ANTENNA_POWER);
         // revert max timeout
         retCode |= STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&rdTimeOut);
     }
@@ -254,6 +436,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetChannelList(STUHFL_T_ST25RU3993_Ch
 {
     TRACE_EVAL_API_CLEAR();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_CHANNEL_LIST, (STUHFL_T_PARAM_VALUE)channelList);
+    forgetProfileMembers(STUHFL_D_PROFILE_CHANNEL_LIST);
     TRACE_EVAL_API_APPEND("SetChannelList(antenna: %d, nFrequencies: %d, currentChannelListIdx: %d, persistent: %d, idx:{Freq, (cin,clen,cout)} = ", channelList->antenna, channelList->nFrequencies, channelList->currentChannelListIdx, channelList->persistent);
     for (int i = 0; i < channelList->nFrequencies; i++) {
         TRACE_EVAL_API_APPEND("%d:{%d, (%d,%d,%d)}, ", i, channelList->item[i].frequency, channelList->item[i].caps.cin, channelList->item[i].caps.clen, channelList->item[i].caps.cout);
@@ -266,6 +449,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetFreqProfile(STUHFL_T_ST25RU3993_Fr
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_FREQ_PROFILE, (STUHFL_T_PARAM_VALUE)freqProfile);
+    forgetProfileMembers(STUHFL_D_PROFILE_CHANNEL_LIST);
     TRACE_EVAL_API("SetFreqProfile(profile: %d) = %d", freqProfile->profile, retCode);
     return retCode;
 }
@@ -273,6 +457,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetFreqProfileAdd2Custom(STUHFL_T_ST2
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_FREQ_PROFILE_ADD2CUSTOM, (STUHFL_T_PARAM_VALUE)freqProfileAdd);
+    forgetProfileMembers(STUHFL_D_PROFILE_CHANNEL_LIST);
     TRACE_EVAL_API("SetFreqProfileAdd2Custom(clearList: %d, frequency: %d) = %d", freqProfileAdd->clearList, freqProfileAdd->frequency, retCode);
     return retCode;
 }
@@ -280,6 +465,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetFreqHop(STUHFL_T_ST25RU3993_Freq_H
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_FREQ_HOP, (STUHFL_T_PARAM_VALUE)freqHop);
+    forgetProfileMembers(STUHFL_D_PROFILE_FREQ_HOP);
     TRACE_EVAL_API("SetFreqHop(maxSendingTime: %d) = %d", freqHop->maxSendingTime, retCode);
     return retCode;
 }
@@ -287,6 +473,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetFreqLBT(STUHFL_T_ST25RU3993_Freq_L
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_FREQ_LBT, (STUHFL_T_PARAM_VALUE)freqLBT);
+    forgetProfileMembers(STUHFL_D_PROFILE_FREQ_LBT);
     TRACE_EVAL_API("SetFreqLBT(listeningTime: %d, idleTime: %d, rssiLogThreshold: %d, skipLBTcheck: %d) = %d", freqLBT->listeningTime, freqLBT->idleTime, freqLBT->rssiLogThreshold, freqLBT->skipLBTcheck, retCode);
     return retCode;
 }
@@ -419,6 +606,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetGen2ProtocolCfg(STUHFL_T_ST25RU399
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_GEN2PROTOCOL_CFG, (STUHFL_T_PARAM_VALUE)gen2ProtocolCfg);
+    forgetProfileMembers(STUHFL_D_PROFILE_GEN2PROTOCOL_CFG);
     TRACE_EVAL_API("SetGen2ProtocolCfg(tari: %d, blf: %d, coding: %d, trext: %d) = %d",
                    gen2ProtocolCfg->tari, gen2ProtocolCfg->blf, gen2ProtocolCfg->coding, gen2ProtocolCfg->trext, retCode);
     return retCode;
@@ -435,6 +623,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetTxRxCfg(STUHFL_T_ST25RU3993_TxRx_C
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_TXRX_CFG, (STUHFL_T_PARAM_VALUE)txRxCfg);
+    forgetProfileMembers(STUHFL_D_PROFILE_TXRX_CFG);
     TRACE_EVAL_API("SetTxRxCfg(txOutputLevel: %d, rxSensitivity: %d, usedAntenna: %d, alternateAntennaInterval: %d) = %d", txRxCfg->txOutputLevel, txRxCfg->rxSensitivity, txRxCfg->usedAntenna, txRxCfg->alternateAntennaInterval, retCode);
     return retCode;
 }
@@ -449,6 +638,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetGen2InventoryCfg(STUHFL_T_ST25RU39
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_GEN2INVENTORY_CFG, (STUHFL_T_PARAM_VALUE)invGen2Cfg);
+    forgetProfileMembers(STUHFL_D_PROFILE_GEN2INVENTORY_CFG);
     TRACE_EVAL_API("SetGen2InventoryCfg(fastInv: %d, autoAck: %d, readTID: %d, startQ: %d, adaptiveQEnable: %d, minQ: %d, maxQ: %d, adjustOptions: %d, C1: (%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d), C2: (%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d), autoTuningInterval: %d, autoTuningLevel: %d, autoTuningAlgo: %d, autoTuningFalsePositiveDetection: %d, sel: %d, session: %d, target: %d, toggleTarget: %d, targetDepletionMode: %d, adaptiveSensitivityEnable: %d, adaptiveSensitivityInterval: %d) = %d",
                    invGen2Cfg->fastInv, invGen2Cfg->autoAck, invGen2Cfg->readTID,
                    invGen2Cfg->startQ, invGen2Cfg->adaptiveQEnable, invGen2Cfg->minQ, invGen2Cfg->maxQ, invGen2Cfg->adjustOptions,
@@ -594,12 +784,82 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV GetGb29768InventoryCfg(STUHFL_T_ST25R
 }
 
 
+// ---- Profile ----
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV ApplyProfile(STUHFL_T_Reader_Profile *profile, uint8_t *frames)
+{
+    STUHFL_T_API_Ctx *api = &STUHFL_F_CurReaderCtx()->api;
+    STUHFL_T_PARAM params[PROFILE_MEMBER_CNT];
+    uint8_t values[sizeof(STUHFL_T_Reader_Profile)];
+    STUHFL_T_PARAM_CNT paramCnt = 0;
+    uint16_t valuesLen = 0;
+    uint16_t payloadLen = 0;
+    uint16_t members = 0;
+    uint16_t changed = 0;
+    uint8_t frameCnt = 0;
+    STUHFL_T_RET_CODE retCode = ERR_NONE;
+
+    TRACE_EVAL_API_START();
+    if (profile == NULL) {
+        TRACE_EVAL_API("ApplyProfile(profile: NULL) = %d", ERR_PARAM);
+        return ERR_PARAM;
+    }
+    if (api->appliedProfile == NULL) {
+        api->appliedProfile = (STUHFL_T_Reader_Profile *)calloc(1, sizeof(STUHFL_T_Reader_Profile));
+        if (api->appliedProfile == NULL) {
+            TRACE_EVAL_API("ApplyProfile(use: 0x%04x) = %d", profile->use, ERR_NOMEM);
+            return ERR_NOMEM;
+        }
+    }
+    for (uint32_t i = 0; (i < PROFILE_MEMBER_CNT) && (retCode == ERR_NONE); i++) {
+        const STUHFL_T_Profile_Member *m = &profileMembers[i];
+        uint8_t *value = (uint8_t *)profile + m->offset;
+
+        // skip members not part of this profile or already applied with same value
+        if (((profile->use & m->use) == 0)
+                || (((api->appliedProfile->use & m->use) != 0) && (memcmp((uint8_t *)api->appliedProfile + m->offset, value, m->size) == 0))) {
+            continue;
+        }
+
+        // flush current frame when the board could not receive this TLV anymore
+        uint16_t tlvLen = (uint16_t)(1U + ((m->size > 0x7F) ? 2U : 1U) + m->size);
+        if ((payloadLen + tlvLen) > PROFILE_FRAME_PAYLOAD_MAX) {
+            retCode = applyProfileFrame(profile, members, paramCnt, params, values);
+            frameCnt++;
+            paramCnt = 0;
+            valuesLen = 0;
+            payloadLen = 0;
+            members = 0;
+        }
+        params[paramCnt++] = m->param;
+        memcpy(&values[valuesLen], value, m->size);
+        valuesLen = (uint16_t)(valuesLen + m->size);
+        payloadLen = (uint16_t)(payloadLen + tlvLen);
+        members |= m->use;
+        changed |= m->use;
+    }
+    if ((retCode == ERR_NONE) && (paramCnt > 0)) {
+        retCode = applyProfileFrame(profile, members, paramCnt, params, values);
+        frameCnt++;
+    }
+
+    if (frames) {
+        *frames = frameCnt;
+    }
+    TRACE_EVAL_API("ApplyProfile(use: 0x%04x, changed: 0x%04x, frames: %d) = %d", profile->use, changed, frameCnt, retCode);
+    return retCode;
+}
+STUHFL_DLL_API void CALL_CONV ForgetProfile()
+{
+    forgetProfileMembers(STUHFL_D_PROFILE_ALL);
+}
 
 // ---- Setter Tuning ----
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetTuning(STUHFL_T_ST25RU3993_Tuning *tuning)
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_TUNING, (STUHFL_T_PARAM_VALUE)tuning);
+    // the remembered channel list holds the caps of each channel
+    forgetProfileMembers(STUHFL_D_PROFILE_CHANNEL_LIST);
     TRACE_EVAL_API("SetTuning(antenna: %d, cin: %d, clen: %d, cout: %d) = %d", tuning->antenna, tuning->cin, tuning->clen, tuning->cout, retCode);
     return retCode;
 }
@@ -609,6 +869,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetTuningTableEntry(STUHFL_T_ST25RU39
     char tb[5][TB_SIZE];
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_TUNING_TABLE_ENTRY, (STUHFL_T_PARAM_VALUE)tuningTableEntry);
+    forgetProfileMembers(STUHFL_D_PROFILE_CHANNEL_LIST);
     TRACE_EVAL_API("SetTuningTableEntry(entry: %d, freq: %d, applyCapValues: 0x%s, cin: 0x%s, clen: 0x%s, cout: 0x%s, IQ: 0x%s) = %d",
                    tuningTableEntry->entry, tuningTableEntry->freq, byteArray2HexString(tb[0], TB_SIZE, tuningTableEntry->applyCapValues, MAX_ANTENNA), byteArray2HexString(tb[1], TB_SIZE, tuningTableEntry->cin, MAX_ANTENNA), byteArray2HexString(tb[2], TB_SIZE, tuningTableEntry->clen, MAX_ANTENNA), byteArray2HexString(tb[3], TB_SIZE, tuningTableEntry->cout, MAX_ANTENNA), byteArray2HexString(tb[4], TB_SIZE, (uint8_t *)tuningTableEntry->IQ, MAX_ANTENNA * sizeof(uint16_t)), retCode);
 #undef TB_SIZE
@@ -618,6 +879,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetTuningTableDefault(STUHFL_T_ST25RU
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_TUNING_TABLE_DEFAULT, (STUHFL_T_PARAM_VALUE)set);
+    forgetProfileMembers(STUHFL_D_PROFILE_CHANNEL_LIST);
     TRACE_EVAL_API("SetTuningTableDefault(profile: %d, freq: %d) = %d", set->profile, set->freq, retCode);
     return retCode;
 }
@@ -632,6 +894,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetTuningTableEmpty(void)
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_TUNING_TABLE_EMPTY, (STUHFL_T_PARAM_VALUE)NULL);
+    forgetProfileMembers(STUHFL_D_PROFILE_CHANNEL_LIST);
     TRACE_EVAL_API("SetTuningTableEmpty() = %d", retCode);
     return retCode;
 }
@@ -639,6 +902,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV SetTuningCaps(STUHFL_T_ST25RU3993_Tun
 {
     TRACE_EVAL_API_START();
     STUHFL_T_RET_CODE retCode = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_TUNING_CAPS, (STUHFL_T_PARAM_VALUE)tuning);
+    forgetProfileMembers(STUHFL_D_PROFILE_CHANNEL_LIST);
     TRACE_EVAL_API("SetTuningCaps(antenna: %d, channelListIdx: %d, cin: %d, clen: %d, cout: %d) = %d", tuning->antenna, tuning->channelListIdx, tuning->caps.cin, tuning->caps.clen, tuning->caps.cout, retCode);
     return retCode;
 }
@@ -731,6 +995,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV Tune(STUHFL_T_ST25RU3993_Tune *tune)
     if (ERR_NONE == STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&tmpRdTimeOut)) {
         // start tuning..
         retCode |= STUHFL_F_ExecuteCmd((STUHFL_CG_DL << 8) | STUHFL_CC_TUNE, (STUHFL_T_PARAM_VALUE)tune, (STUHFL_T_PARAM_VALUE)tune);
+        forgetProfileMembers(STUHFL_D_PROFILE_CHANNEL_LIST);
         // revert max timeout
         retCode |= STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&rdTimeOut);
     }
@@ -747,6 +1012,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV TuneChannel(STUHFL_T_ST25RU3993_TuneC
     if (ERR_NONE == STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&tmpRdTimeOut)) {
         // start tuning..
         retCode |= STUHFL_F_ExecuteCmd((STUHFL_CG_DL << 8) | STUHFL_CC_TUNE_CHANNEL, (STUHFL_T_PARAM_VALUE)tuneCfg, (STUHFL_T_PARAM_VALUE)tuneCfg);
+        forgetProfileMembers(STUHFL_D_PROFILE_CHANNEL_LIST);
         // revert max timeout
         retCode |= STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&rdTimeOut);
     }
@@ -920,24 +1186,24 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV Gb29768_Erase(STUHFL_T_Gb29768_Erase
 
 
 // ---- Inventory Runner ----
-STUHFL_T_ACTION_ID invRunnerId = 0;
+// runner id and caller finish callback are kept per reader in STUHFL_T_API_Ctx
 typedef STUHFL_T_RET_CODE(*STUHFL_T_InventoryFinished)(STUHFL_T_Inventory_Data *data); // Finished Callback definition
 STUHFL_T_RET_CODE _finishedCallback(STUHFL_T_Inventory_Data *data);
-STUHFL_T_InventoryFinished callerFinishedCallback = NULL;
 
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV InventoryRunnerStart(STUHFL_T_Inventory_Option *option, STUHFL_T_InventoryCycle cycleCallback, STUHFL_T_InventoryFinished finishedCallback, STUHFL_T_Inventory_Data *data)
 {
+    STUHFL_T_API_Ctx *api = &STUHFL_F_CurReaderCtx()->api;
     // allow only one instance
-    if (invRunnerId) {
+    if (api->invRunnerId) {
         return ERR_BUSY;
     }
 
     // remember the finish callback
-    callerFinishedCallback = finishedCallback;
+    api->callerFinishedCallback = (STUHFL_T_ActionFinished)finishedCallback;
 
     // start the runner
     TRACE_EVAL_API_START();
-    STUHFL_T_RET_CODE retCode = STUHFL_F_Start(STUHFL_ACTION_INVENTORY, option, (STUHFL_T_ActionCycle)cycleCallback, data, (STUHFL_T_ActionFinished)_finishedCallback, &invRunnerId);
+    STUHFL_T_RET_CODE retCode = STUHFL_F_Start(STUHFL_ACTION_INVENTORY, option, (STUHFL_T_ActionCycle)cycleCallback, data, (STUHFL_T_ActionFinished)_finishedCallback, &api->invRunnerId);
 
     TRACE_EVAL_API("InventoryRunnerStart(rssiMode: %d, roundCnt: %d, inventoryDelay: %d, reportOptions: %d, tagListSizeMax: %d, tagListSize: %d) = %d",
                    option->rssiMode, option->roundCnt, option->inventoryDelay, option->reportOptions,
@@ -947,11 +1213,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV InventoryRunnerStart(STUHFL_T_Invento
     //
     if (retCode == ERR_NONE) {
         // block execution until thread has finished
-#if defined(WIN32) || defined(WIN64)
-        WaitForSingleObject((HANDLE)invRunnerId, INFINITE);
-#elif defined(POSIX)
-        pthread_join((pthread_t)invRunnerId, NULL);
-#endif
+        STUHFL_F_WaitRunnerDone(STUHFL_F_CurReaderCtx(), UINT32_MAX);
     }
     return retCode;
 }
@@ -959,17 +1221,18 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV InventoryRunnerStart(STUHFL_T_Invento
 #ifdef USE_INVENTORY_EXT
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV InventoryRunnerStartExt(STUHFL_T_Inventory_Option *option, STUHFL_T_InventoryCycle cycleCallback, STUHFL_T_InventoryFinished finishedCallback, STUHFL_T_Inventory_Data_Ext *data)
 {
+    STUHFL_T_API_Ctx *api = &STUHFL_F_CurReaderCtx()->api;
     // allow only one instance
-    if (invRunnerId) {
+    if (api->invRunnerId) {
         return ERR_BUSY;
     }
 
     // remember the finish callback
-    callerFinishedCallback = finishedCallback;
+    api->callerFinishedCallback = (STUHFL_T_ActionFinished)finishedCallback;
 
     // start the runner
     TRACE_EVAL_API_START();
-    STUHFL_T_RET_CODE retCode = STUHFL_F_Start(STUHFL_ACTION_INVENTORY_W_SLOT_STATISTICS, option, (STUHFL_T_ActionCycle)cycleCallback, data, (STUHFL_T_ActionFinished)_finishedCallback, &invRunnerId);
+    STUHFL_T_RET_CODE retCode = STUHFL_F_Start(STUHFL_ACTION_INVENTORY_W_SLOT_STATISTICS, option, (STUHFL_T_ActionCycle)cycleCallback, data, (STUHFL_T_ActionFinished)_finishedCallback, &api->invRunnerId);
 
     TRACE_EVAL_API("InventoryRunnerStartExt(rssiMode: %d, roundCnt: %d, inventoryDelay: %d, reportOptions: %d, tagListSizeMax: %d, tagListSize: %d, slotInfoList..) = %d",
                    option->rssiMode, option->roundCnt, option->inventoryDelay, option->reportOptions,
@@ -979,11 +1242,7 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV InventoryRunnerStartExt(STUHFL_T_Inve
     //
     if (retCode == ERR_NONE) {
         // block execution until thread has finished
-#if defined(WIN32) || defined(WIN64)
-        WaitForSingleObject((HANDLE)invRunnerId, INFINITE);
-#elif defined(POSIX)
-        pthread_join((pthread_t)invRunnerId, NULL);
-#endif
+        STUHFL_F_WaitRunnerDone(STUHFL_F_CurReaderCtx(), UINT32_MAX);
     }
     return retCode;
 }
@@ -991,22 +1250,190 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV InventoryRunnerStartExt(STUHFL_T_Inve
 
 STUHFL_T_RET_CODE _finishedCallback(STUHFL_T_Inventory_Data *data)
 {
+    STUHFL_T_API_Ctx *api = &STUHFL_F_CurReaderCtx()->api;
     // callback caller if callback is provided
-    if (callerFinishedCallback) {
-        callerFinishedCallback(data);
+    if (api->callerFinishedCallback) {
+        api->callerFinishedCallback(data);
     }
     // Reset ID to allow new runner to start
-    invRunnerId = 0;
+    api->invRunnerId = 0;
     return ERR_NONE;
 }
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV InventoryRunnerStop(void)
 {
+    STUHFL_T_API_Ctx *api = &STUHFL_F_CurReaderCtx()->api;
     TRACE_EVAL_API_START();
-    STUHFL_T_RET_CODE retCode = STUHFL_F_Stop(invRunnerId);
+    STUHFL_T_RET_CODE retCode = STUHFL_F_Stop(api->invRunnerId);
     TRACE_EVAL_API("InventoryRunnerStop() = %d", retCode);
     return retCode;
 }
 
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE probeBaudrate(STUHFL_T_BaudProbe *probe)
+{
+    STUHFL_T_Version swVersion;
+    STUHFL_T_Version hwVersion;
+    uint32_t rdTimeout = 0;
+    uint32_t probeTimeout = PROBE_RD_TIMEOUT_MS;
+    STUHFL_T_RET_CODE retCode;
+
+    probe->errors = 0;
+    probe->avgRttUs = 0;
+
+    // wait for the board to come up after the reset done on connect, not counted as error
+    retCode = WaitForBoard(PROBE_BOOT_TIMEOUT_MS, NULL);
+    if (retCode != ERR_NONE) {
+        return retCode;
+    }
+
+    STUHFL_F_GetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, &rdTimeout);
+    STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, &probeTimeout);
+
+    // measure, a failed exchange costs one read timeout and a resynchronization and is not part of the round trip time
+    uint64_t rttSum = 0;
+    uint8_t rttCnt = 0;
+    for (uint8_t i = 0; i < probe->exchanges; i++) {
+        uint32_t startTime = getMicroCount();
+        if (GetBoardVersion(&swVersion, &hwVersion) == ERR_NONE) {
+            rttSum += getMicroSpan(startTime);
+            rttCnt++;
+        } else {
+            probe->errors++;
+            STUHFL_F_Reset(STUHFL_RESET_TYPE_CLEAR_COMM);
+        }
+    }
+    probe->avgRttUs = rttCnt ? (uint32_t)(rttSum / rttCnt) : 0;
+    retCode = probe->errors ? ERR_IO : ERR_NONE;
+
+    STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, &rdTimeout);
+    return retCode;
+}
+
+// --------------------------------------------------------------------------
+static bool probeCacheLookup(const char *cacheFile, const char *port, uint32_t *br)
+{
+    char line[PROBE_CACHE_LINE_LEN];
+    bool found = false;
+
+    if (cacheFile == NULL) {
+        return false;
+    }
+    FILE *f = fopen(cacheFile, "r");
+    if (f == NULL) {
+        return false;
+    }
+    // one "<baudrate> <port>" entry per line
+    while (!found && (fgets(line, sizeof(line), f) != NULL)) {
+        char *sep = strchr(line, ' ');
+        if (sep == NULL) {
+            continue;
+        }
+        line[strcspn(line, "\r\n")] = 0;
+        if (strcmp(sep + 1, port) == 0) {
+            *br = (uint32_t)strtoul(line, NULL, 10);
+            found = (*br != 0);
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+// --------------------------------------------------------------------------
+static void probeCacheStore(const char *cacheFile, const char *port, uint32_t br)
+{
+    char (*lines)[PROBE_CACHE_LINE_LEN];
+    char *tmpFile;
+    int lineCnt = 0;
+    bool written;
+
+    if ((cacheFile == NULL) || ((strlen(port) + 12) >= PROBE_CACHE_LINE_LEN)) {
+        return;
+    }
+    lines = malloc(PROBE_CACHE_MAX_LINES * PROBE_CACHE_LINE_LEN);
+    tmpFile = malloc(strlen(cacheFile) + sizeof(PROBE_CACHE_TMP_SUFFIX));
+    if ((lines == NULL) || (tmpFile == NULL)) {
+        free(lines);
+        free(tmpFile);
+        return;
+    }
+    // keep the entries of all other ports
+    FILE *f = fopen(cacheFile, "r");
+    if (f != NULL) {
+        while ((lineCnt < (PROBE_CACHE_MAX_LINES - 1)) && (fgets(lines[lineCnt], PROBE_CACHE_LINE_LEN, f) != NULL)) {
+            char *sep = strchr(lines[lineCnt], ' ');
+            lines[lineCnt][strcspn(lines[lineCnt], "\r\n")] = 0;
+            if ((sep != NULL) && (strcmp(sep + 1, port) != 0)) {
+                lineCnt++;
+            }
+        }
+        fclose(f);
+    }
+    snprintf(lines[lineCnt++], PROBE_CACHE_LINE_LEN, "%u %s", br, port);
+
+    // written aside and renamed, so that readers never see a partial cache
+    strcpy(tmpFile, cacheFile);
+    strcat(tmpFile, PROBE_CACHE_TMP_SUFFIX);
+    f = fopen(tmpFile, "w");
+    written = (f != NULL);
+    for (int i = 0; written && (i < lineCnt); i++) {
+        written = (fprintf(f, "%s\n", lines[i]) >= 0);
+    }
+    if (f != NULL) {
+        written = (fclose(f) == 0) && written;
+    }
+#if defined(WIN32) || defined(WIN64)
+    written = written && MoveFileExA(tmpFile, cacheFile, MOVEFILE_REPLACE_EXISTING);
+#else
+    written = written && (rename(tmpFile, cacheFile) == 0);
+#endif
+    if (!written) {
+        remove(tmpFile);
+    }
+    free(tmpFile);
+    free(lines);
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE applyProfileFrame(STUHFL_T_Reader_Profile *profile, uint16_t members, STUHFL_T_PARAM_CNT paramCnt, STUHFL_T_PARAM *params, uint8_t *values)
+{
+    STUHFL_T_API_Ctx *api = &STUHFL_F_CurReaderCtx()->api;
+    uint32_t rdTimeOut = 0;
+    STUHFL_T_RET_CODE retCode;
+
+    // depending on its timeout antenna power might take longer as the communication timeout, see SetAntennaPower()
+    if (members & STUHFL_D_PROFILE_ANTENNA_POWER) {
+        uint32_t tmpRdTimeOut = profile->antennaPower.timeout + 4000U;
+        STUHFL_F_GetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&rdTimeOut);
+        STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&tmpRdTimeOut);
+    }
+    retCode = STUHFL_F_SetMultipleParams(paramCnt, params, (STUHFL_T_PARAM_VALUE *)values);
+    if (members & STUHFL_D_PROFILE_ANTENNA_POWER) {
+        STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&rdTimeOut);
+    }
+
+    // remember what the board took over, members of a failed frame are in unknown state
+    if (retCode == ERR_NONE) {
+        for (uint32_t i = 0; i < PROFILE_MEMBER_CNT; i++) {
+            if (members & profileMembers[i].use) {
+                memcpy((uint8_t *)api->appliedProfile + profileMembers[i].offset, (uint8_t *)profile + profileMembers[i].offset, profileMembers[i].size);
+            }
+        }
+        api->appliedProfile->use |= members;
+    } else {
+        forgetProfileMembers(members);
+    }
+    return retCode;
+}
+
+// --------------------------------------------------------------------------
+static void forgetProfileMembers(uint16_t use)
+{
+    STUHFL_T_API_Ctx *api = &STUHFL_F_CurReaderCtx()->api;
+    if (api->appliedProfile != NULL) {
+        api->appliedProfile->use = (uint16_t)(api->appliedProfile->use & ~use);
+    }
+}
+
 /**
   * @}
   */
@@ -78,8 +78,7 @@ uint16_t getTlvExt(uint8_t *data, uint8_t *tag, uint16_t *len, void *value)
     uint16_t i = 0;
     *tag = data[i++];
     if (data[i] & 0x80) {
-        data[i] &= 0x7F;
-        *len = (uint16_t)(data[i++] << 8);
+        *len = (uint16_t)((data[i++] & 0x7F) << 8);
         *len = (uint16_t)(*len | (uint16_t)data[i++]);
     } else {
         *len = data[i++];
@@ -100,14 +99,61 @@ uint16_t getTlvLen(uint8_t *data)
     uint16_t i = 1;
     uint16_t len = 0;
     if (data[i] & 0x80) {
-        data[i] &= 0x7F;
-        len = (uint16_t)(data[i++] << 8);
+        len = (uint16_t)((data[i++] & 0x7F) << 8);
         len = (uint16_t)(len | (uint16_t)data[i++]);
     } else {
         len = data[i++];
     }
     return len;
 }
+void tlvIterInit(STUHFL_T_TlvIter *it, const uint8_t *data, uint16_t len)
+{
+    it->data = data;
+    it->len = len;
+    it->pos = 0;
+    it->overrun = false;
+}
+bool tlvIterNext(STUHFL_T_TlvIter *it, STUHFL_T_Tlv *tlv)
+{
+    uint16_t avail = (uint16_t)(it->len - it->pos);
+    const uint8_t *data = &it->data[it->pos];
+    uint16_t i = 0;
+
+    if (it->overrun || (avail == 0)) {
+        return false;
+    }
+    if (avail < 2U) {
+        it->overrun = true;
+        return false;
+    }
+    tlv->tag = data[i++];
+    if (data[i] & 0x80) {
+        if (avail < 3U) {
+            it->overrun = true;
+            return false;
+        }
+        tlv->len = (uint16_t)((data[i] & 0x7F) << 8);
+        tlv->len = (uint16_t)(tlv->len | (uint16_t)data[i + 1U]);
+        i = (uint16_t)(i + 2U);
+    } else {
+        tlv->len = data[i++];
+    }
+    if (tlv->len > (uint16_t)(avail - i)) {
+        it->overrun = true;
+        return false;
+    }
+    tlv->value = &data[i];
+    it->pos = (uint16_t)(it->pos + i + tlv->len);
+    return true;
+}
+uint16_t tlvCopy(const STUHFL_T_Tlv *tlv, void *value, uint16_t size)
+{
+    uint16_t len = (tlv->len < size) ? tlv->len : size;
+    if (value != NULL) {
+        memcpy(value, tlv->value, len);
+    }
+    return len;
+}
 uint16_t addTlv8(uint8_t *data, uint8_t tag, uint8_t value)
 {
     uint16_t i = 0;
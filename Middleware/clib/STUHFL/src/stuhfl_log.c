@@ -42,9 +42,18 @@ static STUHFL_T_CallerCtx gCallerCtxPointer = NULL;
 static STUHFL_T_Log gLogCallBack = NULL;
 static STUHFL_T_LogOOP gLogCallBackOOP = NULL;
 static STUHFL_T_Log_Option gLogOptions = { 0 };
-static STUHFL_T_Log_Data gLogData[LOG_LEVEL_COUNT] = { 0 };
 static uint32_t gLogId = 0;
 
+// every thread builds its log lines on its own, on flush a line is handed to the callback in a copy owned by the flushing thread
+#define LOG_LINE_SIZE   1024
+typedef struct {
+    uint32_t                            logTickCountMs;
+    uint16_t                            logLineSize;
+    char                                logLine[LOG_LINE_SIZE];
+} STUHFL_T_Log_Line;
+static STUHFL_THREAD_LOCAL STUHFL_T_Log_Line gLogLine[LOG_LEVEL_COUNT];
+static STUHFL_T_Mutex gLogLock = STUHFL_D_MUTEX_INIT;
+
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_EnableLog(STUHFL_T_Log_Option option, STUHFL_T_Log logCallback)
 {
     gLogCallBack = logCallback;
@@ -54,11 +63,6 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_EnableLog(STUHFL_T_Log_Optio
 STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_EnableLog_OOP(STUHFL_T_Log_Option option, STUHFL_T_CallerCtx callerCtx, STUHFL_T_LogOOP logCallback)
 {
     memcpy(&gLogOptions, &option, sizeof(STUHFL_T_Log_Option));
-    // assign buffers
-    for (int i = 0; i < LOG_LEVEL_COUNT; i++) {
-        gLogData[i].logBuf = option.logBuf[i];
-        gLogData[i].logBufSize = 0;
-    }
     gCallerCtxPointer = callerCtx;
     gLogCallBackOOP = logCallback;
     return ERR_NONE;
@@ -118,8 +122,8 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_LogClear(uint32_t level)
     if ((gLogCallBack == NULL) && (gLogCallBackOOP == NULL)) {
         return ERR_PARAM;
     }
-    gLogData[STUHFL_F_LogLevel2Idx(level)].logTickCountMs[0] = getMilliCount();
-    gLogData[STUHFL_F_LogLevel2Idx(level)].logBufSize = 0;
+    gLogLine[STUHFL_F_LogLevel2Idx(level)].logTickCountMs = getMilliCount();
+    gLogLine[STUHFL_F_LogLevel2Idx(level)].logLineSize = 0;
     return ERR_NONE;
 }
 
@@ -137,14 +141,12 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_LogAppend(uint32_t level, co
     va_list args;
     va_start(args, format);
     uint8_t idx = STUHFL_F_LogLevel2Idx(level);
-    if ((gLogOptions.logBufSize[idx] - gLogData[idx].logBufSize) > 0) {
-        int writtenLen = vsnprintf(&gLogData[idx].logBuf[gLogData[idx].logBufSize], (uint32_t)(gLogOptions.logBufSize[idx] - gLogData[idx].logBufSize), format, args);
-        if ((writtenLen > 0) && (writtenLen < (gLogOptions.logBufSize[idx] - gLogData[idx].logBufSize))) {
-            gLogData[idx].logBufSize = (uint16_t)(gLogData[idx].logBufSize + (uint16_t)writtenLen);
-            if (gLogData[idx].logBufSize > gLogOptions.logBufSize[idx]) {
-                gLogData[idx].logBufSize = gLogOptions.logBufSize[idx];
-                gLogData[idx].logBuf[gLogData[idx].logBufSize - 1] = 0;
-            }
+    STUHFL_T_Log_Line *line = &gLogLine[idx];
+    int lineSizeMax = min(gLogOptions.logBufSize[idx], LOG_LINE_SIZE);
+    if ((lineSizeMax - line->logLineSize) > 0) {
+        int writtenLen = vsnprintf(&line->logLine[line->logLineSize], (uint32_t)(lineSizeMax - line->logLineSize), format, args);
+        if ((writtenLen > 0) && (writtenLen < (lineSizeMax - line->logLineSize))) {
+            line->logLineSize = (uint16_t)(line->logLineSize + (uint16_t)writtenLen);
             ret = ERR_NONE;
         }
     }
@@ -162,24 +164,43 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_LogFlush(uint32_t level)
     STUHFL_F_LogAppend(level, "\n");
 
     uint8_t idx = STUHFL_F_LogLevel2Idx(level);
+    STUHFL_T_Log_Line *line = &gLogLine[idx];
 
     // logLevel supported ?
-    if ((gLogOptions.logLevels & level) == level) {
-        gLogData[idx].logLevel = level;
-    } else {
+    if ((gLogOptions.logLevels & level) != level) {
+        line->logLineSize = 0;
         return ret;
     }
 
+    // hand over a copy, the callback may log itself and so reuse the line
+    char logBuf[LOG_LINE_SIZE];
+    STUHFL_T_Log_Data logData = STUHFL_O_LOG_DATA_INIT();
+    logData.logLevel = level;
+    logData.logBuf = logBuf;
+    logData.logBufSize = line->logLineSize;
+    memcpy(logBuf, line->logLine, line->logLineSize);
+    if (line->logLineSize < LOG_LINE_SIZE) {
+        logBuf[line->logLineSize] = 0;
+    }
+    logData.logTickCountMs[0] = line->logTickCountMs;
+    line->logLineSize = 0;
+
     // increase idx and set timestamp
-    gLogId++;
-    gLogData[idx].logIdx = gLogId;
+    STUHFL_MUTEX_LOCK(&gLogLock);
+    logData.logIdx = ++gLogId;
+    STUHFL_MUTEX_UNLOCK(&gLogLock);
     if (gLogOptions.generateLogTimestamp) {
-        gLogData[idx].logTickCountMs[1] = getMilliCount();
+        logData.logTickCountMs[1] = getMilliCount();
     }
 
-    // call callBack
-    ret = gLogCallBack != NULL ? gLogCallBack(&gLogData[idx]) : gLogCallBackOOP(gCallerCtxPointer, &gLogData[idx]);
-    gLogData[idx].logBufSize = 0;
+    // call callBack, unlocked so that lines of different threads are not serialized by a slow callback
+    STUHFL_T_Log logCallBack = gLogCallBack;
+    STUHFL_T_LogOOP logCallBackOOP = gLogCallBackOOP;
+    if (logCallBack != NULL) {
+        ret = logCallBack(&logData);
+    } else if (logCallBackOOP != NULL) {
+        ret = logCallBackOOP(gCallerCtxPointer, &logData);
+    }
     return ret;
 }
 
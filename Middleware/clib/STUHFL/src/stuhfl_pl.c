@@ -38,6 +38,7 @@
 #include "stuhfl.h"
 #include "stuhfl_dl.h"
 #include "stuhfl_pl.h"
+#include "stuhfl_ctx.h"
 #include "stuhfl_err.h"
 #include "stuhfl_platform.h"
 #include "stuhfl_helpers.h"
@@ -47,49 +48,93 @@
 #include "stuhfl_bl_win32.h"
 #elif defined(POSIX)
 #include "stuhfl_bl_posix.h"
+#include "stuhfl_bl_socket.h"
 #endif
 
-uint16_t sndID = 0;
-uint16_t rcvID = 0;
-
-static uint8_t *snd = NULL;
-static uint16_t gSndMaxLen = 0;
-static uint8_t *rcv = NULL;
-static uint16_t gRcvMaxLen = 0;
-
 #define DIRECTION_FROM_BOARD                    0x0000
 #define DIRECTION_TO_BOARD                      0x8000
 #define SIGNATURE_NONE                          0x00
 #define SIGNATURE_XOR_BCC                       0x01
 
-uint16_t mode = DIRECTION_TO_BOARD | SIGNATURE_NONE;
+// Host side receive ring (see STUHFL_T_PL_Ctx). Filled with all data the port has available and
+// parsed frame by frame, so that a burst of frames costs a single read
+#define RX_RING_MASK                            (RX_RING_SIZE - 1U)
+#define RX_RING_LEN(pl)                         ((uint32_t)((pl)->rxRingWr - (pl)->rxRingRd))
+
+// built-in transports, the serial port is used for all port names without known prefix
+#if defined(WIN32) || defined(WIN64)
+static const STUHFL_T_Transport serialTransport = {
+    .prefix = "",
+    .connect = STUHFL_F_Connect_Win32,
+    .reset = STUHFL_F_Reset_Win32,
+    .disconnect = STUHFL_F_Disconnect_Win32,
+    .sndRaw = STUHFL_F_SndRaw_Win32,
+    .rcvRaw = STUHFL_F_RcvRaw_Win32,
+    .setDTR = STUHFL_F_SetDTR_Win32,
+    .getDTR = STUHFL_F_GetDTR_Win32,
+    .setRTS = STUHFL_F_SetRTS_Win32,
+    .getRTS = STUHFL_F_GetRTS_Win32,
+    .setTimeouts = STUHFL_F_SetTimeouts_Win32,
+    .getTimeouts = STUHFL_F_GetTimeouts_Win32,
+};
+static const STUHFL_T_Transport *builtinTransports[] = { NULL };
+#elif defined(POSIX)
+static const STUHFL_T_Transport serialTransport = {
+    .prefix = "",
+    .connect = STUHFL_F_Connect_Posix,
+    .reset = STUHFL_F_Reset_Posix,
+    .disconnect = STUHFL_F_Disconnect_Posix,
+    .sndRaw = STUHFL_F_SndRaw_Posix,
+    .sndRawV = STUHFL_F_SndRawV_Posix,
+    .rcvRaw = STUHFL_F_RcvRaw_Posix,
+    .rcvRawAvailable = STUHFL_F_RcvRawAvailable_Posix,
+    .setDTR = STUHFL_F_SetDTR_Posix,
+    .getDTR = STUHFL_F_GetDTR_Posix,
+    .setRTS = STUHFL_F_SetRTS_Posix,
+    .getRTS = STUHFL_F_GetRTS_Posix,
+    .setTimeouts = STUHFL_F_SetTimeouts_Posix,
+    .getTimeouts = STUHFL_F_GetTimeouts_Posix,
+    .setTxQueue = STUHFL_F_SetTxQueue_Posix,
+    .getTxQueue = STUHFL_F_GetTxQueue_Posix,
+};
+#define SOCKET_TRANSPORT(p, c)  {                           \
+    .prefix = (p),                                          \
+    .connect = (c),                                         \
+    .reset = STUHFL_F_Reset_Socket,                         \
+    .disconnect = STUHFL_F_Disconnect_Socket,               \
+    .sndRaw = STUHFL_F_SndRaw_Socket,                       \
+    .sndRawV = STUHFL_F_SndRawV_Socket,                     \
+    .rcvRaw = STUHFL_F_RcvRaw_Socket,                       \
+    .rcvRawAvailable = STUHFL_F_RcvRawAvailable_Socket,     \
+    .setDTR = STUHFL_F_SetDTR_Socket,                       \
+    .getDTR = STUHFL_F_GetDTR_Socket,                       \
+    .setRTS = STUHFL_F_SetRTS_Socket,                       \
+    .getRTS = STUHFL_F_GetRTS_Socket,                       \
+    .setTimeouts = STUHFL_F_SetTimeouts_Socket,             \
+    .getTimeouts = STUHFL_F_GetTimeouts_Socket,             \
+}
+static const STUHFL_T_Transport tcpTransport = SOCKET_TRANSPORT("tcp://", STUHFL_F_Connect_Tcp);
+static const STUHFL_T_Transport unixTransport = SOCKET_TRANSPORT("unix://", STUHFL_F_Connect_Unix);
+static const STUHFL_T_Transport *builtinTransports[] = { &tcpTransport, &unixTransport, NULL };
+#else
+static const STUHFL_T_Transport serialTransport = { .prefix = "" };
+static const STUHFL_T_Transport *builtinTransports[] = { NULL };
+#endif
+
+// registered transports, process wide
+static STUHFL_T_Transport transports[STUHFL_D_MAX_TRANSPORTS];
+
+static const STUHFL_T_Transport *findTransport(const char *port);
+static bool isValidRcvHeader(const uint8_t *header);
+
+static STUHFL_T_RET_CODE rxRingFill(STUHFL_T_DEVICE_CTX device, uint32_t startTime, uint32_t timeout);
+static void rxRingPeek(uint8_t *data, uint32_t offset, uint32_t len);
+static STUHFL_T_RET_CODE rcvFrameExact(STUHFL_T_DEVICE_CTX device, uint16_t *expectedLen);
+static STUHFL_T_RET_CODE rcvFrameRing(STUHFL_T_DEVICE_CTX device, uint16_t *expectedLen);
 
 void encodeSndFrame(uint8_t *sndData, uint16_t *sndDataLen, uint16_t mode, uint16_t id, uint16_t status, uint16_t cmd, uint8_t *payloadData, uint16_t payloadDataLen);
-//
-typedef STUHFL_T_RET_CODE(*STUHFL_T_Reset)(STUHFL_T_DEVICE_CTX *device, STUHFL_T_RESET resetType);
-typedef STUHFL_T_RET_CODE(*STUHFL_T_Disconnect)(STUHFL_T_DEVICE_CTX *device);
-typedef STUHFL_T_RET_CODE(*STUHFL_T_SndRaw)(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t dataLen);
-typedef STUHFL_T_RET_CODE(*STUHFL_T_RcvRaw)(STUHFL_T_DEVICE_CTX *device, uint8_t *data, uint16_t *dataLen);
-typedef STUHFL_T_RET_CODE(*STUHFL_T_SetDTR)(STUHFL_T_DEVICE_CTX *device, uint8_t dtrValue);
-typedef STUHFL_T_RET_CODE(*STUHFL_T_GetDTR)(STUHFL_T_DEVICE_CTX *device, uint8_t *dtrValue);
-typedef STUHFL_T_RET_CODE(*STUHFL_T_SetRTS)(STUHFL_T_DEVICE_CTX *device, uint8_t rtsValue);
-typedef STUHFL_T_RET_CODE(*STUHFL_T_GetRTS)(STUHFL_T_DEVICE_CTX *device, uint8_t *rtsValue);
-typedef STUHFL_T_RET_CODE(*STUHFL_T_SetTimeouts)(STUHFL_T_DEVICE_CTX *device, uint32_t rdTimeout, uint32_t wrTimeout);
-typedef STUHFL_T_RET_CODE(*STUHFL_T_GetTimeouts)(STUHFL_T_DEVICE_CTX *device, uint32_t *rdTimeout, uint32_t *wrTimeout);
-
-
-
-static STUHFL_T_Reset STUHFL_F_PlatformReset = NULL;
-static STUHFL_T_Disconnect STUHFL_F_PlatformDisconnect = NULL;
-static STUHFL_T_SndRaw STUHFL_F_PlatformSndRaw = NULL;
-static STUHFL_T_RcvRaw STUHFL_F_PlatformRcvRaw = NULL;
-
-static STUHFL_T_SetDTR STUHFL_F_PlatformSetDTR = NULL;
-static STUHFL_T_GetDTR STUHFL_F_PlatformGetDTR = NULL;
-static STUHFL_T_SetRTS STUHFL_F_PlatformSetRTS = NULL;
-static STUHFL_T_GetRTS STUHFL_F_PlatformGetRTS = NULL;
-static STUHFL_T_SetTimeouts STUHFL_F_PlatformSetTimeouts = NULL;
-static STUHFL_T_GetTimeouts STUHFL_F_PlatformGetTimeouts = NULL;
+static uint16_t encodeSndHeader(uint8_t *header, uint16_t mode, uint16_t id, uint16_t status, uint16_t cmd, uint16_t payloadDataLen);
+static uint8_t calcBcc(const uint8_t *data, uint16_t dataLen);
 
 #define TRACE_PL_LOG_CLEAR()    { STUHFL_F_LogClear(LOG_LEVEL_TRACE_PL); }
 #define TRACE_PL_LOG_APPEND(...){ STUHFL_F_LogAppend(LOG_LEVEL_TRACE_PL, __VA_ARGS__); }
@@ -101,6 +146,7 @@ static STUHFL_T_GetTimeouts STUHFL_F_PlatformGetTimeouts = NULL;
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_Connect_Dispatcher(STUHFL_T_DEVICE_CTX *device, uint8_t *sndBuffer, uint16_t sndBufferLen, uint8_t *rcvBuffer, uint16_t rcvBufferLen)
 {
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
     STUHFL_T_RET_CODE ret = ERR_NONE;
 
 
@@ -112,118 +158,272 @@ STUHFL_T_RET_CODE STUHFL_F_Connect_Dispatcher(STUHFL_T_DEVICE_CTX *device, uint8
     if (ret != ERR_NONE) {
         return ret;
     }
-#if defined(WIN32) || defined(WIN64)
-    // Connect
-    ret = STUHFL_F_Connect_Win32(device, port, br);
-
-    // register operation handlers
-    STUHFL_F_PlatformReset = STUHFL_F_Reset_Win32;
-    STUHFL_F_PlatformDisconnect = STUHFL_F_Disconnect_Win32;
-
-    STUHFL_F_PlatformSndRaw = STUHFL_F_SndRaw_Win32;
-    STUHFL_F_PlatformRcvRaw = STUHFL_F_RcvRaw_Win32;
+    if (port == NULL) {
+        return ERR_PARAM;
+    }
 
-    STUHFL_F_PlatformSetDTR = STUHFL_F_SetDTR_Win32;
-    STUHFL_F_PlatformGetDTR = STUHFL_F_GetDTR_Win32;
-    STUHFL_F_PlatformSetRTS = STUHFL_F_SetRTS_Win32;
-    STUHFL_F_PlatformGetRTS = STUHFL_F_GetRTS_Win32;
-    STUHFL_F_PlatformSetTimeouts = STUHFL_F_SetTimeouts_Win32;
-    STUHFL_F_PlatformGetTimeouts = STUHFL_F_GetTimeouts_Win32;
+    const STUHFL_T_Transport *transport = findTransport(port);
+    if (transport->connect == NULL) {
+        return ERR_PARAM;
+    }
 
-#elif defined(POSIX)
     // Connect
-    ret = STUHFL_F_Connect_Posix(device, port, br);
+    ret = transport->connect(device, port + strlen(transport->prefix), br);
 
     // register operation handlers
-    STUHFL_F_PlatformReset = STUHFL_F_Reset_Posix;
-    STUHFL_F_PlatformDisconnect = STUHFL_F_Disconnect_Posix;
+    pl->platformReset = transport->reset;
+    pl->platformDisconnect = transport->disconnect;
+
+    pl->platformSndRaw = transport->sndRaw;
+    pl->platformSndRawV = transport->sndRawV;
+    pl->platformRcvRaw = transport->rcvRaw;
+    pl->platformRcvRawAvailable = transport->rcvRawAvailable;
+
+    pl->platformSetDTR = transport->setDTR;
+    pl->platformGetDTR = transport->getDTR;
+    pl->platformSetRTS = transport->setRTS;
+    pl->platformGetRTS = transport->getRTS;
+    pl->platformSetTimeouts = transport->setTimeouts;
+    pl->platformGetTimeouts = transport->getTimeouts;
+    pl->platformSetTxQueue = transport->setTxQueue;
+    pl->platformGetTxQueue = transport->getTxQueue;
+
+    pl->snd = sndBuffer;
+    pl->sndMaxLen = sndBufferLen;
+    pl->rcv = rcvBuffer;
+    pl->rcvMaxLen = rcvBufferLen;
+    if (pl->platformRcvRawAvailable && (pl->rcvMaxLen > RX_RING_SIZE)) {
+        // a frame has to fit into the receive ring
+        pl->rcvMaxLen = RX_RING_SIZE;
+    }
 
-    STUHFL_F_PlatformSndRaw = STUHFL_F_SndRaw_Posix;
-    STUHFL_F_PlatformRcvRaw = STUHFL_F_RcvRaw_Posix;
+    pl->sndID = 0;
+    pl->rcvID = 0;
+    pl->mode = DIRECTION_TO_BOARD | SIGNATURE_NONE;
+    pl->rxRingRd = pl->rxRingWr = 0;
+    pl->rxResyncCnt = 0;
+    pl->rxDroppedBytes = 0;
+    return ret;
+}
 
-    STUHFL_F_PlatformSetDTR = STUHFL_F_SetDTR_Posix;
-    STUHFL_F_PlatformGetDTR = STUHFL_F_GetDTR_Posix;
-    STUHFL_F_PlatformSetRTS = STUHFL_F_SetRTS_Posix;
-    STUHFL_F_PlatformGetRTS = STUHFL_F_GetRTS_Posix;
-    STUHFL_F_PlatformSetTimeouts = STUHFL_F_SetTimeouts_Posix;
-    STUHFL_F_PlatformGetTimeouts = STUHFL_F_GetTimeouts_Posix;
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_RegisterTransport(const STUHFL_T_Transport *transport)
+{
+    STUHFL_T_Transport *freeSlot = NULL;
 
-#else
-    return ERR_PARAM;
-#endif
+    if ((transport == NULL) || (transport->prefix == NULL) || (transport->prefix[0] == 0)) {
+        return ERR_PARAM;
+    }
+    if ((transport->connect != NULL)
+            && ((transport->reset == NULL) || (transport->disconnect == NULL) || (transport->sndRaw == NULL) || (transport->rcvRaw == NULL)
+                || (transport->setTimeouts == NULL) || (transport->getTimeouts == NULL))) {
+        return ERR_PARAM;
+    }
 
-    snd = sndBuffer;
-    gSndMaxLen = sndBufferLen;
-    rcv = rcvBuffer;
-    gRcvMaxLen = rcvBufferLen;
+    for (int i = 0; i < STUHFL_D_MAX_TRANSPORTS; i++) {
+        if (transports[i].connect == NULL) {
+            if (freeSlot == NULL) {
+                freeSlot = &transports[i];
+            }
+        } else if (strcmp(transports[i].prefix, transport->prefix) == 0) {
+            // replace or remove
+            transports[i] = *transport;
+            return ERR_NONE;
+        }
+    }
+    if (transport->connect == NULL) {
+        return ERR_PARAM;
+    }
+    if (freeSlot == NULL) {
+        return ERR_NOMEM;
+    }
+    *freeSlot = *transport;
+    return ERR_NONE;
+}
 
-    sndID = 0;
-    rcvID = 0;
-    mode = DIRECTION_TO_BOARD | SIGNATURE_NONE;
-    return ret;
+// --------------------------------------------------------------------------
+static const STUHFL_T_Transport *findTransport(const char *port)
+{
+    for (int i = 0; i < STUHFL_D_MAX_TRANSPORTS; i++) {
+        if ((transports[i].connect != NULL) && (strncmp(port, transports[i].prefix, strlen(transports[i].prefix)) == 0)) {
+            return &transports[i];
+        }
+    }
+    for (int i = 0; builtinTransports[i] != NULL; i++) {
+        if (strncmp(port, builtinTransports[i]->prefix, strlen(builtinTransports[i]->prefix)) == 0) {
+            return builtinTransports[i];
+        }
+    }
+    return &serialTransport;
 }
 
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_Reset_Dispatcher(STUHFL_T_DEVICE_CTX device, STUHFL_T_RESET resetType)
 {
-    return STUHFL_F_PlatformReset(device, resetType);
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    if (resetType == STUHFL_RESET_TYPE_CLEAR_COMM) {
+        pl->rxRingRd = pl->rxRingWr = 0;
+    }
+    return pl->platformReset(device, resetType);
 }
 
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_Disconnect_Dispatcher(STUHFL_T_DEVICE_CTX device)
 {
-    return STUHFL_F_PlatformDisconnect(device);
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    return pl->platformDisconnect(device);
 }
 
 // --------------------------------------------------------------------------
 uint8_t *STUHFL_F_Get_SndPayloadPtr()
 {
-    return &snd[COMM_PAYLOAD_POS];
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    return &pl->snd[COMM_PAYLOAD_POS];
+}
+
+// --------------------------------------------------------------------------
+uint16_t STUHFL_F_Get_SndID()
+{
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    // ID of the last frame sent, sndID was already incremented
+    return (uint16_t)(pl->sndID - 1U);
+}
+
+// --------------------------------------------------------------------------
+uint16_t STUHFL_F_Get_RcvID()
+{
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    return COMM_GET_PREAMBLE_ID(pl->rcv);
 }
 
 // --------------------------------------------------------------------------
 uint16_t STUHFL_F_Get_RcvCmd()
 {
-    return COMM_GET_CMD(rcv);
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    return COMM_GET_CMD(pl->rcv);
 }
 
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_Get_RcvStatus()
 {
-    return (STUHFL_T_RET_CODE)(int16_t)COMM_GET_STATUS(rcv);    // Keep status sign
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    return (STUHFL_T_RET_CODE)(int16_t)COMM_GET_STATUS(pl->rcv);    // Keep status sign
 }
 
 // --------------------------------------------------------------------------
 uint8_t *STUHFL_F_Get_RcvPayloadPtr()
 {
-    return &rcv[COMM_PAYLOAD_POS];
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    return &pl->rcv[COMM_PAYLOAD_POS];
 }
 
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_Snd_Dispatcher(STUHFL_T_DEVICE_CTX device, uint16_t cmd, uint16_t status, uint8_t *payloadData, uint16_t payloadDataLen)
 {
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
     uint16_t sndLen = 0;
 
     TRACE_PL_LOG_START();
+    if (pl->platformSndRawV) {
+        // header, payload and signature are handed over as they are, payload is not copied
+        uint8_t header[COMM_PAYLOAD_POS];
+        uint8_t bcc = 0;
+        STUHFL_T_IoVec iov[3];
+        uint8_t iovCnt = 0;
+
+        payloadDataLen = encodeSndHeader(header, pl->mode, pl->sndID, status, cmd, payloadDataLen);
+        pl->sndID++;
+
+        iov[iovCnt].data = header;
+        iov[iovCnt++].len = COMM_PAYLOAD_POS;
+        iov[iovCnt].data = payloadData;
+        iov[iovCnt++].len = payloadDataLen;
+        if (pl->mode & SIGNATURE_XOR_BCC) {
+            bcc = calcBcc(payloadData, payloadDataLen);
+            iov[iovCnt].data = &bcc;
+            iov[iovCnt++].len = 1;
+        }
+
+#define TB_SIZE    1024
+        char tbHeader[2*COMM_PAYLOAD_POS + 1];
+        char tb[TB_SIZE];
+        for (uint8_t i = 0; i < iovCnt; i++) {
+            sndLen = (uint16_t)(sndLen + iov[i].len);
+        }
+        TRACE_PL_LOG("Tx >>> (%04d) 0x%s%s", sndLen, byteArray2HexString(tbHeader, sizeof(tbHeader), header, COMM_PAYLOAD_POS), byteArray2HexString(tb, TB_SIZE, payloadData, payloadDataLen));
+#undef TB_SIZE
+
+        return pl->platformSndRawV(device, iov, iovCnt);
+    }
+
     // prepare frame
-    encodeSndFrame(snd, &sndLen, mode, sndID, status, cmd, payloadData, payloadDataLen);
-    sndID++;
+    encodeSndFrame(pl->snd, &sndLen, pl->mode, pl->sndID, status, cmd, payloadData, payloadDataLen);
+    pl->sndID++;
 
 #define TB_SIZE    1024
     char tb[TB_SIZE];
-    TRACE_PL_LOG("Tx >>> (%04d) 0x%s", sndLen, byteArray2HexString(tb, TB_SIZE, snd, sndLen));
+    TRACE_PL_LOG("Tx >>> (%04d) 0x%s", sndLen, byteArray2HexString(tb, TB_SIZE, pl->snd, sndLen));
 #undef TB_SIZE
 
     // finally send
-    return STUHFL_F_SndRaw_Dispatcher(device, snd, sndLen);
+    return STUHFL_F_SndRaw_Dispatcher(device, pl->snd, sndLen);
 }
 
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_Rcv_Dispatcher(STUHFL_T_DEVICE_CTX device, uint8_t *payloadData, uint16_t *payloadDataLen)
 {
-    uint16_t expectedLen;
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    uint16_t expectedLen = 0;
+    STUHFL_T_RET_CODE ret;
     *payloadDataLen = 0;
 
+    // 1) Receive complete frame into rcv
+    TRACE_PL_LOG_START();
+    if (pl->platformRcvRawAvailable) {
+        ret = rcvFrameRing(device, &expectedLen);
+    } else {
+        ret = rcvFrameExact(device, &expectedLen);
+    }
+    if (ret != ERR_NONE) {
+        return ret;
+    }
+
+#define TB_SIZE    1024
+    char tb[TB_SIZE];
+    TRACE_PL_LOG("Rx <<< (%04d) 0x%s", (COMM_PAYLOAD_POS+expectedLen), byteArray2HexString(tb, TB_SIZE, pl->rcv, (uint16_t)(COMM_PAYLOAD_POS+expectedLen)));
+#undef TB_SIZE
+
+    *payloadDataLen = expectedLen;
+
+    if (&pl->rcv[COMM_PAYLOAD_POS] != payloadData) {
+        memcpy(payloadData, &pl->rcv[COMM_PAYLOAD_POS], expectedLen);
+    }
+
+
+    // 2) Verify signature
+    uint16_t mode = COMM_GET_PREAMBLE_MODE(pl->rcv);
+    if (mode & SIGNATURE_XOR_BCC) {
+        uint8_t bcc = 0;
+        for (int i = 0; i < *payloadDataLen; i++) {
+            bcc ^= payloadData[i];
+        }
+
+        // invalid signature
+        if (bcc != 0) {
+            ret = ERR_PROTO;
+        }
+
+        // remove signature from payload
+        (*payloadDataLen)--;
+    }
+
+    return ret;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE rcvFrameExact(STUHFL_T_DEVICE_CTX device, uint16_t *expectedLen)
+{
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
     // NOTE: receive operation is split into 2 parts
     // 1) Read fixed data (header + status + cmd + payloadLength) and get the payload length information from the header
     // 2) Read the payload itself
@@ -232,83 +432,204 @@ STUHFL_T_RET_CODE STUHFL_F_Rcv_Dispatcher(STUHFL_T_DEVICE_CTX device, uint8_t *p
     //
     uint16_t rcvLen = COMM_PAYLOAD_POS;
 
-    TRACE_PL_LOG_START();
-    STUHFL_T_RET_CODE ret = STUHFL_F_PlatformRcvRaw(device, rcv, &rcvLen);
+    STUHFL_T_RET_CODE ret = pl->platformRcvRaw(device, pl->rcv, &rcvLen);
     if ((ret != ERR_NONE) || (rcvLen != COMM_PAYLOAD_POS)) {
         TRACE_PL_LOG("Rx <<< (%04d) .. no data packet received", rcvLen);
         return ERR_TIMEOUT;
     }
-    *payloadDataLen = 0;
 
     // Check cmd is a valid one
-    uint16_t cmd = COMM_GET_CMD(rcv);
-    if (((cmd >> 8) > STUHFL_CG_TS) || ((cmd & 0xFF) >= 0x30)) {
-        TRACE_PL_LOG("Rx <<< (%04d) .. unknown command (%04x), ignoring data ...", COMM_GET_PAYLOAD_LENGTH(rcv), cmd);
+    uint16_t cmd = COMM_GET_CMD(pl->rcv);
+    if (!STUHFL_F_IsKnownCmd(cmd)) {
+        TRACE_PL_LOG("Rx <<< (%04d) .. unknown command (%04x), ignoring data ...", COMM_GET_PAYLOAD_LENGTH(pl->rcv), cmd);
         return ERR_IO;
     }
 
     // 2) Payload
-    expectedLen = COMM_GET_PAYLOAD_LENGTH(rcv);
-    if (expectedLen > gRcvMaxLen-COMM_PAYLOAD_POS) {
+    *expectedLen = COMM_GET_PAYLOAD_LENGTH(pl->rcv);
+    if (*expectedLen > pl->rcvMaxLen-COMM_PAYLOAD_POS) {
         // Clamp to max size of Rx buffer
-        expectedLen = (uint16_t)(gRcvMaxLen - COMM_PAYLOAD_POS);
+        *expectedLen = (uint16_t)(pl->rcvMaxLen - COMM_PAYLOAD_POS);
     }
-    uint16_t len = expectedLen;
-    ret = STUHFL_F_PlatformRcvRaw(device, &rcv[COMM_PAYLOAD_POS], &len);
+    uint16_t len = *expectedLen;
+    ret = pl->platformRcvRaw(device, &pl->rcv[COMM_PAYLOAD_POS], &len);
+    if ((ret != ERR_NONE) || (len < *expectedLen)) {
 #define TB_SIZE    1024
-    char tb[TB_SIZE];
-    if ((ret != ERR_NONE) || (len < expectedLen)) {
-        TRACE_PL_LOG("Rx <<< (%04d) .. receive length mismatch error (%d), ignoring RX data: 0x%s", (COMM_PAYLOAD_POS+len), expectedLen, byteArray2HexString(tb, TB_SIZE, rcv, (uint16_t)(COMM_PAYLOAD_POS+len)));
-        return ERR_IO;
-    }
-    TRACE_PL_LOG("Rx <<< (%04d) 0x%s", (COMM_PAYLOAD_POS+len), byteArray2HexString(tb, TB_SIZE, rcv, (uint16_t)(COMM_PAYLOAD_POS+len)));
+        char tb[TB_SIZE];
+        TRACE_PL_LOG("Rx <<< (%04d) .. receive length mismatch error (%d), ignoring RX data: 0x%s", (COMM_PAYLOAD_POS+len), *expectedLen, byteArray2HexString(tb, TB_SIZE, pl->rcv, (uint16_t)(COMM_PAYLOAD_POS+len)));
 #undef TB_SIZE
-
-    rcvLen = (uint16_t)(rcvLen + expectedLen);
-    *payloadDataLen = expectedLen;
-
-    if (&rcv[COMM_PAYLOAD_POS] != payloadData) {
-        memcpy(payloadData, &rcv[COMM_PAYLOAD_POS], expectedLen);
+        return ERR_IO;
     }
+    return ERR_NONE;
+}
 
-
-    // 3) Verify signature
-    uint16_t mode = COMM_GET_PREAMBLE_MODE(rcv);
-    if (mode & SIGNATURE_XOR_BCC) {
-        uint8_t bcc = 0;
-        for (int i = 0; i < *payloadDataLen; i++) {
-            bcc ^= payloadData[i];
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE rcvFrameRing(STUHFL_T_DEVICE_CTX device, uint16_t *expectedLen)
+{
+    STUHFL_T_Reader_Ctx *ctx = STUHFL_F_CurReaderCtx();
+    STUHFL_T_PL_Ctx *pl = &ctx->pl;
+    STUHFL_T_RET_CODE ret = ERR_NONE;
+    uint32_t dropped = 0;
+    // one read timeout for the whole frame, however many reads it takes
+    uint32_t startTime = getMilliCount();
+    uint32_t timeout = ctx->bl.rdComTimeout;
+
+    for (;;) {
+        // 1) Header + status + CMD + payloadLen
+        while (RX_RING_LEN(pl) < COMM_PAYLOAD_POS) {
+            ret = rxRingFill(device, startTime, timeout);
+            if (ret != ERR_NONE) {
+                TRACE_PL_LOG("Rx <<< (%04d) .. no data packet received", RX_RING_LEN(pl));
+                // a lost connection (e.g. socket closed by peer) is reported as such
+                ret = (ret == ERR_IO) ? ERR_IO : ERR_TIMEOUT;
+                break;
+            }
+        }
+        if (ret != ERR_NONE) {
+            break;
+        }
+        rxRingPeek(pl->rcv, 0, COMM_PAYLOAD_POS);
+
+        // On corrupted or unknown header skip a single byte and scan for the next valid one.
+        // Give up after a full Rx buffer of garbage to return control to the caller
+        if (!isValidRcvHeader(pl->rcv)) {
+            pl->rxRingRd++;
+            if (++dropped >= pl->rcvMaxLen) {
+                TRACE_PL_LOG("Rx <<< .. no valid header found, ignoring data ...");
+                ret = ERR_IO;
+                break;
+            }
+            continue;
         }
 
-        // invalid signature
-        if (bcc != 0) {
-            ret = ERR_PROTO;
+        // 2) Payload
+        *expectedLen = COMM_GET_PAYLOAD_LENGTH(pl->rcv);
+        while (RX_RING_LEN(pl) < (uint32_t)(COMM_PAYLOAD_POS + *expectedLen)) {
+            if (rxRingFill(device, startTime, timeout) != ERR_NONE) {
+                ret = ERR_IO;
+                break;
+            }
+        }
+        if (ret != ERR_NONE) {
+            uint16_t len = (uint16_t)(RX_RING_LEN(pl) - COMM_PAYLOAD_POS);
+            rxRingPeek(&pl->rcv[COMM_PAYLOAD_POS], COMM_PAYLOAD_POS, len);
+#define TB_SIZE    1024
+            char tb[TB_SIZE];
+            TRACE_PL_LOG("Rx <<< (%04d) .. receive length mismatch error (%d), ignoring RX data: 0x%s", (COMM_PAYLOAD_POS+len), *expectedLen, byteArray2HexString(tb, TB_SIZE, pl->rcv, (uint16_t)(COMM_PAYLOAD_POS+len)));
+#undef TB_SIZE
+            // header may be bogus, drop its first byte only so that a following frame is found on next receive
+            pl->rxRingRd++;
+            dropped++;
+            break;
         }
+        rxRingPeek(&pl->rcv[COMM_PAYLOAD_POS], COMM_PAYLOAD_POS, *expectedLen);
+        pl->rxRingRd += (uint32_t)(COMM_PAYLOAD_POS + *expectedLen);
+        break;
+    }
 
-        // remove signature from payload
-        (*payloadDataLen)--;
+    if (dropped) {
+        pl->rxResyncCnt++;
+        pl->rxDroppedBytes += dropped;
+        TRACE_PL_LOG("Rx <<< .. resynchronized, %d bytes dropped (total resyncs: %d, dropped: %d)", dropped, pl->rxResyncCnt, pl->rxDroppedBytes);
     }
+    return ret;
+}
 
+// --------------------------------------------------------------------------
+static bool isValidRcvHeader(const uint8_t *header)
+{
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    uint16_t mode = COMM_GET_PREAMBLE_MODE(header);
+    int16_t status = (int16_t)COMM_GET_STATUS(header);
+    uint16_t cmd = COMM_GET_CMD(header);
+
+    // frames from board never have the host direction bit set, the signature is the only other defined mode bit
+    if ((mode & (uint16_t)~SIGNATURE_XOR_BCC) != DIRECTION_FROM_BOARD) {
+        return false;
+    }
+    // status is one of the (negative) STUHFL error codes
+    if ((status > (int16_t)ERR_GENERIC) || (status < -0xFF)) {
+        return false;
+    }
+    // Check cmd is one the firmware defines
+    if (!STUHFL_F_IsKnownCmd(cmd)) {
+        return false;
+    }
+    // Frame must fit into Rx buffer
+    if (COMM_GET_PAYLOAD_LENGTH(header) > pl->rcvMaxLen-COMM_PAYLOAD_POS) {
+        return false;
+    }
+    return true;
+}
+
+// --------------------------------------------------------------------------
+static STUHFL_T_RET_CODE rxRingFill(STUHFL_T_DEVICE_CTX device, uint32_t startTime, uint32_t timeout)
+{
+    STUHFL_T_Reader_Ctx *ctx = STUHFL_F_CurReaderCtx();
+    STUHFL_T_PL_Ctx *pl = &ctx->pl;
+    uint32_t wrPos = pl->rxRingWr & RX_RING_MASK;
+    uint32_t space = RX_RING_SIZE - RX_RING_LEN(pl);
+    // read into contiguous free space only, never empty as a frame fits into the ring
+    uint16_t len = (uint16_t)min(space, RX_RING_SIZE - wrPos);
+
+    // wait the time left of the frame only, with none left just what is already available is taken
+    uint32_t elapsed = getMilliSpan(startTime);
+    ctx->bl.rdComTimeout = (elapsed < timeout) ? (timeout - elapsed) : 0;
+    STUHFL_T_RET_CODE ret = pl->platformRcvRawAvailable(device, &pl->rxRing[wrPos], &len);
+    ctx->bl.rdComTimeout = timeout;
+    pl->rxRingWr += len;
+    if ((ret == ERR_NONE) && (len == 0)) {
+        ret = ERR_TIMEOUT;
+    }
     return ret;
 }
 
+// --------------------------------------------------------------------------
+static void rxRingPeek(uint8_t *data, uint32_t offset, uint32_t len)
+{
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    uint32_t rdPos = (pl->rxRingRd + offset) & RX_RING_MASK;
+    uint32_t first = min(len, RX_RING_SIZE - rdPos);
+
+    memcpy(data, &pl->rxRing[rdPos], first);
+    if (len > first) {
+        memcpy(&data[first], pl->rxRing, len - first);
+    }
+}
+
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_SndRaw_Dispatcher(STUHFL_T_DEVICE_CTX device, uint8_t *data, uint16_t dataLen)
 {
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
     //
-    return STUHFL_F_PlatformSndRaw(device, data, dataLen);
+    return pl->platformSndRaw(device, data, dataLen);
 }
 
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_RcvRaw_Dispatcher(STUHFL_T_DEVICE_CTX device, uint8_t *data, uint16_t *dataLen)
 {
-    //
-    return STUHFL_F_PlatformRcvRaw(device, data, dataLen);
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    // data already pulled into the receive ring comes first
+    uint16_t buffered = (uint16_t)min(RX_RING_LEN(pl), *dataLen);
+    if (buffered == 0) {
+        return pl->platformRcvRaw(device, data, dataLen);
+    }
+    rxRingPeek(data, 0, buffered);
+    pl->rxRingRd += buffered;
+
+    uint16_t len = (uint16_t)(*dataLen - buffered);
+    STUHFL_T_RET_CODE ret = ERR_NONE;
+    if (len) {
+        ret = pl->platformRcvRaw(device, &data[buffered], &len);
+    }
+    *dataLen = (uint16_t)(buffered + len);
+    return ret;
 }
 
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_SetParam_Dispatcher(STUHFL_T_DEVICE_CTX device, STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE value)
 {
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
     STUHFL_T_RET_CODE ret = ERR_PARAM;
     STUHFL_T_PARAM type = param & STUHFL_PARAM_TYPE_MASK;
     param &= STUHFL_PARAM_KEY_MASK;
@@ -321,35 +642,54 @@ STUHFL_T_RET_CODE STUHFL_F_SetParam_Dispatcher(STUHFL_T_DEVICE_CTX device, STUHF
         case STUHFL_PARAM_KEY_RD_TIMEOUT_MS: {
             uint32_t rdTimeout = 0;
             uint32_t wrTimeout = 0;
-            ret = STUHFL_F_PlatformGetTimeouts(device, &rdTimeout, &wrTimeout);
+            ret = pl->platformGetTimeouts(device, &rdTimeout, &wrTimeout);
             memcpy(&rdTimeout, value, sizeof(uint32_t));
-            ret = STUHFL_F_PlatformSetTimeouts(device, rdTimeout, wrTimeout);
+            ret = pl->platformSetTimeouts(device, rdTimeout, wrTimeout);
             TRACE_PL_LOG_APPEND("SetParam: RdTimeout:%d ", rdTimeout);
             break;
         }
         case STUHFL_PARAM_KEY_WR_TIMEOUT_MS: {
             uint32_t rdTimeout = 0;
             uint32_t wrTimeout = 0;
-            ret = STUHFL_F_PlatformGetTimeouts(device, &rdTimeout, &wrTimeout);
+            ret = pl->platformGetTimeouts(device, &rdTimeout, &wrTimeout);
             memcpy(&wrTimeout, value, sizeof(uint32_t));
-            ret = STUHFL_F_PlatformSetTimeouts(device, rdTimeout, wrTimeout);
+            ret = pl->platformSetTimeouts(device, rdTimeout, wrTimeout);
             TRACE_PL_LOG_APPEND("SetParam: WrTimeout:%d ", wrTimeout);
             break;
         }
         case STUHFL_PARAM_KEY_DTR: {
             uint8_t on = 0;
             memcpy(&on, value, sizeof(uint8_t));
-            ret = STUHFL_F_PlatformSetDTR(device, on);
+            ret = pl->platformSetDTR ? pl->platformSetDTR(device, on) : ERR_REQUEST;
             TRACE_PL_LOG_APPEND("SetParam: DTR:%d ", on);
             break;
         }
         case STUHFL_PARAM_KEY_RTS: {
             uint8_t on = 0;
             memcpy(&on, value, sizeof(uint8_t));
-            ret = STUHFL_F_PlatformSetRTS(device, on);
+            ret = pl->platformSetRTS ? pl->platformSetRTS(device, on) : ERR_REQUEST;
             TRACE_PL_LOG_APPEND("SetParam: RTS:%d ", on);
             break;
         }
+        case STUHFL_PARAM_KEY_RX_RESYNC_CNT: {
+            memcpy(&pl->rxResyncCnt, value, sizeof(uint32_t));
+            TRACE_PL_LOG_APPEND("SetParam: RxResyncCnt:%d ", pl->rxResyncCnt);
+            ret = ERR_NONE;
+            break;
+        }
+        case STUHFL_PARAM_KEY_RX_DROPPED_BYTES: {
+            memcpy(&pl->rxDroppedBytes, value, sizeof(uint32_t));
+            TRACE_PL_LOG_APPEND("SetParam: RxDroppedBytes:%d ", pl->rxDroppedBytes);
+            ret = ERR_NONE;
+            break;
+        }
+        case STUHFL_PARAM_KEY_TX_QUEUE: {
+            uint8_t on = 0;
+            memcpy(&on, value, sizeof(uint8_t));
+            ret = pl->platformSetTxQueue ? pl->platformSetTxQueue(device, on) : ERR_REQUEST;
+            TRACE_PL_LOG_APPEND("SetParam: TxQueue:%d ", on);
+            break;
+        }
         default:
             ret = ERR_PARAM;
             break;
@@ -369,6 +709,7 @@ STUHFL_T_RET_CODE STUHFL_F_SetParam_Dispatcher(STUHFL_T_DEVICE_CTX device, STUHF
 // --------------------------------------------------------------------------
 STUHFL_T_RET_CODE STUHFL_F_GetParam_Dispatcher(STUHFL_T_DEVICE_CTX device, STUHFL_T_PARAM param, STUHFL_T_PARAM_VALUE value)
 {
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
     STUHFL_T_RET_CODE ret = ERR_PARAM;
     STUHFL_T_PARAM type = param & STUHFL_PARAM_TYPE_MASK;
     param &= STUHFL_PARAM_KEY_MASK;
@@ -382,31 +723,50 @@ STUHFL_T_RET_CODE STUHFL_F_GetParam_Dispatcher(STUHFL_T_DEVICE_CTX device, STUHF
         case STUHFL_PARAM_KEY_RD_TIMEOUT_MS: {
             uint32_t rdTimeout = 0;
             uint32_t wrTimeout = 0;
-            ret = STUHFL_F_PlatformGetTimeouts(device, &rdTimeout, &wrTimeout);
+            ret = pl->platformGetTimeouts(device, &rdTimeout, &wrTimeout);
             TRACE_PL_LOG_APPEND("GetParam: RdTimeout:%d ", rdTimeout);
-            memcpy(&value, &rdTimeout, sizeof(uint32_t));
+            memcpy(value, &rdTimeout, sizeof(uint32_t));
             break;
         }
         case STUHFL_PARAM_KEY_WR_TIMEOUT_MS: {
             uint32_t rdTimeout = 0;
             uint32_t wrTimeout = 0;
-            ret = STUHFL_F_PlatformGetTimeouts(device, &rdTimeout, &wrTimeout);
+            ret = pl->platformGetTimeouts(device, &rdTimeout, &wrTimeout);
             TRACE_PL_LOG_APPEND("GetParam: WrTimeout:%d ", wrTimeout);
-            memcpy(&value, &wrTimeout, sizeof(uint32_t));
+            memcpy(value, &wrTimeout, sizeof(uint32_t));
             break;
         }
         case STUHFL_PARAM_KEY_DTR: {
             uint8_t dtrValue = 0;
-            ret = STUHFL_F_PlatformGetDTR(device, &dtrValue);
+            ret = pl->platformGetDTR ? pl->platformGetDTR(device, &dtrValue) : ERR_REQUEST;
             TRACE_PL_LOG_APPEND("GetParam: DTR:%d ", dtrValue);
-            memcpy(&value, &dtrValue, sizeof(uint8_t));
+            memcpy(value, &dtrValue, sizeof(uint8_t));
             break;
         }
         case STUHFL_PARAM_KEY_RTS: {
             uint8_t rtsValue = 0;
-            ret = STUHFL_F_PlatformGetRTS(device, &rtsValue);
+            ret = pl->platformGetRTS ? pl->platformGetRTS(device, &rtsValue) : ERR_REQUEST;
             TRACE_PL_LOG_APPEND("GetParam: RTS:%d ", rtsValue);
-            memcpy(&value, &rtsValue, sizeof(uint8_t));
+            memcpy(value, &rtsValue, sizeof(uint8_t));
+            break;
+        }
+        case STUHFL_PARAM_KEY_RX_RESYNC_CNT: {
+            TRACE_PL_LOG_APPEND("GetParam: RxResyncCnt:%d ", pl->rxResyncCnt);
+            memcpy(value, &pl->rxResyncCnt, sizeof(uint32_t));
+            ret = ERR_NONE;
+            break;
+        }
+        case STUHFL_PARAM_KEY_RX_DROPPED_BYTES: {
+            TRACE_PL_LOG_APPEND("GetParam: RxDroppedBytes:%d ", pl->rxDroppedBytes);
+            memcpy(value, &pl->rxDroppedBytes, sizeof(uint32_t));
+            ret = ERR_NONE;
+            break;
+        }
+        case STUHFL_PARAM_KEY_TX_QUEUE: {
+            uint8_t on = 0;
+            ret = pl->platformGetTxQueue ? pl->platformGetTxQueue(device, &on) : ERR_REQUEST;
+            TRACE_PL_LOG_APPEND("GetParam: TxQueue:%d ", on);
+            memcpy(value, &on, sizeof(uint8_t));
             break;
         }
         default:
@@ -430,41 +790,52 @@ STUHFL_T_RET_CODE STUHFL_F_GetParam_Dispatcher(STUHFL_T_DEVICE_CTX device, STUHF
 
 void encodeSndFrame(uint8_t *sndData, uint16_t *sndDataLen, uint16_t mode, uint16_t id, uint16_t status, uint16_t cmd, uint8_t *payloadData, uint16_t payloadDataLen)
 {
-    // 1. build header
-    COMM_SET_PREAMBLE_MODE(sndData, mode);
-    COMM_SET_PREAMBLE_ID(sndData, id);
-    COMM_SET_STATUS(sndData, status);
-
-    // 2. CMD + PayloadLen
-    COMM_SET_CMD(sndData, cmd);
-    payloadDataLen = (uint16_t)(payloadDataLen + ((mode & SIGNATURE_XOR_BCC) ? 1U : 0U));
-    COMM_SET_PAYLOAD_LENGTH(sndData, payloadDataLen);
-
-    // set sndDataLen to at least HeaderLen + CmdLen + PayloadLen
-    if (payloadDataLen > gSndMaxLen-COMM_PAYLOAD_POS) {
-        // Clamp to max size of Tx buffer
-        payloadDataLen = (uint16_t)(gSndMaxLen - COMM_PAYLOAD_POS);
-    }
-    *sndDataLen = (uint16_t)(COMM_PAYLOAD_POS + payloadDataLen);
+    // 1. header, payload is clamped to max size of Tx buffer
+    payloadDataLen = encodeSndHeader(sndData, mode, id, status, cmd, payloadDataLen);
 
-    // 3. payload (copy if needed)
+    // 2. payload (copy if needed)
     if (&sndData[COMM_PAYLOAD_POS] != payloadData) {
         memcpy(&sndData[COMM_PAYLOAD_POS], payloadData, payloadDataLen);
-        *sndDataLen = (uint16_t)(*sndDataLen + payloadDataLen);
     }
+    *sndDataLen = (uint16_t)(COMM_PAYLOAD_POS + payloadDataLen);
 
-
-    // 4. checksum (if needed)
+    // 3. checksum (if needed)
     if (mode & SIGNATURE_XOR_BCC) {
-        sndData[COMM_PAYLOAD_POS + payloadDataLen] = 0;
-        for (int i = 0; i < payloadDataLen; i++) {
-            sndData[COMM_PAYLOAD_POS + payloadDataLen] ^= payloadData[i];
-        }
+        sndData[COMM_PAYLOAD_POS + payloadDataLen] = calcBcc(&sndData[COMM_PAYLOAD_POS], payloadDataLen);
         // add signature to length
         (*sndDataLen) ++;
     }
 }
 
+// --------------------------------------------------------------------------
+static uint16_t encodeSndHeader(uint8_t *header, uint16_t mode, uint16_t id, uint16_t status, uint16_t cmd, uint16_t payloadDataLen)
+{
+    STUHFL_T_PL_Ctx *pl = &STUHFL_F_CurReaderCtx()->pl;
+    uint16_t signatureLen = (mode & SIGNATURE_XOR_BCC) ? 1U : 0U;
+
+    // never send more than the board is able to receive
+    if (payloadDataLen > (pl->sndMaxLen - COMM_PAYLOAD_POS - signatureLen)) {
+        payloadDataLen = (uint16_t)(pl->sndMaxLen - COMM_PAYLOAD_POS - signatureLen);
+    }
+
+    COMM_SET_PREAMBLE_MODE(header, mode);
+    COMM_SET_PREAMBLE_ID(header, id);
+    COMM_SET_STATUS(header, status);
+    COMM_SET_CMD(header, cmd);
+    COMM_SET_PAYLOAD_LENGTH(header, payloadDataLen + signatureLen);
+    return payloadDataLen;
+}
+
+// --------------------------------------------------------------------------
+static uint8_t calcBcc(const uint8_t *data, uint16_t dataLen)
+{
+    uint8_t bcc = 0;
+    for (uint16_t i = 0; i < dataLen; i++) {
+        bcc ^= data[i];
+    }
+    return bcc;
+}
+
 /**
   * @}
   */
@@ -228,6 +228,74 @@ STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_Gb29768_Erase(STUHFL_T_Gb297
     return ret;
 }
 
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_EpcKeyFromBytes(STUHFL_T_Epc_Key *key, const uint8_t *epc, uint8_t len)
+{
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    if ((key == NULL) || ((epc == NULL) && (len != 0U))) {
+        return ERR_PARAM;
+    }
+    for (uint8_t i = 0; i < 8U; i++) {
+        hi = (hi << 8) | ((i < len) ? epc[i] : 0U);
+    }
+    if (len <= STUHFL_D_EPC_KEY_LEN) {
+        for (uint8_t i = 8; i < 16U; i++) {
+            lo = (lo << 8) | ((i < len) ? epc[i] : 0U);
+        }
+    } else {
+        // FNV-1a over the remaining bytes
+        lo = 0xcbf29ce484222325ULL;
+        for (uint8_t i = 8; i < len; i++) {
+            lo = (lo ^ epc[i]) * 0x100000001b3ULL;
+        }
+    }
+    key->hi = hi;
+    key->lo = lo;
+    key->len = len;
+    return ERR_NONE;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API uint64_t CALL_CONV STUHFL_F_EpcKeyHash(const STUHFL_T_Epc_Key *key)
+{
+    // 64 bit finalizer of MurmurHash3 over both words
+    uint64_t h = key->hi ^ ((key->lo << 32) | (key->lo >> 32)) ^ key->len;
+    h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdULL;
+    h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+    return h ^ (h >> 33);
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API int CALL_CONV STUHFL_F_EpcKeyCompare(const STUHFL_T_Epc_Key *a, const STUHFL_T_Epc_Key *b)
+{
+    if (a->hi != b->hi) {
+        return (a->hi < b->hi) ? -1 : 1;
+    }
+    if (a->lo != b->lo) {
+        return (a->lo < b->lo) ? -1 : 1;
+    }
+    return (int)a->len - (int)b->len;
+}
+
+// --------------------------------------------------------------------------
+STUHFL_DLL_API STUHFL_T_RET_CODE CALL_CONV STUHFL_F_EpcKeyToHex(const STUHFL_T_Epc_Key *key, char *hex, uint16_t hexSize)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    if ((key == NULL) || (hex == NULL) || (key->len > STUHFL_D_EPC_KEY_LEN) || (hexSize < ((2U * key->len) + 1U))) {
+        return ERR_PARAM;
+    }
+    for (uint8_t i = 0; i < key->len; i++) {
+        uint8_t b = (uint8_t)(((i < 8U) ? (key->hi >> (56U - (8U * i))) : (key->lo >> (56U - (8U * (i - 8U))))) & 0xFFU);
+        hex[2U * i] = digits[b >> 4];
+        hex[(2U * i) + 1U] = digits[b & 0x0FU];
+    }
+    hex[2U * key->len] = 0;
+    return ERR_NONE;
+}
+
 /**
   * @}
   */
@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file           bench.c
+  * @brief          Host benchmarks and checks of the STUHFL library
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+#include "stuhfl.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    const char*         name;
+    bool                (*run)(void);
+} BenchEntry;
+
+static const BenchEntry benchEntries[] = {
+    { "rcv",        bench_RcvLatency },
+    { "socket",     bench_SocketTransport },
+    { "tlv",        bench_TlvDecode },
+    { "codec",      bench_Codec },
+    { "stop",       bench_RunnerStopLatency },
+};
+#define BENCH_ENTRY_CNT     (sizeof(benchEntries) / sizeof(benchEntries[0]))
+
+uint64_t benchMicroCount(clockid_t clock)
+{
+    struct timespec t;
+    clock_gettime(clock, &t);
+    return ((uint64_t)t.tv_sec * 1000000) + ((uint64_t)t.tv_nsec / 1000);
+}
+
+int benchCompareU32(const void* a, const void* b)
+{
+    uint32_t la = *(const uint32_t*)a;
+    uint32_t lb = *(const uint32_t*)b;
+    return (la > lb) - (la < lb);
+}
+
+/**
+  * @brief          Runs the benchmarks named on the command line, all of them without arguments
+  *
+  * @retval         0 when all passed, 1 otherwise
+  */
+int main(int argc, char* argv[])
+{
+    bool pass = true;
+
+    for (int a = 1; a < argc; a++) {
+        bool known = false;
+        for (uint32_t e = 0; e < BENCH_ENTRY_CNT; e++) {
+            known |= (strcmp(argv[a], benchEntries[e].name) == 0);
+        }
+        if (!known) {
+            printf("usage: %s [", argv[0]);
+            for (uint32_t e = 0; e < BENCH_ENTRY_CNT; e++) {
+                printf("%s%s", e ? "|" : "", benchEntries[e].name);
+            }
+            printf("]...\n");
+            return 1;
+        }
+    }
+
+    for (uint32_t e = 0; e < BENCH_ENTRY_CNT; e++) {
+        bool selected = (argc <= 1);
+        for (int a = 1; a < argc; a++) {
+            selected |= (strcmp(argv[a], benchEntries[e].name) == 0);
+        }
+        if (selected && !benchEntries[e].run()) {
+            printf("%s: FAIL\n", benchEntries[e].name);
+            pass = false;
+        }
+    }
+    fflush(stdout);
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+/**
+  ******************************************************************************
+  * @file           bench.h
+  * @brief          Host benchmarks and checks header file
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+#if !defined __BENCH_H
+#define __BENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+//
+#ifdef __cplusplus
+extern "C"
+{
+#endif //__cplusplus
+
+#define SND_BUFFER_SIZE         (UART_RX_BUFFER_SIZE)   /* HOST SND buffer based on FW RCV buffer */
+#define RCV_BUFFER_SIZE         (UART_TX_BUFFER_SIZE)   /* HOST RCV buffer based on FW SND buffer */
+
+    // --------------------------------------------------------------------------
+    // Utilities
+    uint64_t benchMicroCount(clockid_t clock);
+    int benchCompareU32(const void* a, const void* b);
+
+    // Benchmarks and checks, none needs a reader. Each returns false when it failed
+    bool bench_RcvLatency(void);
+    bool bench_SocketTransport(void);
+    bool bench_TlvDecode(void);
+    bool bench_Codec(void);
+    bool bench_RunnerStopLatency(void);
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif //__BENCH_H
@@ -0,0 +1,205 @@
+/**
+  ******************************************************************************
+  * @file           bench_codec.c
+  * @brief          Command codec benchmark
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+#include "stuhfl.h"
+#include "stuhfl_sl.h"
+#include "stuhfl_dl.h"
+#include "stuhfl_pl.h"
+#include "stuhfl_err.h"
+#include "stuhfl_platform.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define CODEC_BENCH_ITERATIONS          100000
+#define CODEC_BENCH_PORT                "loop://"
+
+/* loopback transport: every sent frame is returned as reply with the same ID, command and payload */
+static struct {
+    uint8_t             data[RCV_BUFFER_SIZE];
+    uint16_t            len;
+    uint16_t            pos;
+} codecBenchLoop;
+
+static STUHFL_T_RET_CODE codecBenchConnect(STUHFL_T_DEVICE_CTX* device, char* port, uint32_t br)
+{
+    (void)port;
+    (void)br;
+    *device = (STUHFL_T_DEVICE_CTX)&codecBenchLoop;
+    codecBenchLoop.len = codecBenchLoop.pos = 0;
+    return ERR_NONE;
+}
+
+static STUHFL_T_RET_CODE codecBenchReset(STUHFL_T_DEVICE_CTX* device, STUHFL_T_RESET resetType)
+{
+    (void)device;
+    (void)resetType;
+    return ERR_NONE;
+}
+
+static STUHFL_T_RET_CODE codecBenchDisconnect(STUHFL_T_DEVICE_CTX* device)
+{
+    (void)device;
+    return ERR_NONE;
+}
+
+static STUHFL_T_RET_CODE codecBenchSndRaw(STUHFL_T_DEVICE_CTX* device, uint8_t* data, uint16_t dataLen)
+{
+    (void)device;
+    if (dataLen > sizeof(codecBenchLoop.data)) {
+        return ERR_PARAM;
+    }
+    memcpy(codecBenchLoop.data, data, dataLen);
+    COMM_SET_PREAMBLE_MODE(codecBenchLoop.data, 0x0000);
+    COMM_SET_STATUS(codecBenchLoop.data, ERR_NONE);
+    codecBenchLoop.len = dataLen;
+    codecBenchLoop.pos = 0;
+    return ERR_NONE;
+}
+
+static STUHFL_T_RET_CODE codecBenchRcvRaw(STUHFL_T_DEVICE_CTX* device, uint8_t* data, uint16_t* dataLen)
+{
+    (void)device;
+    uint16_t len = (uint16_t)(codecBenchLoop.len - codecBenchLoop.pos);
+    if (*dataLen < len) {
+        len = *dataLen;
+    }
+    memcpy(data, &codecBenchLoop.data[codecBenchLoop.pos], len);
+    codecBenchLoop.pos = (uint16_t)(codecBenchLoop.pos + len);
+    *dataLen = len;
+    return (len != 0) ? ERR_NONE : ERR_TIMEOUT;
+}
+
+static STUHFL_T_RET_CODE codecBenchSetTimeouts(STUHFL_T_DEVICE_CTX* device, uint32_t rdTimeout, uint32_t wrTimeout)
+{
+    (void)device;
+    (void)rdTimeout;
+    (void)wrTimeout;
+    return ERR_NONE;
+}
+
+static STUHFL_T_RET_CODE codecBenchGetTimeouts(STUHFL_T_DEVICE_CTX* device, uint32_t* rdTimeout, uint32_t* wrTimeout)
+{
+    (void)device;
+    *rdTimeout = *wrTimeout = 0;
+    return ERR_NONE;
+}
+
+typedef struct {
+    const char*         name;
+    STUHFL_T_CMD        cmd;            // command executed, 0 for a param access
+    STUHFL_T_PARAM      param;
+    bool                set;
+} CodecBenchEntry;
+
+static const CodecBenchEntry codecBenchEntries[] = {
+    { "Gen2 Select",        (STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_SELECT,                0, false },
+    { "Gen2 Read",          (STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_READ,                  0, false },
+    { "Gen2 Write",         (STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_WRITE,                 0, false },
+    { "Gen2 BlockWrite",    (STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_BLOCKWRITE,            0, false },
+    { "Gen2 Lock",          (STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_LOCK,                  0, false },
+    { "Gen2 Kill",          (STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_KILL,                  0, false },
+    { "Gen2 GenericCmd",    (STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_GENERIC_CMD,           0, false },
+    { "Gen2 QueryRssi",     (STUHFL_CG_SL << 8) | STUHFL_CC_GEN2_QUERY_MEASURE_RSSI_CMD, 0, false },
+    { "Set TxRxCfg",        0, STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_TXRX_CFG,          true },
+    { "Get TxRxCfg",        0, STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_TXRX_CFG,          false },
+    { "Set FreqHop",        0, STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_FREQ_HOP,          true },
+    { "Get FreqHop",        0, STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_FREQ_HOP,          false },
+    { "Set Gen2ProtocolCfg", 0, STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_GEN2PROTOCOL_CFG, true },
+    { "Get Gen2ProtocolCfg", 0, STUHFL_PARAM_TYPE_ST25RU3993 | STUHFL_PARAM_KEY_RWD_GEN2PROTOCOL_CFG, false },
+};
+
+/**
+  * @brief          Command codec benchmark.<br>
+  *                 Executes commands and param accesses against a loopback transport that echoes
+  *                 each frame, so the time per call is spent in encoding, framing and decoding only.
+  *
+  * @retval         true if all calls succeeded
+  */
+bool bench_Codec(void)
+{
+    static uint8_t sndData[SND_BUFFER_SIZE];
+    static uint8_t rcvData[RCV_BUFFER_SIZE];
+    static uint8_t sndParams[1024];
+    static uint8_t rcvParams[1024];
+    STUHFL_T_Transport transport = {
+        .prefix = CODEC_BENCH_PORT,
+        .connect = codecBenchConnect,
+        .reset = codecBenchReset,
+        .disconnect = codecBenchDisconnect,
+        .sndRaw = codecBenchSndRaw,
+        .rcvRaw = codecBenchRcvRaw,
+        .setTimeouts = codecBenchSetTimeouts,
+        .getTimeouts = codecBenchGetTimeouts,
+    };
+    STUHFL_T_DEVICE_CTX device = 0;
+    STUHFL_T_READER_CTX ctx = NULL;
+
+    bool pass = true;
+
+    if ((STUHFL_F_RegisterTransport(&transport) != ERR_NONE) || (STUHFL_F_CreateReaderCtx(&ctx) != ERR_NONE)) {
+        return false;
+    }
+    STUHFL_F_SelectReaderCtx(ctx);
+    STUHFL_T_RET_CODE ret = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_PORT, (STUHFL_T_PARAM_VALUE)CODEC_BENCH_PORT);
+    ret |= STUHFL_F_Connect(&device, sndData, SND_BUFFER_SIZE, rcvData, RCV_BUFFER_SIZE);
+
+    printf("\n--- Command codec: loopback transport, %u calls each ---\n", CODEC_BENCH_ITERATIONS);
+    for (uint32_t e = 0; (ret == ERR_NONE) && (e < sizeof(codecBenchEntries) / sizeof(codecBenchEntries[0])); e++) {
+        const CodecBenchEntry* entry = &codecBenchEntries[e];
+        STUHFL_T_RET_CODE callRet = ERR_NONE;
+
+        uint64_t start = benchMicroCount(CLOCK_MONOTONIC);
+        for (uint32_t i = 0; (callRet == ERR_NONE) && (i < CODEC_BENCH_ITERATIONS); i++) {
+            if (entry->cmd != 0) {
+                callRet = STUHFL_F_ExecuteCmd(entry->cmd, sndParams, rcvParams);
+            } else if (entry->set) {
+                callRet = STUHFL_F_SetParam(entry->param, sndParams);
+            } else {
+                callRet = STUHFL_F_GetParam(entry->param, rcvParams);
+            }
+        }
+        uint64_t time = benchMicroCount(CLOCK_MONOTONIC) - start;
+
+        if (callRet == ERR_NONE) {
+            printf("%-20s: %u ns\n", entry->name, (uint32_t)((time * 1000) / CODEC_BENCH_ITERATIONS));
+        } else {
+            printf("%-20s: failed (%d)\n", entry->name, callRet);
+            pass = false;
+        }
+    }
+    if (ret != ERR_NONE) {
+        printf("connect     : failed (%d)\n", ret);
+        pass = false;
+    }
+
+    STUHFL_F_Disconnect();
+    STUHFL_F_SelectReaderCtx(NULL);
+    STUHFL_F_DestroyReaderCtx(ctx);
+    transport.connect = NULL;
+    STUHFL_F_RegisterTransport(&transport);
+    printf("\n");
+    return pass;
+}
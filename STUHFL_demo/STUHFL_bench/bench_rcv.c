@@ -0,0 +1,142 @@
+/**
+  ******************************************************************************
+  * @file           bench_rcv.c
+  * @brief          Serial receive benchmark
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+#include "stuhfl.h"
+#include "stuhfl_err.h"
+#include "stuhfl_bl_posix.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+
+#define RCV_BENCH_FRAMES                1000
+#define RCV_BENCH_FRAME_LEN             64
+#define RCV_BENCH_FRAME_INTERVAL_US     2000
+
+typedef struct {
+    int                 fd;
+    uint32_t            frames;
+    uint64_t            sndTime[RCV_BENCH_FRAMES];
+} RcvBenchWriter;
+
+static void* rcvBenchWriterFunc(void* ptr)
+{
+    RcvBenchWriter* writer = (RcvBenchWriter*)ptr;
+    uint8_t frame[RCV_BENCH_FRAME_LEN];
+
+    memset(frame, 0xA5, sizeof(frame));
+    for (uint32_t i = 0; i < writer->frames; i++) {
+        usleep(RCV_BENCH_FRAME_INTERVAL_US);
+        writer->sndTime[i] = benchMicroCount(CLOCK_MONOTONIC);
+        if (write(writer->fd, frame, sizeof(frame)) != sizeof(frame)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/* receive loop used before poll(), kept here as reference for the benchmark */
+static STUHFL_T_RET_CODE rcvBenchLegacy(int fd, uint8_t* data, uint16_t dataLen)
+{
+    int nBytesAvailable = 0;
+    uint32_t timeout = 2000 * 10;
+    while (((--timeout) > 0) && (nBytesAvailable < dataLen)) {
+        ioctl(fd, FIONREAD, &nBytesAvailable);
+        usleep(100);
+    }
+    if (nBytesAvailable < dataLen) {
+        return ERR_TIMEOUT;
+    }
+    return (read(fd, data, dataLen) == dataLen) ? ERR_NONE : ERR_IO;
+}
+
+static bool rcvBenchRun(bool usePoll, uint32_t frames)
+{
+    static RcvBenchWriter writer;
+    static uint32_t latency[RCV_BENCH_FRAMES];
+    uint8_t data[RCV_BENCH_FRAME_LEN];
+    uint32_t latencyCnt = 0;
+    int fds[2];
+    pthread_t thread;
+
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    // same as the serial port, the read side is non blocking
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    STUHFL_T_DEVICE_CTX device = (STUHFL_T_DEVICE_CTX)(intptr_t)fds[0];
+
+    writer.fd = fds[1];
+    writer.frames = frames;
+    uint64_t cpuStart = benchMicroCount(CLOCK_THREAD_CPUTIME_ID);
+    uint64_t wallStart = benchMicroCount(CLOCK_MONOTONIC);
+    pthread_create(&thread, NULL, rcvBenchWriterFunc, &writer);
+
+    for (uint32_t i = 0; i < frames; i++) {
+        uint16_t len = RCV_BENCH_FRAME_LEN;
+        STUHFL_T_RET_CODE ret = usePoll ? STUHFL_F_RcvRaw_Posix(&device, data, &len) : rcvBenchLegacy(fds[0], data, len);
+        if (ret != ERR_NONE) {
+            break;
+        }
+        latency[latencyCnt++] = (uint32_t)(benchMicroCount(CLOCK_MONOTONIC) - writer.sndTime[i]);
+    }
+
+    uint64_t cpu = benchMicroCount(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+    uint64_t wall = benchMicroCount(CLOCK_MONOTONIC) - wallStart;
+    pthread_join(thread, NULL);
+    close(fds[0]);
+    close(fds[1]);
+
+    printf("%s\n", usePoll ? "poll()" : "FIONREAD + usleep(100)");
+    printf("frames      : %u of %u\n", latencyCnt, frames);
+    printf("cpu         : %u us (%u.%u %%)\n", (uint32_t)cpu, (uint32_t)((cpu * 100) / wall), (uint32_t)(((cpu * 1000) / wall) % 10));
+    if (latencyCnt) {
+        qsort(latency, latencyCnt, sizeof(uint32_t), benchCompareU32);
+        printf("p50         : %u us\n", latency[latencyCnt / 2]);
+        printf("p99         : %u us\n", latency[(latencyCnt * 99) / 100]);
+        printf("max         : %u us\n", latency[latencyCnt - 1]);
+    }
+    return (latencyCnt == frames);
+}
+
+/**
+  * @brief          Serial receive benchmark.<br>
+  *                 Feeds frames through a pipe at a fixed rate and compares CPU time and
+  *                 per frame latency of the poll() receive against the former FIONREAD + usleep loop.
+  *
+  * @retval         true if all frames were received by both variants
+  */
+bool bench_RcvLatency(void)
+{
+    printf("\n--- Serial receive: %d byte frames every %d us ---\n", RCV_BENCH_FRAME_LEN, RCV_BENCH_FRAME_INTERVAL_US);
+    bool pass = rcvBenchRun(false, RCV_BENCH_FRAMES);
+    pass &= rcvBenchRun(true, RCV_BENCH_FRAMES);
+    printf("\n");
+    return pass;
+}
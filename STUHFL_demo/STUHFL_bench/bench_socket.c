@@ -0,0 +1,191 @@
+/**
+  ******************************************************************************
+  * @file           bench_socket.c
+  * @brief          Socket transport check
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+#include "stuhfl.h"
+#include "stuhfl_sl_gen2.h"
+#include "stuhfl_dl.h"
+#include "stuhfl_pl.h"
+#include "stuhfl_err.h"
+#include "stuhfl_platform.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define SOCKET_TEST_UNIX_PATH           "/tmp/stuhfl_bench.sock"
+#define SOCKET_TEST_RD_TIMEOUT_MS       200
+
+static bool socketStandInRcvFrame(int fd, uint8_t* header)
+{
+    static uint8_t payload[0x10000];
+    if (recv(fd, header, COMM_PAYLOAD_POS, MSG_WAITALL) != COMM_PAYLOAD_POS) {
+        return false;
+    }
+    uint16_t len = COMM_GET_PAYLOAD_LENGTH(header);
+    return (len == 0) || (recv(fd, payload, len, MSG_WAITALL) == len);
+}
+
+/* stands in for the reader: answers the first request, ignores the second and closes on the third */
+static void* socketStandInFunc(void* ptr)
+{
+    int fd = accept(*(int*)ptr, NULL, NULL);
+    uint8_t header[COMM_PAYLOAD_POS];
+
+    if (fd < 0) {
+        return NULL;
+    }
+    if (socketStandInRcvFrame(fd, header)) {
+        STUHFL_T_Read readData = STUHFL_O_READ_INIT();
+        readData.bytes2Read = 2;
+        readData.data[0] = 0xAB;
+        readData.data[1] = 0xCD;
+        uint8_t reply[COMM_PAYLOAD_POS + 2 + sizeof(STUHFL_T_Read)];
+        COMM_SET_PREAMBLE_MODE(reply, 0x0000);
+        COMM_SET_PREAMBLE_ID(reply, COMM_GET_PREAMBLE_ID(header));
+        COMM_SET_STATUS(reply, ERR_NONE);
+        COMM_SET_CMD(reply, COMM_GET_CMD(header));
+        COMM_SET_PAYLOAD_LENGTH(reply, 2 + sizeof(STUHFL_T_Read));
+        reply[COMM_PAYLOAD_POS] = STUHFL_TAG_GEN2_READ;
+        reply[COMM_PAYLOAD_POS + 1] = sizeof(STUHFL_T_Read);
+        memcpy(&reply[COMM_PAYLOAD_POS + 2], &readData, sizeof(STUHFL_T_Read));
+        send(fd, reply, sizeof(reply), MSG_NOSIGNAL);
+    }
+    // the host only sends the third request after the second one timed out
+    socketStandInRcvFrame(fd, header);
+    socketStandInRcvFrame(fd, header);
+    close(fd);
+    return NULL;
+}
+
+static bool socketTestRun(const char* port, int listenFd)
+{
+    static uint8_t sndData[SND_BUFFER_SIZE];
+    static uint8_t rcvData[RCV_BUFFER_SIZE];
+    STUHFL_T_DEVICE_CTX device = 0;
+    STUHFL_T_READER_CTX ctx = NULL;
+    pthread_t thread;
+
+    if (STUHFL_F_CreateReaderCtx(&ctx) != ERR_NONE) {
+        return false;
+    }
+    STUHFL_F_SelectReaderCtx(ctx);
+    pthread_create(&thread, NULL, socketStandInFunc, &listenFd);
+
+    uint32_t rdTimeout = SOCKET_TEST_RD_TIMEOUT_MS;
+    STUHFL_T_RET_CODE ret = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_PORT, (STUHFL_T_PARAM_VALUE)port);
+    ret |= STUHFL_F_Connect(&device, sndData, SND_BUFFER_SIZE, rcvData, RCV_BUFFER_SIZE);
+    ret |= STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&rdTimeout);
+
+    // 1) one frame round trip
+    STUHFL_T_Read readData = STUHFL_O_READ_INIT();
+    readData.bytes2Read = 2;
+    STUHFL_T_RET_CODE roundTrip = (ret == ERR_NONE) ? STUHFL_F_Gen2_Read(&readData) : ret;
+    bool roundTripOk = (roundTrip == ERR_NONE) && (readData.data[0] == 0xAB) && (readData.data[1] == 0xCD);
+
+    // 2) unanswered request runs into the read timeout
+    uint32_t startTime = getMilliCount();
+    STUHFL_T_RET_CODE timeout = (ret == ERR_NONE) ? STUHFL_F_Gen2_Read(&readData) : ret;
+    uint32_t timeoutTime = getMilliSpan(startTime);
+    bool timeoutOk = (timeout == ERR_TIMEOUT) && (timeoutTime >= SOCKET_TEST_RD_TIMEOUT_MS) && (timeoutTime < 2 * SOCKET_TEST_RD_TIMEOUT_MS);
+
+    // 3) peer closes the connection
+    STUHFL_T_RET_CODE closed = (ret == ERR_NONE) ? STUHFL_F_Gen2_Read(&readData) : ret;
+    bool closedOk = (closed == ERR_IO);
+
+    STUHFL_F_Disconnect();
+    // unblocks the stand-in if the connect failed
+    shutdown(listenFd, SHUT_RDWR);
+    pthread_join(thread, NULL);
+    STUHFL_F_SelectReaderCtx(NULL);
+    STUHFL_F_DestroyReaderCtx(ctx);
+
+    printf("%s\n", port);
+    printf("round trip  : %s (%d)\n", roundTripOk ? "pass" : "FAIL", roundTrip);
+    printf("rd timeout  : %s (%d after %u ms)\n", timeoutOk ? "pass" : "FAIL", timeout, timeoutTime);
+    printf("peer close  : %s (%d)\n", closedOk ? "pass" : "FAIL", closed);
+    return roundTripOk && timeoutOk && closedOk;
+}
+
+/**
+  * @brief          Socket transport check.<br>
+  *                 Opens a local TCP and a local AF_UNIX listener standing in for the reader
+  *                 and checks a frame round trip, the read timeout and the error on peer close
+  *                 through "tcp://127.0.0.1:<port>" and "unix://<path>".
+  *
+  * @retval         true if all checks passed
+  */
+bool bench_SocketTransport(void)
+{
+    char port[64];
+    bool pass = true;
+
+    printf("\n--- Socket transport ---\n");
+
+    int tcpFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in tcpAddr = { 0 };
+    socklen_t tcpAddrLen = sizeof(tcpAddr);
+    tcpAddr.sin_family = AF_INET;
+    tcpAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((tcpFd >= 0)
+        && (bind(tcpFd, (struct sockaddr*)&tcpAddr, sizeof(tcpAddr)) == 0)
+        && (listen(tcpFd, 1) == 0)
+        && (getsockname(tcpFd, (struct sockaddr*)&tcpAddr, &tcpAddrLen) == 0)) {
+        snprintf(port, sizeof(port), "tcp://127.0.0.1:%d", ntohs(tcpAddr.sin_port));
+        pass &= socketTestRun(port, tcpFd);
+    } else {
+        printf("tcp listener: FAIL\n");
+        pass = false;
+    }
+    if (tcpFd >= 0) {
+        close(tcpFd);
+    }
+
+    int unixFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un unixAddr = { 0 };
+    unixAddr.sun_family = AF_UNIX;
+    strcpy(unixAddr.sun_path, SOCKET_TEST_UNIX_PATH);
+    unlink(SOCKET_TEST_UNIX_PATH);
+    if ((unixFd >= 0)
+        && (bind(unixFd, (struct sockaddr*)&unixAddr, sizeof(unixAddr)) == 0)
+        && (listen(unixFd, 1) == 0)) {
+        snprintf(port, sizeof(port), "unix://%s", SOCKET_TEST_UNIX_PATH);
+        pass &= socketTestRun(port, unixFd);
+    } else {
+        printf("unix listener: FAIL\n");
+        pass = false;
+    }
+    if (unixFd >= 0) {
+        close(unixFd);
+    }
+    unlink(SOCKET_TEST_UNIX_PATH);
+
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass;
+}
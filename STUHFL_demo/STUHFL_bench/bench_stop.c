@@ -0,0 +1,239 @@
+/**
+  ******************************************************************************
+  * @file           bench_stop.c
+  * @brief          Runner stop latency benchmark
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+#include "stuhfl.h"
+#include "stuhfl_al.h"
+#include "stuhfl_dl.h"
+#include "stuhfl_pl.h"
+#include "stuhfl_err.h"
+#include "stuhfl_platform.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define STOP_BENCH_UNIX_PATH            "/tmp/stuhfl_bench_stop.sock"
+#define STOP_BENCH_RD_TIMEOUT_MS        100
+#define STOP_BENCH_ITERATIONS           50
+#define STOP_BENCH_LOAD_TIME_MS         100
+#define STOP_BENCH_TAGS_PER_ROUND       8
+#define STOP_BENCH_DATA_PERIOD_MS       1
+
+static volatile uint32_t stopBenchCycleCnt;
+
+static int stopStandInRcvFrame(int fd, uint8_t* header)
+{
+    static uint8_t payload[0x10000];
+    if (recv(fd, header, COMM_PAYLOAD_POS, MSG_WAITALL) != COMM_PAYLOAD_POS) {
+        return -1;
+    }
+    uint16_t len = COMM_GET_PAYLOAD_LENGTH(header);
+    if ((len != 0) && (recv(fd, payload, len, MSG_WAITALL) != len)) {
+        return -1;
+    }
+    return COMM_GET_CMD(header);
+}
+
+static void stopStandInReply(int fd, const uint8_t* header, uint16_t cmd, const uint8_t* payload, uint16_t len)
+{
+    uint8_t frame[COMM_PAYLOAD_POS + 256];
+    memcpy(frame, header, COMM_PAYLOAD_POS);
+    COMM_SET_PREAMBLE_MODE(frame, 0x0000);
+    COMM_SET_STATUS(frame, ERR_NONE);
+    COMM_SET_CMD(frame, cmd);
+    COMM_SET_PAYLOAD_LENGTH(frame, len);
+    memcpy(&frame[COMM_PAYLOAD_POS], payload, len);
+    send(fd, frame, COMM_PAYLOAD_POS + len, MSG_NOSIGNAL);
+}
+
+/* stands in for the reader: streams one tag per period between inventory start and stop and acknowledges everything else */
+static void* stopStandInFunc(void* ptr)
+{
+    int fd = accept(*(int*)ptr, NULL, NULL);
+    uint8_t header[COMM_PAYLOAD_POS];
+    uint8_t dataHeader[COMM_PAYLOAD_POS];
+    uint8_t data[128];
+    uint16_t dataLen = 0;
+    bool streaming = false;
+
+    if (fd < 0) {
+        return NULL;
+    }
+
+    data[dataLen++] = STUHFL_TAG_INVENTORY_STATISTICS;
+    data[dataLen++] = sizeof(STUHFL_T_Inventory_Statistics);
+    memset(&data[dataLen], 0, sizeof(STUHFL_T_Inventory_Statistics));
+    dataLen += sizeof(STUHFL_T_Inventory_Statistics);
+    data[dataLen++] = STUHFL_TAG_INVENTORY_TAG_INFO_HEADER;
+    data[dataLen++] = 12;
+    memset(&data[dataLen], 0x01, 12);
+    dataLen += 12;
+    data[dataLen++] = STUHFL_TAG_INVENTORY_TAG_EPC;
+    data[dataLen++] = 12;
+    memset(&data[dataLen], 0xE2, 12);
+    dataLen += 12;
+    data[dataLen++] = STUHFL_TAG_INVENTORY_TAG_FINISHED;
+    data[dataLen++] = 0;
+
+    for (;;) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        if (poll(&pfd, 1, STOP_BENCH_DATA_PERIOD_MS) > 0) {
+            int cmd = stopStandInRcvFrame(fd, header);
+            if (cmd < 0) {
+                break;
+            }
+            stopStandInReply(fd, header, (uint16_t)cmd, NULL, 0);
+            if (cmd == ((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_START)) {
+                memcpy(dataHeader, header, COMM_PAYLOAD_POS);
+                streaming = true;
+            } else if (cmd == ((STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_STOP)) {
+                streaming = false;
+            }
+        }
+        if (streaming) {
+            stopStandInReply(fd, dataHeader, (STUHFL_CG_AL << 8) | STUHFL_CC_INVENTORY_DATA, data, dataLen);
+        }
+    }
+    close(fd);
+    return NULL;
+}
+
+static STUHFL_T_RET_CODE stopBenchCycle(STUHFL_T_ACTION_CYCLE_DATA data)
+{
+    (void)data;
+    stopBenchCycleCnt++;
+    return ERR_NONE;
+}
+
+static STUHFL_T_RET_CODE stopBenchFinished(STUHFL_T_ACTION_CYCLE_DATA data)
+{
+    (void)data;
+    return ERR_NONE;
+}
+
+/**
+  * @brief          Runner stop benchmark.<br>
+  *                 Repeatedly starts the inventory runner against an AF_UNIX stand-in reader
+  *                 that streams inventory data and measures how long STUHFL_F_Stop takes
+  *                 until the runner has terminated
+  *
+  * @retval         true if every start/stop cycle succeeded and the runner saw data
+  */
+bool bench_RunnerStopLatency(void)
+{
+    static uint8_t sndData[SND_BUFFER_SIZE];
+    static uint8_t rcvData[RCV_BUFFER_SIZE];
+    static STUHFL_T_Inventory_Tag tagData[STOP_BENCH_TAGS_PER_ROUND];
+    uint32_t latency[STOP_BENCH_ITERATIONS];
+    uint32_t latencyCnt = 0;
+    uint32_t failedCnt = 0;
+    uint32_t idleCnt = 0;
+    STUHFL_T_DEVICE_CTX device = 0;
+    STUHFL_T_READER_CTX ctx = NULL;
+    pthread_t thread;
+
+    printf("\n--- Runner stop latency ---\n");
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = { 0 };
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, STOP_BENCH_UNIX_PATH);
+    unlink(STOP_BENCH_UNIX_PATH);
+    if ((listenFd < 0)
+        || (bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) != 0)
+        || (listen(listenFd, 1) != 0)
+        || (STUHFL_F_CreateReaderCtx(&ctx) != ERR_NONE)) {
+        printf("setup       : FAIL\n");
+        if (listenFd >= 0) {
+            close(listenFd);
+        }
+        return false;
+    }
+    STUHFL_F_SelectReaderCtx(ctx);
+    pthread_create(&thread, NULL, stopStandInFunc, &listenFd);
+
+    uint32_t rdTimeout = STOP_BENCH_RD_TIMEOUT_MS;
+    STUHFL_T_RET_CODE ret = STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_PORT, (STUHFL_T_PARAM_VALUE)"unix://" STOP_BENCH_UNIX_PATH);
+    ret |= STUHFL_F_Connect(&device, sndData, SND_BUFFER_SIZE, rcvData, RCV_BUFFER_SIZE);
+    ret |= STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RD_TIMEOUT_MS, (STUHFL_T_PARAM_VALUE)&rdTimeout);
+
+    for (uint32_t i = 0; (ret == ERR_NONE) && (i < STOP_BENCH_ITERATIONS); i++) {
+        STUHFL_T_Inventory_Option invOption = STUHFL_O_INVENTORY_OPTION_INIT();
+        STUHFL_T_Inventory_Data invData = STUHFL_O_INVENTORY_DATA_INIT();
+        invData.tagList = tagData;
+        invData.tagListSizeMax = STOP_BENCH_TAGS_PER_ROUND;
+
+        STUHFL_T_ACTION_ID id = 0;
+        stopBenchCycleCnt = 0;
+        if (STUHFL_F_Start(STUHFL_ACTION_INVENTORY, &invOption, stopBenchCycle, &invData, stopBenchFinished, &id) != ERR_NONE) {
+            failedCnt++;
+            continue;
+        }
+        usleep(STOP_BENCH_LOAD_TIME_MS * 1000);
+
+        // STUHFL_F_Stop returns once the runner has terminated
+        uint64_t startTime = benchMicroCount(CLOCK_MONOTONIC);
+        STUHFL_T_RET_CODE stopRet = STUHFL_F_Stop(id);
+        uint32_t stopTime = (uint32_t)(benchMicroCount(CLOCK_MONOTONIC) - startTime);
+        if (stopRet != ERR_NONE) {
+            failedCnt++;
+            continue;
+        }
+        if (stopBenchCycleCnt == 0) {
+            idleCnt++;
+        }
+        latency[latencyCnt++] = stopTime;
+    }
+
+    STUHFL_F_Disconnect();
+    shutdown(listenFd, SHUT_RDWR);
+    pthread_join(thread, NULL);
+    close(listenFd);
+    unlink(STOP_BENCH_UNIX_PATH);
+    STUHFL_F_SelectReaderCtx(NULL);
+    // Stop may not keep the context referenced
+    STUHFL_T_RET_CODE destroyRet = STUHFL_F_DestroyReaderCtx(ctx);
+
+    printf("connect     : %s (%d)\n", (ret == ERR_NONE) ? "pass" : "FAIL", ret);
+    printf("iterations  : %u\n", latencyCnt + failedCnt);
+    printf("failed      : %u\n", failedCnt);
+    printf("no data     : %u\n", idleCnt);
+    printf("destroy ctx : %s (%d)\n", (destroyRet == ERR_NONE) ? "pass" : "FAIL", destroyRet);
+    if (latencyCnt) {
+        qsort(latency, latencyCnt, sizeof(uint32_t), benchCompareU32);
+        printf("min         : %u us\n", latency[0]);
+        printf("p50         : %u us\n", latency[latencyCnt / 2]);
+        printf("p99         : %u us\n", latency[(latencyCnt * 99) / 100]);
+        printf("max         : %u us\n", latency[latencyCnt - 1]);
+    }
+    bool pass = (ret == ERR_NONE) && (latencyCnt == STOP_BENCH_ITERATIONS) && (idleCnt == 0) && (destroyRet == ERR_NONE);
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass;
+}
@@ -0,0 +1,104 @@
+/**
+  ******************************************************************************
+  * @file           bench_tlv.c
+  * @brief          TLV decode benchmark
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2020 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+#include "stuhfl.h"
+#include "stuhfl_al.h"
+#include "stuhfl_dl.h"
+#include "stuhfl_helpers.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+#define TLV_BENCH_ITERATIONS            10000
+#define TLV_BENCH_EPC_LEN               12
+#define TLV_BENCH_TID_LEN               12
+
+static uint16_t tlvBenchPut(uint8_t* frame, uint16_t pos, uint8_t tag, uint8_t len)
+{
+    frame[pos++] = tag;
+    frame[pos++] = len;
+    memset(&frame[pos], tag, len);
+    return (uint16_t)(pos + len);
+}
+
+/* inventory data frame as sent by the firmware: statistics followed by as many tags as fit into the FW SND buffer */
+static uint16_t tlvBenchBuildFrame(uint8_t* frame, uint32_t* tagCnt)
+{
+    const uint16_t tagLen = 5 * 2 + offsetof(STUHFL_T_Inventory_Tag_View, xpc) + MAX_XPC_LENGTH + TLV_BENCH_EPC_LEN + TLV_BENCH_TID_LEN;
+    uint16_t pos = tlvBenchPut(frame, 0, STUHFL_TAG_INVENTORY_STATISTICS, sizeof(STUHFL_T_Inventory_Statistics));
+
+    *tagCnt = 0;
+    while (pos + tagLen <= UART_TX_BUFFER_SIZE) {
+        pos = tlvBenchPut(frame, pos, STUHFL_TAG_INVENTORY_TAG_INFO_HEADER, offsetof(STUHFL_T_Inventory_Tag_View, xpc));
+        pos = tlvBenchPut(frame, pos, STUHFL_TAG_INVENTORY_TAG_XPC, MAX_XPC_LENGTH);
+        pos = tlvBenchPut(frame, pos, STUHFL_TAG_INVENTORY_TAG_EPC, TLV_BENCH_EPC_LEN);
+        pos = tlvBenchPut(frame, pos, STUHFL_TAG_INVENTORY_TAG_TID, TLV_BENCH_TID_LEN);
+        pos = tlvBenchPut(frame, pos, STUHFL_TAG_INVENTORY_TAG_FINISHED, 0);
+        (*tagCnt)++;
+    }
+    return pos;
+}
+
+/**
+  * @brief          TLV decode benchmark.<br>
+  *                 Walks a synthetic inventory frame of UART_TX_BUFFER_SIZE bytes with
+  *                 tlvIterNext and reports the time per frame and per TLV.
+  *
+  * @retval         true if the frame was walked without overrun
+  */
+bool bench_TlvDecode(void)
+{
+    static uint8_t frame[UART_TX_BUFFER_SIZE];
+    volatile uint32_t sink = 0;
+    uint32_t tagCnt;
+    uint32_t tlvCnt = 0;
+    bool overrun = false;
+
+    uint16_t frameLen = tlvBenchBuildFrame(frame, &tagCnt);
+
+    uint64_t start = benchMicroCount(CLOCK_MONOTONIC);
+    for (uint32_t i = 0; i < TLV_BENCH_ITERATIONS; i++) {
+        STUHFL_T_TlvIter it;
+        STUHFL_T_Tlv tlv;
+        uint32_t sum = 0;
+        tlvIterInit(&it, frame, frameLen);
+        while (tlvIterNext(&it, &tlv)) {
+            sum += tlv.tag + tlv.len;
+            tlvCnt++;
+        }
+        overrun |= it.overrun;
+        sink += sum;
+    }
+    uint64_t time = benchMicroCount(CLOCK_MONOTONIC) - start;
+
+    printf("\n--- TLV decode: %d byte inventory frame, %u tags ---\n", frameLen, tagCnt);
+    printf("iterations  : %d%s\n", TLV_BENCH_ITERATIONS, overrun ? " (overrun)" : "");
+    printf("per frame   : %u.%02u us\n", (uint32_t)(time / TLV_BENCH_ITERATIONS), (uint32_t)(((time * 100) / TLV_BENCH_ITERATIONS) % 100));
+    printf("per TLV     : %u ns\n", tlvCnt ? (uint32_t)((time * 1000) / tlvCnt) : 0);
+    printf("\n");
+    (void)sink;
+    return !overrun;
+}
@@ -97,27 +97,19 @@ static bool useNewTuningMechanism = false;
   */
 void setupGen2Config(bool singleTag, bool freqHopping, int antenna)
 {
-    STUHFL_T_ST25RU3993_TxRx_Cfg TxRxCfg = STUHFL_O_ST25RU3993_TXRX_CFG_INIT();          // Set to FW default values
-    TxRxCfg.usedAntenna = (uint8_t)antenna;
-    SetTxRxCfg(&TxRxCfg);
-
-    STUHFL_T_ST25RU3993_Gen2Inventory_Cfg invGen2Cfg = STUHFL_O_ST25RU3993_GEN2INVENTORY_CFG_INIT();     // Set to FW default values
-    invGen2Cfg.fastInv = true;
-    invGen2Cfg.autoAck = false;
-    invGen2Cfg.startQ = singleTag ? 0 : 4;
-    invGen2Cfg.adaptiveQEnable = !singleTag;
-    invGen2Cfg.adaptiveSensitivityEnable = true;
-    invGen2Cfg.toggleTarget = true;
-    invGen2Cfg.targetDepletionMode = true;
-    SetGen2InventoryCfg(&invGen2Cfg);
-
-    //
-    STUHFL_T_ST25RU3993_Gen2Protocol_Cfg gen2ProtocolCfg = STUHFL_O_ST25RU3993_GEN2PROTOCOL_CFG_INIT();  // Set to FW default values
-    SetGen2ProtocolCfg(&gen2ProtocolCfg);
-
-    STUHFL_T_ST25RU3993_Freq_LBT freqLBT = STUHFL_O_ST25RU3993_FREQ_LBT_INIT();                          // Set to FW default values
-    freqLBT.listeningTime = 0;
-    SetFreqLBT(&freqLBT);
+    // TxRx, inventory, protocol and LBT configuration are applied in one frame
+    STUHFL_T_Reader_Profile profile = STUHFL_O_READER_PROFILE_INIT();                                    // Set to FW default values
+    profile.use = STUHFL_D_PROFILE_TXRX_CFG | STUHFL_D_PROFILE_GEN2INVENTORY_CFG | STUHFL_D_PROFILE_GEN2PROTOCOL_CFG | STUHFL_D_PROFILE_FREQ_LBT;
+    profile.txRxCfg.usedAntenna = (uint8_t)antenna;
+    profile.gen2InventoryCfg.fastInv = true;
+    profile.gen2InventoryCfg.autoAck = false;
+    profile.gen2InventoryCfg.startQ = singleTag ? 0 : 4;
+    profile.gen2InventoryCfg.adaptiveQEnable = !singleTag;
+    profile.gen2InventoryCfg.adaptiveSensitivityEnable = true;
+    profile.gen2InventoryCfg.toggleTarget = true;
+    profile.gen2InventoryCfg.targetDepletionMode = true;
+    profile.freqLBT.listeningTime = 0;
+    ApplyProfile(&profile, NULL);
 
     STUHFL_T_ST25RU3993_Freq_Profile freqProfile = STUHFL_O_ST25RU3993_FREQ_PROFILE_INIT();          // Set to FW default values
 
@@ -305,8 +297,10 @@ int main (int argc, char * argv[])
     on = FALSE;
     ret |= STUHFL_F_SetParam(STUHFL_PARAM_TYPE_CONNECTION | STUHFL_PARAM_KEY_RTS, (STUHFL_T_PARAM_VALUE)&on);
 
-    // give board time to boot
-    usleep(600000);     // (600 msec is on the safe side)
+    // wait until board has booted, returns as soon as the firmware answers
+    uint32_t bootTime = 0;
+    ret |= WaitForBoard(STUHFL_D_BOOT_TIMEOUT_MS, &bootTime);
+    printf("Board ready after %u ms\n", bootTime);
 
      /* COMUNICACIÓN SOCKET CON EL SOFTWARE MYRUNS */
     server = configure_tcp_socket(5557);
@@ -536,9 +530,8 @@ int main (int argc, char * argv[])
        
             printf("msg: %s\n", msg);
 
-            char mensaje[50];
-            char epcbin[4];
-            char epc[24];
+            char mensaje[2 * MAX_EPC_LENGTH + 3];
+            char epc[2 * MAX_EPC_LENGTH + 1];
 
             memset(epc, 0, sizeof(epc));
             memset(mensaje, 0, sizeof(mensaje));
@@ -561,10 +554,13 @@ int main (int argc, char * argv[])
                 printf("TagListSize: %d\n",invData.tagListSize);
                 for (int tagIdx = 0; tagIdx < invData.tagListSize; tagIdx++) {
                   //printf("tagIdx: %d len: %d\n", tagIdx, invData.tagList[tagIdx].epc.len);              
-                    for (int i = 0; i < invData.tagList[tagIdx].epc.len; i++) {
-                        sprintf(epcbin, "%02x", invData.tagList[tagIdx].epc.data[i]);
-                        //printf(epcbin);
-                        strcat(epc, epcbin);
+                    STUHFL_T_Epc_Key epcKey = STUHFL_O_EPC_KEY_INIT();
+                    STUHFL_F_EpcKeyFromBytes(&epcKey, invData.tagList[tagIdx].epc.data, invData.tagList[tagIdx].epc.len);
+                    if (STUHFL_F_EpcKeyToHex(&epcKey, epc, sizeof(epc)) != ERR_NONE) {
+                        // EPCs longer than the key are held hashed only, these are printed byte by byte
+                        for (int i = 0; i < invData.tagList[tagIdx].epc.len; i++) {
+                            sprintf(&epc[2 * i], "%02x", invData.tagList[tagIdx].epc.data[i]);
+                        }
                     }
                     //printf("epc: %s\n",epc);
                     sprintf(mensaje, "$%s#", epc);
@@ -615,13 +611,6 @@ int main (int argc, char * argv[])
 
 void printTagList(STUHFL_T_Inventory_Option* invOption, STUHFL_T_Inventory_Data* invData)
 {
-    char mensaje[50];
-    char epcbin[24];
-    char epc[24];
-
-    memset(epc, 0, sizeof(epc));
-    memset(epcbin, 0, sizeof(epcbin));
-    memset(mensaje, 0, sizeof(mensaje));
     //
     log2Screen(false, false, "\n\n--- Gen2_Inventory Option ---\n");
     log2Screen(false, false, "rssiMode    : %d\n", invOption->rssiMode);
@@ -661,20 +650,12 @@ void printTagList(STUHFL_T_Inventory_Option* invOption, STUHFL_T_Inventory_Data*
             printf("tagIdx: %d i: %d\n", tagIdx, i);
             log2Screen(false, false, "%02x ", invData->tagList[tagIdx].epc.data[i]);
             printf("%02x ", invData->tagList[tagIdx].epc.data[i]);
-            sprintf(epcbin, "%02x", invData->tagList[tagIdx].epc.data[i]);
-            //printf(epcbin);
-            strcat(epc, epcbin);
-            /*printf(epc);*/
         }
-        //printf(epc);
         log2Screen(false, false, "\ntidLen      : %d\n", invData->tagList[tagIdx].tid.len);
         log2Screen(false, false, "tid         : ");
         for (int i = 0; i < invData->tagList[tagIdx].tid.len; i++) {
             log2Screen(false, false, "%02x ", invData->tagList[tagIdx].tid.data[i]);
         }
-        sprintf(mensaje, "$%s#", epc);
-        memset(epc, 0, sizeof(epc));
-        //send(clientRead, mensaje, strlen(mensaje), 0);
     }
     log2Screen(false, true, "\n");
 }